@@ -43,6 +43,16 @@ public:
         NFSv4BreakdownAnalyzer::flush_statistics();
         NFSv41BreakdownAnalyzer::flush_statistics();
     }
+
+    void merge(IAnalyzer& other) override final
+    {
+        const Analyzer& analyzer = dynamic_cast<const Analyzer&>(other);
+        CIFSBreakdownAnalyzer::merge_statistics(analyzer);
+        CIFSv2BreakdownAnalyzer::merge_statistics(analyzer);
+        NFSv3BreakdownAnalyzer::merge_statistics(analyzer);
+        NFSv4BreakdownAnalyzer::merge_statistics(analyzer);
+        NFSv41BreakdownAnalyzer::merge_statistics(analyzer);
+    }
 };
 
 extern "C" {
@@ -61,7 +71,14 @@ void destroy(IAnalyzer* instance)
     delete instance;
 }
 
-NST_PLUGIN_ENTRY_POINTS(&usage, &create, &destroy, nullptr)
+const AnalyzerRequirements* requirements()
+{
+    // an instance per parser thread, statistics are merged
+    static const AnalyzerRequirements requirements{false, false, true};
+    return &requirements;
+}
+
+NST_PLUGIN_ENTRY_POINTS(&usage, &create, &destroy, &requirements)
 
 } //extern "C"
 //------------------------------------------------------------------------------
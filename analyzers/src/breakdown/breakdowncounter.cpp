@@ -47,6 +47,14 @@ uint64_t BreakdownCounter::get_total_count() const
     });
 }
 
+void BreakdownCounter::merge(const BreakdownCounter& other)
+{
+    for(std::size_t i = 0; i < latencies.size() && i < other.latencies.size(); ++i)
+    {
+        latencies[i].merge(other.latencies[i]);
+    }
+}
+
 const Latencies BreakdownCounter::operator[](int index) const
 {
     return latencies[index];
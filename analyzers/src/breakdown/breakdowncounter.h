@@ -55,6 +55,12 @@ public:
      */
     uint64_t get_total_count() const;
 
+    /*!
+     * \brief merge adds statistics collected by other counter
+     * \param other - counter of the same commands
+     */
+    void merge(const BreakdownCounter& other);
+
 private:
     void                                   operator=(const BreakdownCounter&) = delete;
     std::vector<NST::breakdown::Latencies> latencies;
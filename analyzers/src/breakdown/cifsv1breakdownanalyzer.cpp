@@ -411,4 +411,9 @@ void CIFSBreakdownAnalyzer::flush_statistics()
 {
     representer.flush_statistics(statistics);
 }
+
+void CIFSBreakdownAnalyzer::merge_statistics(const CIFSBreakdownAnalyzer& other)
+{
+    statistics.merge(other.statistics);
+}
 //------------------------------------------------------------------------------
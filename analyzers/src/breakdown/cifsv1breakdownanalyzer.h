@@ -119,6 +119,11 @@ public:
 
 protected:
     void flush_statistics() override;
+
+    /*! Adds statistics collected by other instance
+     * \param other - analyzer of other parser thread
+     */
+    void merge_statistics(const CIFSBreakdownAnalyzer& other);
 };
 
 } // namespace breakdown
@@ -131,4 +131,9 @@ void CIFSv2BreakdownAnalyzer::flush_statistics()
 {
     cifs2Representer.flush_statistics(stats);
 }
+
+void CIFSv2BreakdownAnalyzer::merge_statistics(const CIFSv2BreakdownAnalyzer& other)
+{
+    stats.merge(other.stats);
+}
 //------------------------------------------------------------------------------
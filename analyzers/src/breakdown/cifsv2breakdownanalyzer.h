@@ -62,6 +62,11 @@ public:
 
 protected:
     void flush_statistics() override;
+
+    /*! Adds statistics collected by other instance
+     * \param other - analyzer of other parser thread
+     */
+    void merge_statistics(const CIFSv2BreakdownAnalyzer& other);
 };
 
 } // namespace breakdown
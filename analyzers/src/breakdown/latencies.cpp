@@ -19,6 +19,7 @@
     along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
 */
 //------------------------------------------------------------------------------
+#include <algorithm>
 #include <cmath>
 
 #include "latencies.h"
@@ -27,17 +28,17 @@ using namespace NST::breakdown;
 //------------------------------------------------------------------------------
 
 Latencies::Latencies()
-    : count{0}
+    : min{0}
+    , max{0}
+    , count{0}
     , avg{0}
     , m2{0}
 {
-    timerclear(&min);
-    timerclear(&max);
 }
 
-void Latencies::add(const timeval& t)
+void Latencies::add(int64_t t)
 {
-    long double x     = to_sec(t);
+    long double x     = t;
     long double delta = x - avg;
     avg += delta / (++count);
     m2 += delta * (x - avg);
@@ -45,6 +46,24 @@ void Latencies::add(const timeval& t)
     set_range(t);
 }
 
+void Latencies::merge(const Latencies& other)
+{
+    if(other.count == 0)
+    {
+        return;
+    }
+
+    // combine averages and sums of squared differences of two sets
+    const long double n     = count + other.count;
+    const long double delta = other.avg - avg;
+    avg += delta * other.count / n;
+    m2 += other.m2 + delta * delta * count * other.count / n;
+
+    min = (count == 0) ? other.min : std::min(min, other.min);
+    max = (count == 0) ? other.max : std::max(max, other.max);
+    count += other.count;
+}
+
 uint64_t Latencies::get_count() const
 {
     return count;
@@ -52,7 +71,7 @@ uint64_t Latencies::get_count() const
 
 long double Latencies::get_avg() const
 {
-    return avg;
+    return avg / 1000000000;
 }
 
 long double Latencies::get_st_dev() const
@@ -61,37 +80,33 @@ long double Latencies::get_st_dev() const
     {
         return 0;
     }
-    return sqrt(m2 / (count - 1));
+    return sqrt(m2 / (count - 1)) / 1000000000;
 }
 
-const timeval& Latencies::get_min() const
+int64_t Latencies::get_min() const
 {
     return min;
 }
 
-const timeval& Latencies::get_max() const
+int64_t Latencies::get_max() const
 {
     return max;
 }
 
-void Latencies::set_range(const timeval& t)
+void Latencies::set_range(int64_t t)
 {
-    if(timercmp(&t, &min, <))
-    {
-        min = t;
-    }
-    if(min.tv_sec == 0 && min.tv_usec == 0)
+    if(t < min || count == 1) // the first latency
     {
         min = t;
     }
-    if(timercmp(&t, &max, >))
+    if(t > max || count == 1)
     {
         max = t;
     }
 }
 
-double NST::breakdown::to_sec(const timeval& val)
+double NST::breakdown::to_sec(int64_t val)
 {
-    return static_cast<double>(val.tv_sec) + static_cast<double>(val.tv_usec) / 1000000.0;
+    return static_cast<double>(val / 1000000000) + static_cast<double>(val % 1000000000) / 1000000000.0;
 }
 //------------------------------------------------------------------------------
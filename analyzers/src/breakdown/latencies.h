@@ -23,8 +23,6 @@
 #define LATENCIES_H
 //------------------------------------------------------------------------------
 #include <cstdint>
-
-#include <sys/time.h>
 //------------------------------------------------------------------------------
 namespace NST
 {
@@ -39,9 +37,14 @@ public:
     Latencies();
 
     /*! Adds value of latency
-     * \param t - timeout
+     * \param t - timeout in nanoseconds
+     */
+    void add(int64_t t);
+
+    /*! Adds latencies collected by other instance
+     * \param other - latencies to add
      */
-    void add(const timeval& t);
+    void merge(const Latencies& other);
 
     /*!
      * \brief gets count of timeouts
@@ -51,47 +54,47 @@ public:
 
     /*!
      * \brief get_avg Gets average latency
-     * \return average timeout
+     * \return average timeout in seconds
      */
     long double get_avg() const;
 
     /*!
      * \brief get_st_dev Gets latency dispertion
-     * \return timeout dispertion
+     * \return timeout dispertion in seconds
      */
     long double get_st_dev() const;
 
     /*!
      * \brief get_min Gets minimal value of latencies
-     * \return minimal latency
+     * \return minimal latency in nanoseconds
      */
-    const timeval& get_min() const;
+    int64_t get_min() const;
 
     /*!
      * \brief get_min Gets maximal value of latencies
-     * \return maximal latency
+     * \return maximal latency in nanoseconds
      */
-    const timeval& get_max() const;
+    int64_t get_max() const;
 
 private:
     void operator=(const Latencies&) = delete;
 
-    void set_range(const timeval& t);
+    void set_range(int64_t t);
 
-    timeval min;
-    timeval max;
+    int64_t min;
+    int64_t max;
 
     uint64_t    count;
-    long double avg;
+    long double avg; // in nanoseconds
     long double m2;
 };
 
 /*!
- * \brief to_sec Converts timeval to double
- * \param val - time struct
+ * \brief to_sec Converts nanoseconds to seconds
+ * \param val - nanoseconds
  * \return converted value
  */
-double to_sec(const timeval& val);
+double to_sec(int64_t val);
 
 } // namespace breakdown
 } // namespace NST
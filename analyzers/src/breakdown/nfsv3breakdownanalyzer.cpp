@@ -145,3 +145,8 @@ void NFSv3BreakdownAnalyzer::flush_statistics()
 {
     representer.flush_statistics(stats);
 }
+
+void NFSv3BreakdownAnalyzer::merge_statistics(const NFSv3BreakdownAnalyzer& other)
+{
+    stats.merge(other.stats);
+}
@@ -109,6 +109,11 @@ public:
                  const struct NFS3::COMMIT3res*) override final;
 
     void flush_statistics() override;
+
+    /*! Adds statistics collected by other instance
+     * \param other - analyzer of other parser thread
+     */
+    void merge_statistics(const NFSv3BreakdownAnalyzer& other);
 };
 
 } // namespace breakdown
@@ -501,3 +501,9 @@ void NFSv41BreakdownAnalyzer::flush_statistics()
     StatisticsCompositor stat(compound_stats, stats);
     representer.flush_statistics(stat);
 }
+
+void NFSv41BreakdownAnalyzer::merge_statistics(const NFSv41BreakdownAnalyzer& other)
+{
+    compound_stats.merge(other.compound_stats);
+    stats.merge(other.stats);
+}
@@ -212,6 +212,11 @@ public:
                    const struct NFS41::ILLEGAL4res* res) override final;
 
     void flush_statistics() override;
+
+    /*! Adds statistics collected by other instance
+     * \param other - analyzer of other parser thread
+     */
+    void merge_statistics(const NFSv41BreakdownAnalyzer& other);
 };
 
 } // namespace protocols
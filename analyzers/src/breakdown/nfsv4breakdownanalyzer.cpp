@@ -364,3 +364,9 @@ void NFSv4BreakdownAnalyzer::flush_statistics()
     StatisticsCompositor stat(compound_stats, stats);
     representer.flush_statistics(stat);
 }
+
+void NFSv4BreakdownAnalyzer::merge_statistics(const NFSv4BreakdownAnalyzer& other)
+{
+    compound_stats.merge(other.compound_stats);
+    stats.merge(other.stats);
+}
@@ -166,6 +166,11 @@ public:
     void illegal40(const RPCProcedure*             proc,
                    const struct NFS4::ILLEGAL4res* res) override final;
     void flush_statistics() override;
+
+    /*! Adds statistics collected by other instance
+     * \param other - analyzer of other parser thread
+     */
+    void merge_statistics(const NFSv4BreakdownAnalyzer& other);
 };
 
 } // namespace breakdown
@@ -75,7 +75,22 @@ bool Statistics::has_session() const
     return !per_session_statistics.empty();
 }
 
-void Statistics::account(const int cmd_index, const Session& session, const timeval latency)
+void Statistics::merge(const Statistics& other)
+{
+    counter.merge(other.counter);
+
+    for(const auto& it : other.per_session_statistics)
+    {
+        auto i = per_session_statistics.find(it.first);
+        if(i == per_session_statistics.end())
+        {
+            i = per_session_statistics.emplace(it.first, BreakdownCounter{proc_types_count}).first;
+        }
+        i->second.merge(it.second);
+    }
+}
+
+void Statistics::account(const int cmd_index, const Session& session, const int64_t latency)
 {
     counter[cmd_index].add(latency);
 
@@ -79,6 +79,12 @@ struct Statistics
      */
     virtual bool has_session() const;
 
+    /**
+     * @brief adds statistics collected by other instance
+     * @param other - statistics of the same procedures
+     */
+    void merge(const Statistics& other);
+
     /**
      * Saves statistics on commands receive
      * @param proc - command
@@ -88,18 +94,17 @@ struct Statistics
     template <typename Cmd, typename Code>
     void account(const Cmd* proc, Code cmd_code)
     {
-        timeval        latency{0, 0};
         const int      cmd_index = static_cast<int>(cmd_code);
         const Session& session   = *proc->session;
 
-        // diff between 'reply' and 'call' timestamps
-        timersub(proc->rtimestamp, proc->ctimestamp, &latency);
+        // diff between 'reply' and 'call' timestamps in nanoseconds
+        const int64_t latency = proc->reply_nanoseconds() - proc->call_nanoseconds();
 
         account(cmd_index, session, latency);
     }
 
 protected:
-    void account(const int cmd_index, const Session& session, const timeval latency);
+    void account(const int cmd_index, const Session& session, const int64_t latency);
 
     BreakdownCounter     counter;                //!< Statistics for all sessions
     PerSessionStatistics per_session_statistics; //!< Statistics for each session
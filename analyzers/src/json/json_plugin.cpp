@@ -116,7 +116,14 @@ void destroy(IAnalyzer* instance)
     delete instance;
 }
 
-NST_PLUGIN_ENTRY_POINTS(&usage, &create, &destroy, nullptr)
+const AnalyzerRequirements* requirements()
+{
+    // callbacks only increment atomic counters
+    static const AnalyzerRequirements requirements{false, true};
+    return &requirements;
+}
+
+NST_PLUGIN_ENTRY_POINTS(&usage, &create, &destroy, &requirements)
 
 } //extern "C"
 
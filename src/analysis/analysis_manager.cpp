@@ -19,7 +19,10 @@
     along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
 */
 //------------------------------------------------------------------------------
+#include <algorithm>
+
 #include "analysis/analysis_manager.h"
+#include "utils/out.h"
 //------------------------------------------------------------------------------
 namespace NST
 {
@@ -28,25 +31,132 @@ namespace analysis
 AnalysisManager::AnalysisManager(RunningStatus& status, const Parameters& params)
     : analysiss{nullptr}
     , queue{nullptr}
+    , ordered{nullptr}
     , parser_thread{nullptr}
+    , shards{nullptr}
+    , dispatcher{nullptr}
+    , cpus{params.parser_cpus()}
 {
-    analysiss.reset(new Analyzers(params));
-
-    queue.reset(new FilteredDataQueue(params.queue_capacity(), 1));
+    // effective set, so plugins of parser threads aren't placed on CPUs of parsers
+    const utils::CPUSet plugin_cpus{params.plugin_cpus().effective()};
+    {
+        // threads created by plugins inherit the placement
+        utils::CPUPlacement placement{plugin_cpus};
+        analysiss.reset(new Analyzers(params));
+    }
 
     Parsers parser(*analysiss);
-    parser_thread.reset(new ParserThread<Parsers>(parser, *queue, status));
+
+    // the queue is allocated on nodes of parser threads which consume it
+    utils::CPUPlacement placement{cpus};
+
+    const unsigned jobs{params.jobs()};
+    if(jobs > 1) // queue per filtration thread
+    {
+        ordered.reset(new OrderedQueues(jobs, params.queue_capacity(), params.queue_element()));
+    }
+    else
+    {
+        queue.reset(new FilteredDataQueue(params.queue_capacity(), 1, params.queue_element(), params.queue_policy()));
+    }
+
+    const unsigned threads{params.parser_threads()};
+    if(threads > 1) // parsing is dispatched to threads by sessions
+    {
+        shards.reset(new Shards(status, params.parser_spin(), params.queue_capacity()));
+        shards->add(parser);
+        for(unsigned i = 1; i < threads; ++i)
+        {
+            utils::CPUPlacement plugins{plugin_cpus};
+            lanes.emplace_back(analysiss->for_parser_thread());
+            Parsers lane_parser(*lanes.back());
+            shards->add(lane_parser);
+        }
+
+        const Shards::Dispatcher d{shards->dispatcher()};
+        dispatcher.reset(ordered ? new ParserThread<Shards::Dispatcher>(d, *ordered, status, params.parser_spin())
+                                 : new ParserThread<Shards::Dispatcher>(d, *queue, status, params.parser_spin()));
+    }
+    else
+    {
+        parser_thread.reset(ordered ? new ParserThread<Parsers>(parser, *ordered, status, params.parser_spin())
+                                    : new ParserThread<Parsers>(parser, *queue, status, params.parser_spin()));
+    }
+
+    if(utils::Out message{}) // print memory footprint of queued messages
+    {
+        const FilteredDataQueue& q{queue ? *queue : ordered->input(0).get_queue()};
+        message << "Queue element: " << q.element_size() << " bytes, "
+                << params.queue_element() << " bytes of message are kept in place";
+        if(shards)
+        {
+            message << ", parsed by " << shards->size() << " threads";
+        }
+    }
+
+    if(utils::Out message{}) // print placement of threads
+    {
+        const utils::CPUSet parsers{cpus.effective()};
+        message << "Parser threads are placed on CPUs: " << parsers
+                << " (NUMA nodes: " << parsers.nodes() << "), plugin threads on CPUs: " << plugin_cpus
+                << " (NUMA nodes: " << plugin_cpus.nodes() << ')';
+    }
 }
 
 void AnalysisManager::start()
 {
-    parser_thread->start();
+    utils::CPUPlacement placement{cpus}; // threads inherit it
+    if(shards)
+    {
+        shards->start();
+        dispatcher->start();
+    }
+    else
+    {
+        parser_thread->start();
+    }
 }
 
 void AnalysisManager::stop()
 {
-    parser_thread->stop();
+    if(shards)
+    {
+        dispatcher->stop();
+        shards->stop();
+        for(auto& lane : lanes)
+        {
+            analysiss->merge(*lane);
+        }
+    }
+    else
+    {
+        parser_thread->stop();
+    }
     analysiss->flush_statistics();
+
+    if(utils::Out message{}) // print usage of queues
+    {
+        std::size_t high{0};
+        uint64_t    dropped{0};
+        const auto  count = [&](const FilteredDataQueue& q) {
+            high = std::max(high, q.high_water());
+            dropped += q.dropped();
+        };
+        if(queue)
+        {
+            count(*queue);
+        }
+        else
+        {
+            for(unsigned i = 0; i < ordered->size(); ++i)
+            {
+                count(ordered->input(i).get_queue());
+            }
+        }
+        const FilteredDataQueue& q{queue ? *queue : ordered->input(0).get_queue()};
+        message << "Queue high-water mark: " << high << " of " << q.capacity()
+                << " messages, dropped messages: " << dropped;
+    }
 }
 
 } // namespace analysis
@@ -23,14 +23,18 @@
 #define ANALYSIS_MANAGER_H
 //------------------------------------------------------------------------------
 #include <memory>
+#include <vector>
 
 #include "analysis/analyzers.h"
+#include "analysis/parser_shards.h"
 #include "analysis/parser_thread.h"
 #include "analysis/parsers.h"
 #include "controller/parameters.h"
 #include "controller/running_status.h"
+#include "utils/cpu_set.h"
 #include "utils/filtered_data.h"
 #include "utils/noncopyable.h"
+#include "utils/ordered_queues.h"
 //------------------------------------------------------------------------------
 namespace NST
 {
@@ -41,12 +45,15 @@ class AnalysisManager final : utils::noncopyable
     using Parameters        = NST::controller::Parameters;
     using RunningStatus     = NST::controller::RunningStatus;
     using FilteredDataQueue = NST::utils::FilteredDataQueue;
+    using OrderedQueues     = NST::utils::OrderedQueues;
+    using Shards            = ParserShards<Parsers>;
 
 public:
     AnalysisManager(RunningStatus& status, const Parameters& params);
     ~AnalysisManager() = default;
 
     FilteredDataQueue& get_queue() { return *queue; }
+    OrderedQueues*     get_ordered_queues() { return ordered.get(); } // nullptr if jobs == 1
     void               start();
     void               stop();
 
@@ -61,9 +68,14 @@ public:
     }
 
 private:
-    std::unique_ptr<Analyzers>             analysiss;
-    std::unique_ptr<FilteredDataQueue>     queue;
-    std::unique_ptr<ParserThread<Parsers>> parser_thread;
+    std::unique_ptr<Analyzers>                        analysiss;
+    std::vector<std::unique_ptr<Analyzers>>           lanes; // of other parser threads
+    std::unique_ptr<FilteredDataQueue>                queue;
+    std::unique_ptr<OrderedQueues>                    ordered;
+    std::unique_ptr<ParserThread<Parsers>>            parser_thread;
+    std::unique_ptr<Shards>                           shards; // if several parser threads
+    std::unique_ptr<ParserThread<Shards::Dispatcher>> dispatcher;
+    const utils::CPUSet                               cpus; // of parser threads
 };
 
 } // namespace analysis
@@ -19,6 +19,7 @@
     along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
 */
 //------------------------------------------------------------------------------
+#include <algorithm>
 #include <stdexcept>
 
 #include "analysis/analyzers.h"
@@ -31,6 +32,7 @@ namespace analysis
 {
 Analyzers::Analyzers(const controller::Parameters& params)
     : _silent{false}
+    , batch_size{params.analysis_batch()}
 {
     for(const auto& a : params.analysis_modules())
     {
@@ -55,7 +57,25 @@ Analyzers::Analyzers(const controller::Parameters& params)
                 }
             }
 
-            modules.emplace_back(plugin->instance());
+            IAnalyzer* instance{plugin->instance()};
+            modules.emplace_back(instance);
+            if(!plugin->batched())
+            {
+                legacy.emplace_back(instance);
+            }
+            if(plugin->concurrent())
+            {
+                concurrent.emplace_back(instance);
+            }
+            else if(plugin->mergeable())
+            {
+                mergeable.emplace_back(instance);
+                instances.emplace_back(a);
+            }
+            else
+            {
+                exclusive.emplace_back(instance);
+            }
             plugins.emplace_back(std::move(plugin));
         }
         catch(std::runtime_error& e)
@@ -68,8 +88,82 @@ Analyzers::Analyzers(const controller::Parameters& params)
     {
         std::unique_ptr<IAnalyzer> tracer{new PrintAnalyzer{std::cout}};
         modules.emplace_back(tracer.get());
+        exclusive.emplace_back(tracer.get());
         builtin.emplace_back(std::move(tracer));
     }
+    prepare_batches();
+}
+
+std::unique_ptr<Analyzers> Analyzers::for_parser_thread()
+{
+    if(!lock) // calls of exclusive modules are serialized from now
+    {
+        lock = std::make_shared<std::mutex>();
+        modules.erase(std::remove_if(modules.begin(), modules.end(), [&](IAnalyzer* a) {
+                          return std::find(exclusive.begin(), exclusive.end(), a) != exclusive.end();
+                      }),
+                      modules.end());
+        serialized = exclusive;
+        prepare_batches();
+    }
+
+    std::unique_ptr<Analyzers> other{new Analyzers{}};
+    other->_silent    = _silent;
+    other->lock       = lock;
+    other->serialized = serialized;
+    other->modules    = concurrent;
+    other->concurrent = concurrent;
+    other->legacy     = legacy;
+    other->batch_size = batch_size;
+    for(const auto& a : instances)
+    {
+        std::unique_ptr<PluginInstance> plugin{new PluginInstance{a.path, a.args}};
+        other->modules.emplace_back(plugin->instance());
+        other->mergeable.emplace_back(plugin->instance());
+        if(!plugin->batched())
+        {
+            other->legacy.emplace_back(plugin->instance());
+        }
+        other->plugins.emplace_back(std::move(plugin));
+        other->instances.emplace_back(a);
+    }
+    other->prepare_batches();
+    return other;
+}
+
+void Analyzers::prepare_batches()
+{
+    if(batch_size <= 1)
+    {
+        return;
+    }
+    if(!slots)
+    {
+        slots.reset(new Slot[batch_size]);
+        batch.reserve(batch_size);
+    }
+
+    const auto target = [&](IAnalyzer* a) {
+        return Target{a, std::find(legacy.begin(), legacy.end(), a) != legacy.end()};
+    };
+    targets.clear();
+    for(const auto a : modules)
+    {
+        targets.emplace_back(target(a));
+    }
+    locked_targets.clear();
+    for(const auto a : serialized)
+    {
+        locked_targets.emplace_back(target(a));
+    }
+}
+
+void Analyzers::merge(Analyzers& other)
+{
+    for(std::size_t i = 0; i < mergeable.size(); ++i)
+    {
+        mergeable[i]->merge(*other.mergeable[i]);
+    }
 }
 
 } // namespace analysis
@@ -22,13 +22,20 @@
 #ifndef ANALYZERS_H
 #define ANALYZERS_H
 //------------------------------------------------------------------------------
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
 #include <vector>
 
+#include "analysis/batched_procedure.h"
 #include "analysis/plugin.h"
 #include "api/plugin_api.h"
 #include "controller/parameters.h"
+#include "utils/filtered_data.h"
 #include "utils/noncopyable.h"
+#include "utils/sessions.h"
 //------------------------------------------------------------------------------
 namespace NST
 {
@@ -39,9 +46,75 @@ class Analyzers final : utils::noncopyable
     using Storage  = std::vector<IAnalyzer*>;
     using Plugins  = std::vector<std::unique_ptr<PluginInstance>>;
     using BuiltIns = std::vector<std::unique_ptr<IAnalyzer>>;
+    using Args     = std::vector<controller::AParams>;
+    using Batch    = std::vector<API::ProcedureCall*>;
+    using Slot     = std::aligned_storage<1024, alignof(std::max_align_t)>::type;
+
+    // module and whether procedures of batch are passed to it one by one
+    struct Target
+    {
+        IAnalyzer* analyzer;
+        bool       legacy;
+    };
+    using Targets = std::vector<Target>;
+
+    using FilteredDataQueue = NST::utils::FilteredDataQueue;
 
 public:
     Analyzers(const controller::Parameters& params);
+    ~Analyzers()
+    {
+        release_batch();
+    }
+
+    // Analyzers of another parser thread. Mergeable plugins are instantiated
+    // for it, concurrent ones are shared, calls of others are serialized.
+    std::unique_ptr<Analyzers> for_parser_thread();
+
+    // add statistics of mergeable plugins of another parser thread
+    void merge(Analyzers& other);
+
+    //! This function is used for passing NFS procedures to analyzers. The
+    //! procedure is decoded at once, but it is kept with its data and passed
+    //! in a batch of procedures if batches are enabled. Dispatch passes the
+    //! procedure to handlers as dispatch(handlers, proc).
+    template <
+        typename Procedure,
+        typename Dispatch>
+    inline void procedure(FilteredDataQueue::Ptr&& call,
+                          FilteredDataQueue::Ptr&& reply,
+                          const utils::Session*    session,
+                          Dispatch                 dispatch)
+    {
+        if(batch_size > 1)
+        {
+            // procedures of batch are kept in preallocated slots
+            using Call = BatchedProcedure<Procedure, Dispatch>;
+            static_assert(sizeof(Call) <= sizeof(Slot), "batched procedure doesn't fit in slot");
+
+            batch.emplace_back(new(&slots[batch.size()]) Call{std::move(call), std::move(reply), session, dispatch});
+            if(batch.size() >= batch_size)
+            {
+                pass_batch();
+            }
+            return;
+        }
+
+        protocols::xdr::XDRDecoder c{std::move(call)};
+        protocols::xdr::XDRDecoder r{std::move(reply)};
+        const Procedure            proc{c, r, session};
+        dispatch(*this, proc);
+    }
+
+    //! Pass collected procedures to analyzers, must be called before the
+    //! sessions of procedures are closed
+    inline void flush()
+    {
+        if(!batch.empty())
+        {
+            pass_batch();
+        }
+    }
 
     //! This function is used for passing ALL possible procedures to analyzers
     template <
@@ -49,10 +122,19 @@ public:
         typename Procedure>
     inline void operator()(Handle handle, const Procedure& proc)
     {
+        flush(); // keep order of procedures
         for(const auto a : modules)
         {
             (a->*handle)(&proc, proc.parg, proc.pres);
         }
+        if(!serialized.empty())
+        {
+            std::lock_guard<std::mutex> guard{*lock};
+            for(const auto a : serialized)
+            {
+                (a->*handle)(&proc, proc.parg, proc.pres);
+            }
+        }
     }
 
     //! This function is used for passing args- or res-only NFS4.x operations (ex. NFSv4 ILLEGAL) to analyzers
@@ -61,10 +143,19 @@ public:
         typename ArgOrResType>
     inline void operator()(Handle handle, const RPCProcedure* rpc, ArgOrResType* arg_or_res)
     {
+        flush();
         for(const auto a : modules)
         {
             (a->*handle)(rpc, arg_or_res);
         }
+        if(!serialized.empty())
+        {
+            std::lock_guard<std::mutex> guard{*lock};
+            for(const auto a : serialized)
+            {
+                (a->*handle)(rpc, arg_or_res);
+            }
+        }
     }
 
     //! This function is used for passing args + res NFS4.x operations (ex. NFSv4.x ACCESS) to analyzers
@@ -74,18 +165,32 @@ public:
         typename ResopType>
     inline void operator()(Handle handle, const RPCProcedure* rpc, ArgopType* arg, ResopType* res)
     {
+        flush();
         for(const auto a : modules)
         {
             (a->*handle)(rpc, arg, res);
         }
+        if(!serialized.empty())
+        {
+            std::lock_guard<std::mutex> guard{*lock};
+            for(const auto a : serialized)
+            {
+                (a->*handle)(rpc, arg, res);
+            }
+        }
     }
 
     inline void flush_statistics()
     {
+        flush();
         for(const auto a : modules)
         {
             a->flush_statistics();
         }
+        for(const auto a : serialized)
+        {
+            a->flush_statistics();
+        }
     }
 
     inline void on_unix_signal(int signo)
@@ -94,6 +199,10 @@ public:
         {
             a->on_unix_signal(signo);
         }
+        for(const auto a : serialized)
+        {
+            a->on_unix_signal(signo);
+        }
     }
     inline bool isSilent()
     {
@@ -101,10 +210,80 @@ public:
     }
 
 private:
-    Storage  modules; // pointers to all modules (plugins and builtins)
+    Analyzers()
+        : _silent{false}
+    {
+    }
+
+    void prepare_batches(); // of modules and serialized modules
+
+    inline void pass_batch()
+    {
+        const API::ProcedureCall* const* calls{batch.data()};
+        try
+        {
+            for(const auto& t : targets)
+            {
+                pass_batch(t, calls);
+            }
+            if(!locked_targets.empty())
+            {
+                std::lock_guard<std::mutex> guard{*lock};
+                for(const auto& t : locked_targets)
+                {
+                    pass_batch(t, calls);
+                }
+            }
+        }
+        catch(...)
+        {
+            release_batch();
+            throw;
+        }
+        release_batch();
+    }
+
+    inline void pass_batch(const Target& t, const API::ProcedureCall* const* calls)
+    {
+        // procedures() is missing in vtable of plugins built with older API
+        if(t.legacy)
+        {
+            for(std::size_t i = 0; i < batch.size(); ++i)
+            {
+                calls[i]->dispatch(*t.analyzer);
+            }
+            return;
+        }
+        t.analyzer->procedures(calls, batch.size());
+    }
+
+    inline void release_batch()
+    {
+        for(const auto c : batch)
+        {
+            c->~ProcedureCall(); // constructed in slot
+        }
+        batch.clear();
+    }
+
+    Storage  modules;    // pointers to modules called directly (plugins and builtins)
+    Storage  serialized; // modules shared by parser threads and called under lock
+    Storage  exclusive;  // modules which must be serialized if they are shared
+    Storage  concurrent; // modules which may be shared by parser threads as is
+    Storage  mergeable;  // modules instantiated for each parser thread
+    Storage  legacy;     // modules of plugins built without batches in API
+    Args     instances;  // path and args of mergeable modules
     Plugins  plugins;
     BuiltIns builtin;
     bool     _silent;
+
+    std::shared_ptr<std::mutex> lock; // for calls of serialized modules
+
+    std::size_t             batch_size{1};  // max number of procedures in a batch
+    std::unique_ptr<Slot[]> slots;          // of procedures of batch
+    Batch                   batch;          // collected procedures
+    Targets                 targets;        // modules receiving batches
+    Targets                 locked_targets; // serialized modules receiving batches
 };
 
 } // namespace analysis
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: NFS procedure decoded and kept until passing to analyzers.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef BATCHED_PROCEDURE_H
+#define BATCHED_PROCEDURE_H
+//------------------------------------------------------------------------------
+#include <utility>
+
+#include "api/plugin_api.h"
+#include "protocols/xdr/xdr_decoder.h"
+#include "utils/filtered_data.h"
+#include "utils/noncopyable.h"
+#include "utils/sessions.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace analysis
+{
+// Handlers of single analyzer, the same calls as Analyzers provide
+class AnalyzerHandlers final
+{
+public:
+    explicit AnalyzerHandlers(IAnalyzer& a)
+        : analyzer(a)
+    {
+    }
+
+    template <
+        typename Handle,
+        typename Procedure>
+    inline void operator()(Handle handle, const Procedure& proc)
+    {
+        (analyzer.*handle)(&proc, proc.parg, proc.pres);
+    }
+
+    template <
+        typename Handle,
+        typename ArgOrResType>
+    inline void operator()(Handle handle, const RPCProcedure* rpc, ArgOrResType* arg_or_res)
+    {
+        (analyzer.*handle)(rpc, arg_or_res);
+    }
+
+    template <
+        typename Handle,
+        typename ArgopType,
+        typename ResopType>
+    inline void operator()(Handle handle, const RPCProcedure* rpc, ArgopType* arg, ResopType* res)
+    {
+        (analyzer.*handle)(rpc, arg, res);
+    }
+
+private:
+    IAnalyzer& analyzer;
+};
+
+// Procedure decoded from call and reply which are kept with it. Dispatch
+// passes the procedure to handlers of analyzers as dispatch(handlers, proc).
+template <
+    typename Procedure,
+    typename Dispatch>
+class BatchedProcedure final : public API::ProcedureCall, utils::noncopyable
+{
+    using FilteredDataQueue = NST::utils::FilteredDataQueue;
+    using XDRDecoder        = NST::protocols::xdr::XDRDecoder;
+
+public:
+    // throws XDRDecoderError if data are not decoded
+    BatchedProcedure(FilteredDataQueue::Ptr&& c, FilteredDataQueue::Ptr&& r, const utils::Session* s, Dispatch d)
+        : call{std::move(c)}
+        , reply{std::move(r)}
+        , procedure{call, reply, s}
+        , handlers(d)
+    {
+    }
+
+    void dispatch(IAnalyzer& analyzer) const override
+    {
+        AnalyzerHandlers target{analyzer};
+        handlers(target, procedure);
+    }
+
+    const RPCProcedure* rpc() const override { return &procedure; }
+private:
+    XDRDecoder      call;
+    XDRDecoder      reply;
+    const Procedure procedure;
+    const Dispatch  handlers;
+};
+
+} // namespace analysis
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // BATCHED_PROCEDURE_H
+//------------------------------------------------------------------------------
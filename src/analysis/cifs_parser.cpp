@@ -33,6 +33,8 @@ CIFSParser::CIFSParser(Analyzers& a)
 
 bool CIFSParser::parse_data(FilteredDataQueue::Ptr& data)
 {
+    data->flatten(); // CIFS messages are read from contiguous memory
+
     if(const CIFSv1::MessageHeader* header = CIFSv1::get_header(data->data))
     {
         parse_packet(header, std::move(data));
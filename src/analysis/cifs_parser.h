@@ -91,6 +91,11 @@ public:
      * \return True, if it is CIFS packet and False in other case
      */
     bool parse_data(FilteredDataQueue::Ptr& data);
+
+    /*! Forgets session closed by filtration
+     * \param session - network session
+     */
+    inline void close_session(utils::NetworkSession* session) { sessions.close(session); }
 };
 
 } // analysis
@@ -31,6 +31,8 @@ namespace NST
 {
 namespace analysis
 {
+using FilteredDataQueue = NST::utils::FilteredDataQueue;
+
 bool NFSParser::parse_data(FilteredDataQueue::Ptr& ptr)
 {
     using namespace NST::protocols::rpc;
@@ -97,7 +99,7 @@ bool NFSParser::parse_data(FilteredDataQueue::Ptr& ptr)
 // They're supposed to be used inside analyze_nfs_procedure only
 // ----------------------------------------------------------------------------
 
-static uint32_t get_nfs4_compound_minor_version(const uint32_t procedure, const std::uint8_t* rpc_nfs4_call);
+static uint32_t get_nfs4_compound_minor_version(const uint32_t procedure, const FilteredData& rpc_nfs4_call);
 
 using NFS40CompoundType = NST::protocols::NFS4::NFSPROC4RPCGEN_COMPOUND;
 using NFS41CompoundType = NST::protocols::NFS41::NFSPROC41RPCGEN_COMPOUND;
@@ -105,135 +107,157 @@ using NFS41CompoundType = NST::protocols::NFS41::NFSPROC41RPCGEN_COMPOUND;
 template <
     typename ArgOpType,
     typename ResOpType,
-    typename NFS4CompoundType>
-void analyze_nfs4_operations(Analyzers& analyzers, NFS4CompoundType& nfs4_compound_procedure);
+    typename NFS4CompoundType,
+    typename Target>
+void analyze_nfs4_operations(Target& analyzers, const NFS4CompoundType& nfs4_compound_procedure);
 
-inline void analyze_nfs40_operations(Analyzers& analyzers, NFS40CompoundType& nfs40_compound_procedure)
+template <typename Target>
+inline void analyze_nfs40_operations(Target& analyzers, const NFS40CompoundType& nfs40_compound_procedure)
 {
     analyze_nfs4_operations<NST::API::NFS4::nfs_argop4,
                             NST::API::NFS4::nfs_resop4,
                             NFS40CompoundType>(analyzers, nfs40_compound_procedure);
 }
 
-inline void analyze_nfs41_operations(Analyzers& analyzers, NFS41CompoundType& nfs41_compound_procedure)
+template <typename Target>
+inline void analyze_nfs41_operations(Target& analyzers, const NFS41CompoundType& nfs41_compound_procedure)
 {
     analyze_nfs4_operations<NST::API::NFS41::nfs_argop4,
                             NST::API::NFS41::nfs_resop4,
                             NFS41CompoundType>(analyzers, nfs41_compound_procedure);
 }
 
-void nfs4_ops_switch(Analyzers&                        analyzers,
+template <typename Target>
+void nfs4_ops_switch(Target&                           analyzers,
                      const RPCProcedure*               rpc_procedure,
                      const NST::API::NFS4::nfs_argop4* arg,
                      const NST::API::NFS4::nfs_resop4* res);
 
-void nfs4_ops_switch(Analyzers&                         analyzers,
+template <typename Target>
+void nfs4_ops_switch(Target&                            analyzers,
                      const RPCProcedure*                rpc_procedure,
                      const NST::API::NFS41::nfs_argop4* arg,
                      const NST::API::NFS41::nfs_resop4* res);
 
+//! Pass the procedure to its handler of analyzers
+template <
+    typename Procedure,
+    typename Handle>
+inline void analyze_procedure(Analyzers&               analyzers,
+                              Handle                   handle,
+                              FilteredDataQueue::Ptr&& c,
+                              FilteredDataQueue::Ptr&& r,
+                              const Session*           s)
+{
+    analyzers.procedure<Procedure>(std::move(c), std::move(r), s, [handle](auto& target, const Procedure& proc) {
+        target(handle, proc);
+    });
+}
+
 // ----------------------------------------------------------------------------
 
-static inline void analyze_nfsv3_procedure(const uint32_t procedure, XDRDecoder&& c, XDRDecoder&& r, const Session* s, Analyzers& analyzers)
+static inline void analyze_nfsv3_procedure(const uint32_t procedure, FilteredDataQueue::Ptr&& c, FilteredDataQueue::Ptr&& r, const Session* s, Analyzers& analyzers)
 {
     using namespace NST::protocols::NFS3;
     switch(procedure)
     {
     case ProcEnumNFS3::NFS_NULL:
-        analyzers(&IAnalyzer::INFSv3rpcgen::null, NFSPROC3RPCGEN_NULL{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_NULL>(analyzers, &IAnalyzer::INFSv3rpcgen::null, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::GETATTR:
-        analyzers(&IAnalyzer::INFSv3rpcgen::getattr3, NFSPROC3RPCGEN_GETATTR{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_GETATTR>(analyzers, &IAnalyzer::INFSv3rpcgen::getattr3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::SETATTR:
-        analyzers(&IAnalyzer::INFSv3rpcgen::setattr3, NFSPROC3RPCGEN_SETATTR{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_SETATTR>(analyzers, &IAnalyzer::INFSv3rpcgen::setattr3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::LOOKUP:
-        analyzers(&IAnalyzer::INFSv3rpcgen::lookup3, NFSPROC3RPCGEN_LOOKUP{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_LOOKUP>(analyzers, &IAnalyzer::INFSv3rpcgen::lookup3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::ACCESS:
-        analyzers(&IAnalyzer::INFSv3rpcgen::access3, NFSPROC3RPCGEN_ACCESS{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_ACCESS>(analyzers, &IAnalyzer::INFSv3rpcgen::access3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::READLINK:
-        analyzers(&IAnalyzer::INFSv3rpcgen::readlink3, NFSPROC3RPCGEN_READLINK{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_READLINK>(analyzers, &IAnalyzer::INFSv3rpcgen::readlink3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::READ:
-        analyzers(&IAnalyzer::INFSv3rpcgen::read3, NFSPROC3RPCGEN_READ{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_READ>(analyzers, &IAnalyzer::INFSv3rpcgen::read3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::WRITE:
-        analyzers(&IAnalyzer::INFSv3rpcgen::write3, NFSPROC3RPCGEN_WRITE{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_WRITE>(analyzers, &IAnalyzer::INFSv3rpcgen::write3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::CREATE:
-        analyzers(&IAnalyzer::INFSv3rpcgen::create3, NFSPROC3RPCGEN_CREATE{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_CREATE>(analyzers, &IAnalyzer::INFSv3rpcgen::create3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::MKDIR:
-        analyzers(&IAnalyzer::INFSv3rpcgen::mkdir3, NFSPROC3RPCGEN_MKDIR{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_MKDIR>(analyzers, &IAnalyzer::INFSv3rpcgen::mkdir3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::SYMLINK:
-        analyzers(&IAnalyzer::INFSv3rpcgen::symlink3, NFSPROC3RPCGEN_SYMLINK{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_SYMLINK>(analyzers, &IAnalyzer::INFSv3rpcgen::symlink3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::MKNOD:
-        analyzers(&IAnalyzer::INFSv3rpcgen::mknod3, NFSPROC3RPCGEN_MKNOD{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_MKNOD>(analyzers, &IAnalyzer::INFSv3rpcgen::mknod3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::REMOVE:
-        analyzers(&IAnalyzer::INFSv3rpcgen::remove3, NFSPROC3RPCGEN_REMOVE{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_REMOVE>(analyzers, &IAnalyzer::INFSv3rpcgen::remove3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::RMDIR:
-        analyzers(&IAnalyzer::INFSv3rpcgen::rmdir3, NFSPROC3RPCGEN_RMDIR{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_RMDIR>(analyzers, &IAnalyzer::INFSv3rpcgen::rmdir3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::RENAME:
-        analyzers(&IAnalyzer::INFSv3rpcgen::rename3, NFSPROC3RPCGEN_RENAME{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_RENAME>(analyzers, &IAnalyzer::INFSv3rpcgen::rename3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::LINK:
-        analyzers(&IAnalyzer::INFSv3rpcgen::link3, NFSPROC3RPCGEN_LINK{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_LINK>(analyzers, &IAnalyzer::INFSv3rpcgen::link3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::READDIR:
-        analyzers(&IAnalyzer::INFSv3rpcgen::readdir3, NFSPROC3RPCGEN_READDIR{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_READDIR>(analyzers, &IAnalyzer::INFSv3rpcgen::readdir3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::READDIRPLUS:
-        analyzers(&IAnalyzer::INFSv3rpcgen::readdirplus3, NFSPROC3RPCGEN_READDIRPLUS{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_READDIRPLUS>(analyzers, &IAnalyzer::INFSv3rpcgen::readdirplus3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::FSSTAT:
-        analyzers(&IAnalyzer::INFSv3rpcgen::fsstat3, NFSPROC3RPCGEN_FSSTAT{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_FSSTAT>(analyzers, &IAnalyzer::INFSv3rpcgen::fsstat3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::FSINFO:
-        analyzers(&IAnalyzer::INFSv3rpcgen::fsinfo3, NFSPROC3RPCGEN_FSINFO{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_FSINFO>(analyzers, &IAnalyzer::INFSv3rpcgen::fsinfo3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::PATHCONF:
-        analyzers(&IAnalyzer::INFSv3rpcgen::pathconf3, NFSPROC3RPCGEN_PATHCONF{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_PATHCONF>(analyzers, &IAnalyzer::INFSv3rpcgen::pathconf3, std::move(c), std::move(r), s);
         break;
     case ProcEnumNFS3::COMMIT:
-        analyzers(&IAnalyzer::INFSv3rpcgen::commit3, NFSPROC3RPCGEN_COMMIT{c, r, s});
+        analyze_procedure<NFSPROC3RPCGEN_COMMIT>(analyzers, &IAnalyzer::INFSv3rpcgen::commit3, std::move(c), std::move(r), s);
         break;
     }
 }
 
-static inline void analyze_nfsv4_procedure(const uint32_t procedure, XDRDecoder&& c, XDRDecoder&& r, const Session* s, Analyzers& analyzers)
+static inline void analyze_nfsv4_procedure(const uint32_t procedure, FilteredDataQueue::Ptr&& c, FilteredDataQueue::Ptr&& r, const Session* s, Analyzers& analyzers)
 {
     using namespace NST::protocols::NFS4;
     using namespace NST::protocols::NFS41;
 
-    switch(get_nfs4_compound_minor_version(procedure, c.data().data))
+    switch(get_nfs4_compound_minor_version(procedure, *c))
     {
     case NFS_V40:
         switch(procedure)
         {
         case ProcEnumNFS4::NFS_NULL:
-            analyzers(&IAnalyzer::INFSv4rpcgen::null4, NFSPROC4RPCGEN_NULL{c, r, s});
+            analyze_procedure<NFSPROC4RPCGEN_NULL>(analyzers, &IAnalyzer::INFSv4rpcgen::null4, std::move(c), std::move(r), s);
             break;
         case ProcEnumNFS4::COMPOUND:
-            NFSPROC4RPCGEN_COMPOUND compound{c, r, s};
-            analyzers(&IAnalyzer::INFSv4rpcgen::compound4, compound);
-            analyze_nfs40_operations(analyzers, compound);
+            analyzers.procedure<NFSPROC4RPCGEN_COMPOUND>(std::move(c), std::move(r), s, [](auto& target, const NFSPROC4RPCGEN_COMPOUND& compound) {
+                target(&IAnalyzer::INFSv4rpcgen::compound4, compound);
+                analyze_nfs40_operations(target, compound);
+            });
             break;
         }
         break;
     case NFS_V41:
         if(ProcEnumNFS41::COMPOUND == procedure)
         {
-            NFSPROC41RPCGEN_COMPOUND compound{c, r, s};
-            analyzers(&IAnalyzer::INFSv41rpcgen::compound41, compound);
-            analyze_nfs41_operations(analyzers, compound);
+            analyzers.procedure<NFSPROC41RPCGEN_COMPOUND>(std::move(c), std::move(r), s, [](auto& target, const NFSPROC41RPCGEN_COMPOUND& compound) {
+                target(&IAnalyzer::INFSv41rpcgen::compound41, compound);
+                analyze_nfs41_operations(target, compound);
+            });
         }
         break;
     }
@@ -288,41 +312,48 @@ void NFSParser::analyze_nfs_procedure(FilteredDataQueue::Ptr&& call,
 * minor version ONLY in call COMPOUND(1) procedure.
 * That's why only call can be passed here.
 */
-static uint32_t get_nfs4_compound_minor_version(const uint32_t procedure, const std::uint8_t* rpc_nfs4_call)
+static uint32_t get_nfs4_compound_minor_version(const uint32_t procedure, const FilteredData& rpc_nfs4_call)
 {
     if(ProcEnumNFS4::COMPOUND != procedure)
     {
         return 0;
     }
-    // get initial data
-    auto* it = rpc_nfs4_call;
+    // header of call is read from the first part of data
+    const std::uint8_t* data   = rpc_nfs4_call.data;
+    const size_t        length = rpc_nfs4_call.head_length();
+    auto                word   = [&](size_t offset) { return ntohl(*(uint32_t*)(data + offset)); };
 
     // move to rpc's credentials length
-    it += (sizeof(protocols::rpc::CallHeader) + sizeof(uint32_t));
-    size_t rpc_cred_length = ntohl(*(uint32_t*)it);
+    size_t it = sizeof(protocols::rpc::CallHeader) + sizeof(uint32_t);
+    if(it + sizeof(uint32_t) > length) return 0;
+    size_t rpc_cred_length = word(it);
 
     // skip credentials & move to rpc's verifier length
     it += (rpc_cred_length * sizeof(uint8_t) + sizeof(uint32_t));
-    size_t rpc_verf_length = ntohl(*(uint32_t*)it);
+    if(it + sizeof(uint32_t) > length) return 0;
+    size_t rpc_verf_length = word(it);
 
     // skip verifier & move to nfsv4's tag length
     it += (rpc_verf_length * sizeof(uint8_t) + sizeof(uint32_t));
-    size_t rpc_tag_length = ntohl(*(uint32_t*)it);
+    if(it + sizeof(uint32_t) > length) return 0;
+    size_t rpc_tag_length = word(it);
 
     // skip tag & move to nfsv4's minor version
     it += (rpc_tag_length * sizeof(uint8_t) + 2 * sizeof(uint32_t));
+    if(it + sizeof(uint32_t) > length) return 0;
 
-    return ntohl(*(uint32_t*)it);
+    return word(it);
 }
 
 //! Common internal function for parsing NFSv4.x's COMPOUND procedure
 //! It's supposed to be used inside analyze_nfs_procedure only
 template <
-    typename ArgOpType,       // Type of arguments(call part of nfs's procedure)
-    typename ResOpType,       // Type of results(reply part of nfs's procedure)
-    typename NFS4CompoundType // Type of NFSv4.x COMPOUND procedure. Can be 4.0 or 4.1
+    typename ArgOpType,        // Type of arguments(call part of nfs's procedure)
+    typename ResOpType,        // Type of results(reply part of nfs's procedure)
+    typename NFS4CompoundType, // Type of NFSv4.x COMPOUND procedure. Can be 4.0 or 4.1
+    typename Target            // Analyzers or handlers of single analyzer
     >
-void analyze_nfs4_operations(Analyzers& analyzers, NFS4CompoundType& nfs4_compound_procedure)
+void analyze_nfs4_operations(Target& analyzers, const NFS4CompoundType& nfs4_compound_procedure)
 {
     ArgOpType* arg{nullptr};
     ResOpType* res{nullptr};
@@ -382,12 +413,13 @@ void analyze_nfs4_operations(Analyzers& analyzers, NFS4CompoundType& nfs4_compou
 //! Internal function for proper passing NFSv4.x's arg + res operations to analyzers
 //! It's supposed to be used inside nfs4_ops_switch only
 template <
+    typename Target,
     typename nfs_argop4_t,
     typename nfs_resop4_t,
     typename IAnalyzer_func_t,
     typename nfs_argop_member_t,
     typename nfs_resop_member_t>
-inline void analyze(Analyzers&          analyzers,
+inline void analyze(Target&             analyzers,
                     const RPCProcedure* rpc_procedure,
                     const nfs_argop4_t* arg,
                     const nfs_resop4_t* res,
@@ -403,10 +435,11 @@ inline void analyze(Analyzers&          analyzers,
 //! Internal function for proper passing NFSv4.x's res-only operations to analyzers
 //! It's supposed to be used inside nfs4_ops_switch only
 template <
+    typename Target,
     typename nfs_resop4_t,
     typename IAnalyzer_func_t,
     typename nfs_resop_member_t>
-inline void analyze(Analyzers&          analyzers,
+inline void analyze(Target&             analyzers,
                     const RPCProcedure* rpc_procedure,
                     const nfs_resop4_t* res,
                     IAnalyzer_func_t&&  IAnalyzer_function,
@@ -418,7 +451,8 @@ inline void analyze(Analyzers&          analyzers,
 
 //! Internal function for proper passing NFSv4.0's operations to analyzers
 //! It's supposed to be used inside analyze_nfs4_operations only
-void nfs4_ops_switch(Analyzers&                        analyzers,
+template <typename Target>
+void nfs4_ops_switch(Target&                           analyzers,
                      const RPCProcedure*               rpc_procedure,
                      const NST::API::NFS4::nfs_argop4* arg,
                      const NST::API::NFS4::nfs_resop4* res)
@@ -663,7 +697,8 @@ void nfs4_ops_switch(Analyzers&                        analyzers,
 
 //! Internal function for proper passing NFSv4.1's operations to analyzers
 //! It's supposed to be used inside analyze_nfs4_operations only
-void nfs4_ops_switch(Analyzers&                         analyzers,
+template <typename Target>
+void nfs4_ops_switch(Target&                            analyzers,
                      const RPCProcedure*                rpc_procedure,
                      const NST::API::NFS41::nfs_argop4* arg,
                      const NST::API::NFS41::nfs_resop4* res)
@@ -58,6 +58,10 @@ public:
     bool parse_data(FilteredDataQueue::Ptr& data);
 
     void parse_data(FilteredDataQueue::Ptr&& data);
+
+    // forget session closed by filtration
+    inline void close_session(utils::NetworkSession* session) { sessions.close(session); }
+
     void analyze_nfs_procedure(FilteredDataQueue::Ptr&& call,
                                FilteredDataQueue::Ptr&& reply,
                                Session*                 session);
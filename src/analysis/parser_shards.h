@@ -0,0 +1,246 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Parser threads parsing data of their own subsets of sessions.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef PARSER_SHARDS_H
+#define PARSER_SHARDS_H
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "controller/running_status.h"
+#include "utils/doorbell.h"
+#include "utils/filtered_data.h"
+#include "utils/noncopyable.h"
+#include "utils/spinlock.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace analysis
+{
+// Set of parser threads, each of them parses data of its own subset of
+// sessions, so calls and replies of a session are matched by one thread and
+// data of a session are parsed in order. Data taken out from the queue by
+// ParserThread are routed to the threads by Dispatcher.
+template <typename Parser>
+class ParserShards final : utils::noncopyable
+{
+    using RunningStatus     = NST::controller::RunningStatus;
+    using FilteredDataQueue = NST::utils::FilteredDataQueue;
+    using Data              = std::vector<FilteredDataQueue::Ptr>;
+    using Doorbell          = NST::utils::Doorbell;
+    using Spinlock          = NST::utils::Spinlock;
+
+    class Shard final : utils::noncopyable
+    {
+    public:
+        Shard(Parser p, RunningStatus& s, std::chrono::microseconds spin, std::size_t l)
+            : status(s)
+            , limit{l}
+            , closed{false}
+            , doorbell{spin}
+            , running{false}
+            , parser(p)
+        {
+        }
+
+        void start()
+        {
+            running.store(true);
+            parsing = std::thread(&Shard::thread, this);
+        }
+
+        void stop()
+        {
+            running.store(false);
+            doorbell.ring(); // wake up the thread
+            parsing.join();
+        }
+
+        // pass data to the thread, wait if it has too many pending data;
+        // data stay in ptr if the thread is terminated
+        void push(FilteredDataQueue::Ptr& ptr)
+        {
+            for(unsigned attempt = 0;; ++attempt)
+            {
+                {
+                    Spinlock::Lock lock{spinlock};
+                    if(closed)
+                    {
+                        return;
+                    }
+                    if(pending.size() < limit)
+                    {
+                        pending.emplace_back(std::move(ptr));
+                        break;
+                    }
+                }
+                if(attempt < 64)
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+            doorbell.ring();
+        }
+
+    private:
+        inline void thread()
+        {
+            try
+            {
+                Data data;
+                while(running.load())
+                {
+                    parse(data);
+                    parser.flush();
+                    doorbell.wait(std::chrono::milliseconds(100));
+                }
+                parse(data); // flush pending data
+                parser.flush();
+            }
+            catch(...)
+            {
+                status.push_current_exception();
+            }
+
+            Data data;
+            Spinlock::Lock lock{spinlock};
+            closed = true; // don't block dispatching anymore
+            data.swap(pending);
+        }
+
+        inline void parse(Data& data)
+        {
+            while(true)
+            {
+                {
+                    Spinlock::Lock lock{spinlock};
+                    data.swap(pending);
+                }
+                if(data.empty())
+                {
+                    return;
+                }
+                for(auto& ptr : data)
+                {
+                    parser.parse_data(ptr);
+                }
+                data.clear();
+            }
+        }
+
+        RunningStatus&    status;
+        const std::size_t limit; // max number of pending data
+        Spinlock          spinlock;
+        Data              pending; // passed to the thread, not parsed yet
+        bool              closed;  // the thread doesn't parse data anymore
+        Doorbell          doorbell;
+        std::thread       parsing;
+        std::atomic<bool> running;
+        Parser            parser;
+    };
+
+public:
+    // parser of ParserThread which routes data to shards
+    class Dispatcher final
+    {
+    public:
+        explicit Dispatcher(ParserShards* s)
+            : shards{s}
+        {
+        }
+
+        inline void parse_data(FilteredDataQueue::Ptr& data)
+        {
+            shards->dispatch(data);
+        }
+
+        inline void flush() {} // shards flush their parsers
+
+    private:
+        ParserShards* shards;
+    };
+
+    // each thread polls its pending data up to spin before sleeping, the
+    // dispatching waits if a thread has limit of pending data
+    ParserShards(RunningStatus& s, std::chrono::microseconds spin, std::size_t limit)
+        : status(s)
+        , spin_time{spin}
+        , pending_limit{limit}
+    {
+    }
+
+    ~ParserShards() = default;
+
+    // add thread parsing data by its own parser
+    void add(Parser p)
+    {
+        shards.emplace_back(new Shard{p, status, spin_time, pending_limit});
+    }
+
+    inline unsigned   size() const { return unsigned(shards.size()); }
+    inline Dispatcher dispatcher() { return Dispatcher{this}; }
+
+    void start()
+    {
+        for(auto& s : shards)
+        {
+            s->start();
+        }
+    }
+
+    // all dispatched data are parsed before return
+    void stop()
+    {
+        for(auto& s : shards)
+        {
+            s->stop();
+        }
+    }
+
+private:
+    // address of network session is mixed by Fibonacci hashing, so sessions
+    // allocated next to each other are spread over shards
+    void dispatch(FilteredDataQueue::Ptr& data)
+    {
+        const uint64_t address{reinterpret_cast<std::uintptr_t>(data->session)};
+        const uint64_t index{((address >> 4) * 0x9E3779B97F4A7C15ULL) >> 32};
+        shards[index % shards.size()]->push(data);
+    }
+
+    RunningStatus&                      status;
+    const std::chrono::microseconds     spin_time;
+    const std::size_t                   pending_limit;
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+} // namespace analysis
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // PARSER_SHARDS_H
+//------------------------------------------------------------------------------
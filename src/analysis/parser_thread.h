@@ -23,12 +23,15 @@
 #define NFS_PARSER_THREAD_H
 //------------------------------------------------------------------------------
 #include <atomic>
+#include <chrono>
 #include <thread>
 
 #include "analysis/analyzers.h"
 #include "controller/running_status.h"
+#include "utils/doorbell.h"
 #include "utils/filtered_data.h"
 #include "utils/noncopyable.h"
+#include "utils/ordered_queues.h"
 //------------------------------------------------------------------------------
 namespace NST
 {
@@ -39,14 +42,32 @@ class ParserThread final : utils::noncopyable
 {
     using RunningStatus     = NST::controller::RunningStatus;
     using FilteredDataQueue = NST::utils::FilteredDataQueue;
+    using OrderedQueues     = NST::utils::OrderedQueues;
+    using Doorbell          = NST::utils::Doorbell;
 
 public:
-    ParserThread(Parser p, FilteredDataQueue& q, RunningStatus& s)
+    // the thread polls the queue up to spin before sleeping until new data
+    ParserThread(Parser p, FilteredDataQueue& q, RunningStatus& s, std::chrono::microseconds spin)
         : status(s)
-        , queue(q)
+        , queue{&q}
+        , ordered{nullptr}
+        , doorbell{spin}
         , running{ATOMIC_FLAG_INIT} // false
         , parser(p)
     {
+        queue->set_doorbell(&doorbell);
+    }
+
+    // parse data of parallel filtration threads in order of packets
+    ParserThread(Parser p, OrderedQueues& q, RunningStatus& s, std::chrono::microseconds spin)
+        : status(s)
+        , queue{nullptr}
+        , ordered{&q}
+        , doorbell{spin}
+        , running{ATOMIC_FLAG_INIT} // false
+        , parser(p)
+    {
+        ordered->set_doorbell(&doorbell);
     }
 
     ~ParserThread()
@@ -63,6 +84,7 @@ public:
     void stop()
     {
         running.clear();
+        doorbell.ring(); // wake up the thread
         parsing.join();
     }
 
@@ -75,24 +97,42 @@ private:
             {
                 // process all available items from queue
                 process_queue();
+                parser.flush();
 
-                // then sleep this thread
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                // then wait until filtration pushes new items, the timeout
+                // is a safety net only
+                doorbell.wait(std::chrono::milliseconds(100));
             }
-            process_queue(); // flush data from queue
+            process_queue(true); // flush data from queue
+            parser.flush();
         }
         catch(...)
         {
             status.push_current_exception();
         }
+
+        if(ordered)
+        {
+            ordered->close(); // don't block filtration anymore
+        }
+        else
+        {
+            queue->close();
+        }
     }
 
-    inline void process_queue()
+    inline void process_queue(bool flush = false)
     {
+        if(ordered)
+        {
+            ordered->merge([&](FilteredDataQueue::Ptr& data) { parser.parse_data(data); }, flush);
+            return;
+        }
+
         while(true)
         {
             // take all items from the queue
-            FilteredDataQueue::List list{queue};
+            FilteredDataQueue::List list{*queue};
             if(!list)
             {
                 return; // list from queue is empty, break infinity loop
@@ -107,7 +147,9 @@ private:
     }
 
     RunningStatus&     status;
-    FilteredDataQueue& queue;
+    FilteredDataQueue* queue;
+    OrderedQueues*     ordered;
+    Doorbell           doorbell;
 
     std::thread      parsing;
     std::atomic_flag running;
@@ -36,17 +36,20 @@ namespace analysis
 class Parsers final
 {
     using FilteredDataQueue = NST::utils::FilteredDataQueue;
+    Analyzers& analyzers;
     CIFSParser parser_cifs; //!< CIFS parser
     NFSParser  parser_nfs;  //!< NFS parser
 public:
     Parsers(Analyzers& a)
-        : parser_cifs(a)
+        : analyzers(a)
+        , parser_cifs(a)
         , parser_nfs(a)
     {
     }
 
     Parsers(Parsers& c)
-        : parser_cifs(c.parser_cifs)
+        : analyzers(c.analyzers)
+        , parser_cifs(c.parser_cifs)
         , parser_nfs(c.parser_nfs)
     {
     }
@@ -56,6 +59,15 @@ public:
      */
     inline void parse_data(FilteredDataQueue::Ptr& data)
     {
+        if(data->closes_session())
+        {
+            analyzers.flush(); // batched procedures refer to the session
+            parser_nfs.close_session(data->session);
+            parser_cifs.close_session(data->session);
+            data->session->released.store(true, std::memory_order_release);
+            return;
+        }
+
         if(!parser_nfs.parse_data(data))
         {
             if(!parser_cifs.parse_data(data))
@@ -64,6 +76,14 @@ public:
             }
         }
     }
+
+    /*! Function which will be called by ParserThread class before it waits
+     * for new data, procedures collected in a batch are passed to analyzers
+     */
+    inline void flush()
+    {
+        analyzers.flush();
+    }
 };
 
 } // analysis
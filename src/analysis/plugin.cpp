@@ -29,16 +29,36 @@ namespace analysis
 {
 bool Plugin::isSilent()
 {
-    if(requirements != nullptr)
+    const AnalyzerRequirements* r = get_requirements(0);
+    return r != nullptr && r->silence;
+}
+
+bool Plugin::isConcurrent()
+{
+    const AnalyzerRequirements* r = get_requirements(NST_PLUGIN_API_PARSER_THREADS);
+    return r != nullptr && r->concurrent;
+}
+
+bool Plugin::isMergeable()
+{
+    const AnalyzerRequirements* r = get_requirements(NST_PLUGIN_API_PARSER_THREADS);
+    return r != nullptr && r->mergeable;
+}
+
+bool Plugin::isBatched()
+{
+    return version >= NST_PLUGIN_API_BATCH;
+}
+
+// requirements of plugins built with API older than since are unknown
+const AnalyzerRequirements* Plugin::get_requirements(uint32_t since)
+{
+    if(requirements != nullptr && version >= since)
     {
         // Processing analyzer requirements
-        const AnalyzerRequirements* r = requirements();
-        if(r != nullptr)
-        {
-            return r->silence;
-        }
+        return requirements();
     }
-    return false;
+    return nullptr;
 }
 
 Plugin::Plugin(const std::string& path)
@@ -47,6 +67,7 @@ Plugin::Plugin(const std::string& path)
     , create{nullptr}
     , destroy{nullptr}
     , requirements{nullptr}
+    , version{0}
 {
     plugin_get_entry_points_func nst_get_entry_points{nullptr};
 
@@ -68,6 +89,7 @@ Plugin::Plugin(const std::string& path)
         create       = entry_points->create;
         destroy      = entry_points->destroy;
         requirements = entry_points->requirements;
+        version      = entry_points->vers;
     }
 
     if(!usage || !create || !destroy)
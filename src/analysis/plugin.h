@@ -36,6 +36,9 @@ class Plugin : private NST::utils::DynamicLoad
 public:
     static const std::string usage_of(const std::string& path);
     bool isSilent();
+    bool isConcurrent(); // callbacks may be called by several threads
+    bool isMergeable();  // instance per parser thread, merged before flush
+    bool isBatched();    // procedures may be passed by IAnalyzer::procedures()
 
 protected:
     explicit Plugin(const std::string& path);
@@ -44,6 +47,10 @@ protected:
     plugin_create_func       create;
     plugin_destroy_func      destroy;
     plugin_requirements_func requirements;
+    uint32_t                 version;
+
+private:
+    const AnalyzerRequirements* get_requirements(uint32_t since);
 };
 
 class PluginInstance final : private Plugin
@@ -54,6 +61,9 @@ public:
 
     inline IAnalyzer* instance() const { return analysis; }
     inline bool       silent() { return isSilent(); }
+    inline bool       concurrent() { return isConcurrent(); }
+    inline bool       mergeable() { return isMergeable(); }
+    inline bool       batched() { return isBatched(); }
 private:
     IAnalyzer* analysis;
 };
@@ -2280,10 +2280,7 @@ void PrintAnalyzer::nfs4_operation(const struct NFS4::READ4res* res)
         if(out_all() && res->status == NFS4::nfsstat4::NFS4_OK)
         {
             out << " eof: " << res->READ4res_u.resok4.eof;
-            if(res->READ4res_u.resok4.data.data_len)
-            {
-                out << " data : " << *res->READ4res_u.resok4.data.data_val;
-            }
+            out << " data length: " << res->READ4res_u.resok4.data.data_len;
         }
     }
 }
@@ -3382,10 +3379,7 @@ void PrintAnalyzer::nfs41_operation(const struct NFS41::READ4res* res)
         if(out_all() && res->status == NFS41::nfsstat4::NFS4_OK)
         {
             out << " eof: " << res->READ4res_u.resok4.eof;
-            if(res->READ4res_u.resok4.data.data_len)
-            {
-                out << " data: " << *res->READ4res_u.resok4.data.data_val;
-            }
+            out << " data length: " << res->READ4res_u.resok4.data.data_len;
         }
     }
 }
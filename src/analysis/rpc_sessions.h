@@ -61,6 +61,7 @@ public:
             LOG("replace RPC Call XID:%" PRIu64 " for %s", xid, str().c_str());
         }
 
+        data->detach(); // don't pin memory of reader until reply
         e = std::move(data); // replace existing or set new
     }
     inline FilteredDataQueue::Ptr get_call_data(const std::uint64_t xid)
@@ -103,17 +104,25 @@ public:
             if(type == MsgType::CALL) // add new session only for Call
             {
                 std::unique_ptr<Session> ptr{new Session{*app, dir}};
-                sessions.emplace_back(std::move(ptr));
-
-                app->application = sessions.back().get(); // set reference
+                app->application = ptr.get(); // set reference
+                sessions.emplace(ptr.get(), std::move(ptr));
             }
         }
 
         return reinterpret_cast<Session*>(app->application);
     }
 
+    // delete session of application if it is created by this instance
+    void close(utils::NetworkSession* app)
+    {
+        if(app->application && sessions.erase(app->application))
+        {
+            app->application = nullptr;
+        }
+    }
+
 private:
-    std::vector<std::unique_ptr<Session>> sessions;
+    std::unordered_map<const void*, std::unique_ptr<Session>> sessions;
 };
 
 } // namespace analysis
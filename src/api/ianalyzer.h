@@ -1793,6 +1793,27 @@ public:
     // clang-format on
 };
 
+class IAnalyzer;
+
+/*! Procedure passed to analyzers in a batch, it is valid until
+ * IAnalyzer::procedures() returns
+ */
+class ProcedureCall
+{
+public:
+    virtual ~ProcedureCall() {}
+
+    /*! Pass the procedure (and operations of NFSv4.x COMPOUND) to handlers
+     * of analyzer as they are called without batching
+     * \param analyzer - handlers of analyzer
+     */
+    virtual void dispatch(IAnalyzer& analyzer) const = 0;
+
+    /*! RPC call and reply of the procedure
+     */
+    virtual const RPCProcedure* rpc() const = 0;
+};
+
 /*! Base interface for all nfstrace plugins.
  * Extends protocol interfaces: NFS3, NFS4, NFS41, SMBv1, SMBv2
  */
@@ -1802,6 +1823,27 @@ public:
     virtual ~IAnalyzer() {}
     virtual void flush_statistics() = 0;
     virtual void on_unix_signal(int /*signo*/) {}
+
+    /*! Batch of NFS procedures in order of their replies, it replaces calls
+     * of handlers of these procedures. By default each procedure is passed
+     * to its handlers.
+     * \param calls - procedures of batch
+     * \param count - number of procedures
+     */
+    virtual void procedures(const ProcedureCall* const* calls, std::size_t count)
+    {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            calls[i]->dispatch(*this);
+        }
+    }
+
+    /*! Add statistics of other instance of the same mergeable analyzer,
+     * it is called before flush_statistics() for instances created for
+     * each parser thread
+     * \param other - instance of the same analyzer
+     */
+    virtual void merge(IAnalyzer& /*other*/) {}
 };
 
 } // namespace API
@@ -22,6 +22,8 @@
 #ifndef PROCEDURE_H
 #define PROCEDURE_H
 //------------------------------------------------------------------------------
+#include <cstdint>
+
 #include <sys/time.h>
 
 #include "session.h"
@@ -30,6 +32,14 @@ namespace NST
 {
 namespace API
 {
+// Timestamp of packet. Procedures point to its first member, so plugins built
+// for previous versions of API get microseconds via timeval as before.
+struct Timestamp
+{
+    struct timeval tv;   // with microsecond precision
+    uint64_t       nsec; // nanoseconds since the Epoch
+};
+
 template <typename ProcedureType>
 struct Procedure
 {
@@ -37,8 +47,19 @@ struct Procedure
     ProcedureType reply;
 
     const struct Session* session;
-    const struct timeval* ctimestamp;
-    const struct timeval* rtimestamp;
+    const struct timeval* ctimestamp; // points to Timestamp::tv
+    const struct timeval* rtimestamp; // points to Timestamp::tv
+
+    // Nanoseconds since the Epoch of call and reply.
+    // Available since NST_PLUGIN_API_NSEC_TIMESTAMPS version of API.
+    inline uint64_t call_nanoseconds() const { return timestamp(ctimestamp)->nsec; }
+    inline uint64_t reply_nanoseconds() const { return timestamp(rtimestamp)->nsec; }
+
+private:
+    static inline const Timestamp* timestamp(const struct timeval* tv)
+    {
+        return reinterpret_cast<const Timestamp*>(tv);
+    }
 };
 
 } // namespace API
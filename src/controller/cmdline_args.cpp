@@ -43,11 +43,18 @@ const char* const Args::draining_mode  {DRAIN};
 Opt Args::options[Args::num] =
 {
     {'m', "mode",       Opt::REQ, LIVE,                  "set the running mode",                           DRAIN "|" LIVE "|" DUMP "|" STAT,   nullptr, false},
-    {'i', "interface",  Opt::REQ, "FIRST-NIC",           "listen interface, it is required for " LIVE " and " DUMP " modes", "INTERFACE",      nullptr, false},
+    {'i', "interface",  Opt::MUL, "FIRST-NIC",           "listen interface, it is required for " LIVE " and " DUMP " modes; may be repeated to capture from several interfaces in " LIVE " mode", "INTERFACE", nullptr, false},
     {'f', "filtration", Opt::REQ, "port 2049 or port 445","specify the packet filter in BPF syntax(see pcap-filter(7))",     "BPF",            nullptr, false},
     {'s', "snaplen",    Opt::REQ, "65535",               "set the max length of captured raw packet (bigger packets will be truncated). Can be used ONLY FOR UDP", "1..65535", nullptr, false},
     {'t', "timeout",    Opt::REQ, "100",                 "set the read timeout that will be used while capturing",           "Milliseconds",   nullptr, false},
     {'b', "bsize",      Opt::REQ, "20",                  "set the size of operation system capture buffer in MBytes; note that this option is crucial for capturing performance", "MBytes", nullptr, false},
+    { 0 , "ring",       Opt::NOA, "false",               "capture packets via memory-mapped TPACKET_V3 ring of AF_PACKET socket instead of libpcap (Linux only)", nullptr, nullptr, false},
+    { 0 , "ring-block", Opt::REQ, "1024",                "set the size of a block of TPACKET_V3 ring in KBytes, it must be a multiple of the page size", "KBytes", nullptr, false},
+    { 0 , "ring-blocks",Opt::REQ, "64",                  "set the number of blocks in TPACKET_V3 ring",                         "1..65535",               nullptr, false},
+    { 0 , "fanout",     Opt::REQ, "1",                   "set the number of threads capturing from TPACKET_V3 rings joined into PACKET_FANOUT group, each thread filters its own sessions; only for " LIVE " mode with --ring", "1..64", nullptr, false},
+    { 0 , "batch",      Opt::REQ, "1",                   "set the max number of packets passed to filtration at once; sessions of a batch are looked up and prefetched before reassembly, 1 means per-packet processing", "1..256", nullptr, false},
+    { 0 , "jobs",       Opt::REQ, "1",                   "set the number of threads reading the input file in " STAT " mode, each thread filters its own sessions; data are passed to analyzers in order of packets", "1..64", nullptr, false},
+    { 0 , "session-timeout", Opt::REQ, "300",            "release sessions idle for this time of capture, 0 means never; TCP sessions are also released after FIN or RST", "Seconds", nullptr, false},
     {'p', "promisc",    Opt::REQ, "true",                "put the capturing interface into promiscuous mode",                   nullptr,                  nullptr, false},
     {'d', "direction",  Opt::REQ, "inout",               "set the direction for which packets will be captured",                "in|out|inout",           nullptr, false},
     {'a', "analysis",   Opt::MUL, "",                    "specify the path to an analysis module and set its options (if any)", "PATH#opt1,opt2=val,...", nullptr, false},
@@ -58,7 +65,15 @@ Opt Args::options[Args::num] =
     {'D', "dump-size",  Opt::REQ, "0",                   "set the size of dumping file portion, 0 means no limit",              "MBytes",                 nullptr, false},
     {'E', "enum",       Opt::REQ, "none",                "enumerate all available network interfaces and/or all available plugins, then exit", "interfaces|plugins|-", nullptr, false},
     {'M', "msg-header", Opt::REQ, "512",                 "Truncate RPC messages to this limit (specified in bytes) before passing to a pluggable analysis module", "1..4000", nullptr, false},
-    {'Q', "qcapacity",  Opt::REQ, "4096",                "set the initial capacity of the queue with RPC messages",                                   "1..65535", nullptr, false},
+    {'Q', "qcapacity",  Opt::REQ, "4096",                "set the capacity of the queue with RPC messages, it is rounded up to a power of 2; if the queue is full the filtration waits in " STAT " mode or drops messages in " LIVE " mode", "1..65535", nullptr, false},
+    { 0 , "qelement",   Opt::REQ, "512",                 "set the size of message kept in an element of the queue; longer messages are continued in heap chunks", "128..65535", nullptr, false},
+    { 0 , "qdrop",      Opt::REQ, "newest",              "set which messages are dropped if the queue is full in " LIVE " mode", "newest|oldest", nullptr, false},
+    { 0 , "spin",       Opt::REQ, "50",                  "set the max time the parser thread polls the queue before it sleeps until new messages are pushed, 0 means sleep at once", "Microseconds", nullptr, false},
+    { 0 , "parsers",    Opt::REQ, "1",                   "set the number of threads parsing messages, each thread parses its own sessions; plugins which aren't thread-safe are instantiated for each thread or called under lock", "1..64", nullptr, false},
+    { 0 , "abatch",     Opt::REQ, "1",                   "set the max number of NFS procedures passed to analyzers at once, 1 means per-procedure calls", "1..256", nullptr, false},
+    { 0 , "cpus-filtration", Opt::REQ, "",              "place capture and filtration threads on the CPUs, their buffers are allocated on NUMA nodes of the CPUs; empty means no placement", "0-3,8,...", nullptr, false},
+    { 0 , "cpus-parsers", Opt::REQ, "",                 "place parser threads on the CPUs, the queue of messages is allocated on NUMA nodes of the CPUs; empty means no placement", "0-3,8,...", nullptr, false},
+    { 0 , "cpus-plugins", Opt::REQ, "",                 "place threads created by analysis modules on the CPUs; empty means no placement", "0-3,8,...", nullptr, false},
     {'T', "trace",      Opt::NOA, "false",               "print collected NFSv3 or NFSv4 procedures, true if no modules were passed with -a option",  nullptr,    nullptr, false},
     {'Z', "droproot",   Opt::REQ, "",                    "drop root privileges after opening the capture device",                                    "username", nullptr, false},
     {'v', "verbose",    Opt::REQ, "1",                   "specify verbosity level",                                                                   "0|1|2",    nullptr, false},
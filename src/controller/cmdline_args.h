@@ -42,6 +42,13 @@ struct Args final
         ArgSnaplen,
         ArgTimeout,
         ArgBSize,
+        ArgRing,
+        ArgRingBlock,
+        ArgRingBlocks,
+        ArgFanout,
+        ArgBatch,
+        ArgJobs,
+        ArgSessionTimeout,
         ArgPromisc,
         ArgDirection,
         ArgAnalyzers,
@@ -53,6 +60,14 @@ struct Args final
         ArgEnum,
         ArgMSize,
         ArgQSize,
+        ArgQElement,
+        ArgQDrop,
+        ArgSpin,
+        ArgParsers,
+        ArgABatch,
+        ArgCPUsFiltration,
+        ArgCPUsParsers,
+        ArgCPUsPlugins,
         ArgTrace,
         ArgDropRoot,
         ArgVerbose,
@@ -63,7 +63,7 @@ Controller::Controller(const Parameters& params) try
     , glog       {params.log_path()}
     , signals    {status}
     , analysis   {}
-    , filtration {new FiltrationManager{status}}
+    , filtration {new FiltrationManager{status, params.filtration_cpus()}}
 {
     // clang-format on
     switch(params.running_mode())
@@ -88,8 +88,14 @@ Controller::Controller(const Parameters& params) try
         if(analysis->isSilent())
             utils::Out::Global::set_level(utils::Out::Level::Silent);
 
-        filtration->add_offline_analysis(params.input_file(),
-                                         analysis->get_queue());
+        if(auto queues = analysis->get_ordered_queues())
+        {
+            filtration->add_offline_analysis(params, *queues);
+        }
+        else
+        {
+            filtration->add_offline_analysis(params, analysis->get_queue());
+        }
     }
     break;
     case RunningMode::Draining:
@@ -49,6 +49,7 @@ class ParametersImpl final : public cmdline::CmdlineParser<CLI>
 public:
     ParametersImpl(int argc, char** argv)
         : rpc_message_limit{0}
+        , idle_timeout{0}
     {
         parse(argc, argv);
         if(get(CLI::ArgHelp).to_bool())
@@ -140,13 +141,25 @@ public:
         }
 
         rpc_message_limit = limit;
+
+        const int timeout{get(CLI::ArgSessionTimeout).to_int()};
+        if(timeout < 0)
+        {
+            throw cmdline::CLIError{std::string{"Invalid timeout of sessions: "} + get(CLI::ArgSessionTimeout).to_cstr()};
+        }
+
+        idle_timeout = timeout;
     }
     ~ParametersImpl() override {}
 
 protected:
     void set_multiple_value(int index, char* const v) override
     {
-        if(index == CLI::ArgAnalyzers) // may have multiple values
+        if(index == CLI::ArgInterface) // may have multiple values
+        {
+            interfaces.emplace_back(v);
+        }
+        else if(index == CLI::ArgAnalyzers) // may have multiple values
         {
             const std::string arg{v};
             size_t            ind{arg.find('#')};
@@ -164,6 +177,18 @@ protected:
     }
 
 private:
+    utils::CPUSet cpus(CLI::Names name) const
+    {
+        try
+        {
+            return utils::CPUSet{get(name).to_cstr()};
+        }
+        catch(std::invalid_argument& e)
+        {
+            throw cmdline::CLIError{e.what()};
+        }
+    }
+
     std::string default_iofile() const
     {
         // create string: PROGRAMNAME-BPF-FILTER.pcap
@@ -191,9 +216,11 @@ private:
     }
 
     // cashed values
-    unsigned short       rpc_message_limit;
-    std::string          program; // name of program in command line
-    std::vector<AParams> analysis_modules;
+    unsigned short           rpc_message_limit;
+    uint32_t                 idle_timeout; // of sessions in seconds
+    std::string              program; // name of program in command line
+    std::vector<AParams>     analysis_modules;
+    std::vector<std::string> interfaces; // passed via multiple -i options
 };
 
 } // unnamed namespace
@@ -274,6 +301,85 @@ unsigned short Parameters::queue_capacity() const
     return capacity;
 }
 
+unsigned short Parameters::queue_element() const
+{
+    const int size{impl->get(CLI::ArgQElement).to_int()};
+    if(size < 128 || size > 65535)
+    {
+        throw cmdline::CLIError{std::string{"Invalid size of message in queue element: "} + impl->get(CLI::ArgQElement).to_cstr()};
+    }
+
+    return size;
+}
+
+utils::QueuePolicy Parameters::queue_policy() const
+{
+    // a file is read as fast as messages are analyzed
+    if(running_mode() != RunningMode::Profiling)
+    {
+        return utils::QueuePolicy::Block;
+    }
+
+    const auto& drop = impl->get(CLI::ArgQDrop);
+    if(drop.is("newest"))
+    {
+        return utils::QueuePolicy::DropNewest;
+    }
+    else if(drop.is("oldest"))
+    {
+        return utils::QueuePolicy::DropOldest;
+    }
+    throw cmdline::CLIError{std::string{"Invalid value of dropped messages: "} + drop.to_cstr()};
+}
+
+std::chrono::microseconds Parameters::parser_spin() const
+{
+    const int spin{impl->get(CLI::ArgSpin).to_int()};
+    if(spin < 0 || spin > 1000000)
+    {
+        throw cmdline::CLIError{std::string{"Invalid time of polling the queue: "} + impl->get(CLI::ArgSpin).to_cstr()};
+    }
+
+    return std::chrono::microseconds{spin};
+}
+
+unsigned Parameters::parser_threads() const
+{
+    const int threads{impl->get(CLI::ArgParsers).to_int()};
+    if(threads < 1 || threads > 64)
+    {
+        throw cmdline::CLIError{std::string{"Invalid number of parser threads: "} + impl->get(CLI::ArgParsers).to_cstr()};
+    }
+
+    return threads;
+}
+
+unsigned Parameters::analysis_batch() const
+{
+    const int size{impl->get(CLI::ArgABatch).to_int()};
+    if(size < 1 || size > 256)
+    {
+        throw cmdline::CLIError{std::string{"Invalid number of procedures passed to analyzers at once: "} + impl->get(CLI::ArgABatch).to_cstr()};
+    }
+
+    return size;
+}
+
+utils::CPUSet Parameters::filtration_cpus() const
+{
+    return impl->cpus(CLI::ArgCPUsFiltration);
+}
+
+utils::CPUSet Parameters::parser_cpus() const
+{
+    return impl->cpus(CLI::ArgCPUsParsers);
+}
+
+utils::CPUSet Parameters::plugin_cpus() const
+{
+    return impl->cpus(CLI::ArgCPUsPlugins);
+}
+
 bool Parameters::trace() const
 {
     // enable tracing if no analysis module was passed
@@ -285,21 +391,39 @@ int Parameters::verbose_level() const
     return impl->get(CLI::ArgVerbose).to_int();
 }
 
-const Parameters::CaptureParams Parameters::capture_params() const
+unsigned Parameters::batch_size() const
+{
+    const int size{impl->get(CLI::ArgBatch).to_int()};
+    if(size < 1 || size > 256)
+    {
+        throw cmdline::CLIError{std::string{"Invalid size of packets batch: "} + impl->get(CLI::ArgBatch).to_cstr()};
+    }
+    return size;
+}
+
+unsigned Parameters::jobs() const
+{
+    const int jobs{impl->get(CLI::ArgJobs).to_int()};
+    if(jobs < 1 || jobs > 64)
+    {
+        throw cmdline::CLIError{std::string{"Invalid number of jobs: "} + impl->get(CLI::ArgJobs).to_cstr()};
+    }
+    if(jobs > 1 && running_mode() != RunningMode::Analysis)
+    {
+        throw cmdline::CLIError{std::string{"The jobs can be used only in "} + CLI::analysis_mode + " mode"};
+    }
+    return jobs;
+}
+
+const std::vector<Parameters::CaptureParams> Parameters::capture_params() const
 {
     Parameters::CaptureParams params;
-    params.interface   = impl->get(CLI::ArgInterface);
     params.filter      = impl->get(CLI::ArgFilter);
     params.snaplen     = impl->get(CLI::ArgSnaplen).to_int();
     params.timeout_ms  = impl->get(CLI::ArgTimeout).to_int();
     params.buffer_size = impl->get(CLI::ArgBSize).to_int() * 1024 * 1024; // MBytes
     params.promisc     = impl->get(CLI::ArgPromisc).to_bool();
-
-    // check interface
-    if(impl->is_default(CLI::ArgInterface))
-    {
-        params.interface = NST::filtration::pcap::NetworkInterfaces::default_device();
-    }
+    params.ring        = impl->get(CLI::ArgRing).to_bool();
 
     // check capture buffer size
     if(params.buffer_size < 1024 * 1024) // less than 1 MBytes
@@ -307,6 +431,38 @@ const Parameters::CaptureParams Parameters::capture_params() const
         throw cmdline::CLIError{std::string{"Invalid value of kernel buffer size: "} + impl->get(CLI::ArgBSize).to_cstr()};
     }
 
+    // check geometry of TPACKET_V3 ring
+    if(params.ring)
+    {
+        const int block_size{impl->get(CLI::ArgRingBlock).to_int()};
+        const int page_size{static_cast<int>(sysconf(_SC_PAGESIZE))};
+        if(block_size < 1 || block_size > 1024 * 1024 || (block_size * 1024) % page_size)
+        {
+            throw cmdline::CLIError{std::string{"Invalid size of TPACKET_V3 ring block: "} + impl->get(CLI::ArgRingBlock).to_cstr()};
+        }
+
+        const int block_count{impl->get(CLI::ArgRingBlocks).to_int()};
+        if(block_count < 1 || block_count > 65535)
+        {
+            throw cmdline::CLIError{std::string{"Invalid number of TPACKET_V3 ring blocks: "} + impl->get(CLI::ArgRingBlocks).to_cstr()};
+        }
+
+        params.ring_block_size  = block_size * 1024; // KBytes
+        params.ring_block_count = block_count;
+    }
+
+    // check number of threads in PACKET_FANOUT group
+    const int fanout{impl->get(CLI::ArgFanout).to_int()};
+    if(fanout < 1 || fanout > 64)
+    {
+        throw cmdline::CLIError{std::string{"Invalid number of fanout threads: "} + impl->get(CLI::ArgFanout).to_cstr()};
+    }
+    if(fanout > 1 && (!params.ring || running_mode() != RunningMode::Profiling))
+    {
+        throw cmdline::CLIError{std::string{"The fanout threads can be used only in "} + CLI::profiling_mode + " mode with --ring option"};
+    }
+    params.fanout = fanout;
+
     // check max length of raw captured UDP packet
     if(params.snaplen < 1 || params.snaplen > 65535)
     {
@@ -338,7 +494,31 @@ const Parameters::CaptureParams Parameters::capture_params() const
         throw cmdline::CLIError{std::string{"Unknown capturing direction: "} + direction.to_cstr()};
     }
 
-    return params;
+    // check and set interfaces, each one is captured by own reader
+    std::vector<Parameters::CaptureParams> result;
+    if(impl->interfaces.empty())
+    {
+        params.interface = NST::filtration::pcap::NetworkInterfaces::default_device();
+        result.push_back(params);
+    }
+    for(const auto& interface : impl->interfaces)
+    {
+        for(const auto& p : result)
+        {
+            if(p.interface == interface)
+            {
+                throw cmdline::CLIError{std::string{"Interface is specified twice: "} + interface};
+            }
+        }
+        params.interface = interface;
+        result.push_back(params);
+    }
+    if(result.size() > 1 && running_mode() != RunningMode::Profiling)
+    {
+        throw cmdline::CLIError{std::string{"Multiple interfaces can be used only in "} + CLI::profiling_mode + " mode"};
+    }
+
+    return result;
 }
 
 const Parameters::DumpingParams Parameters::dumping_params() const
@@ -369,6 +549,11 @@ unsigned short Parameters::rpcmsg_limit()
     return impl->rpc_message_limit;
 }
 
+uint32_t Parameters::session_timeout()
+{
+    return impl->idle_timeout;
+}
+
 } // namespace controller
 } // namespace NST
 //------------------------------------------------------------------------------
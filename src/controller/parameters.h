@@ -22,12 +22,15 @@
 #ifndef PARAMETERS_H
 #define PARAMETERS_H
 //------------------------------------------------------------------------------
+#include <chrono>
 #include <string>
 #include <vector>
 
 #include "filtration/dumping.h"
 #include "filtration/pcap/capture_reader.h"
+#include "utils/cpu_set.h"
 #include "utils/noncopyable.h"
+#include "utils/queue.h"
 //------------------------------------------------------------------------------
 namespace NST
 {
@@ -80,18 +83,29 @@ public:
     bool show_enum() const;
 
     // access helpers
-    const std::string&          program_name() const;
-    RunningMode                 running_mode() const;
-    std::string                 input_file() const;
-    const std::string           dropuser() const;
-    const std::string           log_path() const;
-    unsigned short              queue_capacity() const;
-    bool                        trace() const;
-    int                         verbose_level() const;
-    const CaptureParams         capture_params() const;
-    const DumpingParams         dumping_params() const;
-    const std::vector<AParams>& analysis_modules() const;
-    static unsigned short       rpcmsg_limit();
+    const std::string&               program_name() const;
+    RunningMode                      running_mode() const;
+    std::string                      input_file() const;
+    const std::string                dropuser() const;
+    const std::string                log_path() const;
+    unsigned short                   queue_capacity() const;
+    unsigned short                   queue_element() const; // bytes of message in element of queue
+    utils::QueuePolicy               queue_policy() const;  // if the queue is full
+    std::chrono::microseconds        parser_spin() const;   // polling of the queue before sleep
+    unsigned                         parser_threads() const;
+    unsigned                         analysis_batch() const; // procedures passed to analyzers at once
+    utils::CPUSet                    filtration_cpus() const; // placement of threads, empty if free
+    utils::CPUSet                    parser_cpus() const;
+    utils::CPUSet                    plugin_cpus() const;
+    bool                             trace() const;
+    int                              verbose_level() const;
+    unsigned                         batch_size() const;
+    unsigned                         jobs() const;
+    const std::vector<CaptureParams> capture_params() const; // one per interface
+    const DumpingParams              dumping_params() const;
+    const std::vector<AParams>&      analysis_modules() const;
+    static unsigned short            rpcmsg_limit();
+    static uint32_t                  session_timeout(); // seconds, 0 - never
 };
 
 } // namespace controller
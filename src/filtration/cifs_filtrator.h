@@ -28,6 +28,7 @@
 #include <pcap/pcap.h>
 
 #include "api/cifs2_commands.h"
+#include "filtration/command_chain.h"
 #include "filtration/filtratorimpl.h"
 #include "protocols/cifs/cifs.h"
 #include "protocols/cifs2/cifs2.h"
@@ -64,6 +65,12 @@ public:
         BaseImpl::setWriterImpl(session_ptr, w, max_hdr);
     }
 
+    // scan SMB2 compounded commands to queue them one by one without data
+    inline size_t scan(const uint8_t* data, size_t len, size_t& payload, bool& cut)
+    {
+        return chain.scan(data, len, payload, cut);
+    }
+
     constexpr static size_t lengthOfBaseHeader()
     {
         return sizeof(NetBIOS::MessageHeader) + sizeof(CIFSv1::MessageHeaderHead);
@@ -119,6 +126,7 @@ public:
         if(const NetBIOS::MessageHeader* nb_header = NetBIOS::get_header(collection.data()))
         {
             const size_t length = nb_header->len() + sizeof(NetBIOS::MessageHeader);
+            chain.stop();
             if(const CIFSv1::MessageHeader* header = CIFSv1::get_header(collection.data() + sizeof(NetBIOS::MessageHeader)))
             {
                 BaseImpl::setMsgLen(length);
@@ -129,6 +137,13 @@ public:
             {
                 BaseImpl::setMsgLen(length);
                 set_msg_size(header, length);
+                if(chain.in_progress()) // scan collected header of the first command
+                {
+                    size_t payload{0};
+                    bool   cut{false};
+                    chain.scan(collection.data() + sizeof(NetBIOS::MessageHeader),
+                               collection.data_size() - sizeof(NetBIOS::MessageHeader), payload, cut);
+                }
                 return BaseImpl::read_message(info);
             }
         }
@@ -147,12 +162,19 @@ private:
 
     inline void set_msg_size(const CIFSv2::MessageHeader* header, const size_t length)
     {
-        if(((header->cmd_code == SMBv2Commands::READ) || (header->cmd_code == SMBv2Commands::WRITE)) && !header->nextCommand)
+        if(header->nextCommand) // compounded commands are scanned
+        {
+            chain.start();
+            return BaseImpl::setToBeCopied(length);
+        }
+        if((header->cmd_code == SMBv2Commands::READ) || (header->cmd_code == SMBv2Commands::WRITE))
         {
             return BaseImpl::setToBeCopied(std::min(length, rw_hdr_max));
         }
         BaseImpl::setToBeCopied(length);
     }
+
+    CommandChain chain;
 };
 
 } // namespace filtration
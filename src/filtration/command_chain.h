@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Scanner of SMB2 compounded chain of commands.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef COMMAND_CHAIN_H
+#define COMMAND_CHAIN_H
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "api/cifs2_commands.h"
+#include "protocols/cifs2/cifs2.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+// Incremental scanner of SMB2 commands compounded in one message through
+// NextCommand offsets. It finds the end of each command in a stream of bytes,
+// so filtration can queue commands one by one, and data buffer of READ
+// response or WRITE request, so filtration can skip it. Scanning stops at
+// the last command or at a header which isn't valid.
+class CommandChain
+{
+    using Header        = protocols::CIFSv2::MessageHeader;
+    using ReadResponse  = API::SMBv2::ReadResponse;
+    using WriteRequest  = API::SMBv2::WriteRequest;
+    using SMBv2Commands = API::SMBv2::SMBv2Commands;
+
+    // header and fixed fields of command up to the length of data
+    static const std::size_t needed{sizeof(protocols::CIFSv2::RawMessageHeader) + 8};
+
+public:
+    // start at the header of the first command
+    inline void start()
+    {
+        active  = true;
+        next    = 0;
+        offset  = 0;
+        payload = 0;
+    }
+
+    inline void stop() { active = false; }
+    inline bool in_progress() const { return active; }
+
+    // Scan bytes of message. Return number of scanned bytes, it is less than
+    // len if the current command ends at returned position or its data
+    // starts there, then the length of data up to the end of command is set
+    // to data and cut is set if the next command follows
+    std::size_t scan(const uint8_t* bytes, std::size_t len, std::size_t& data, bool& cut)
+    {
+        std::size_t i{0};
+        while(active)
+        {
+            if(offset < needed) // collect header of command
+            {
+                if(i == len)
+                {
+                    break;
+                }
+                const std::size_t n{std::min(len - i, needed - offset)};
+                memcpy(head + offset, bytes + i, n);
+                offset += n;
+                i += n;
+                if(offset == needed && !examine())
+                {
+                    active = false;
+                }
+                continue;
+            }
+
+            const std::size_t end{payload ? payload : next};
+            if(offset == end)
+            {
+                if(payload) // data of READ or WRITE up to the end of command
+                {
+                    data   = next ? next - payload : std::numeric_limits<std::size_t>::max();
+                    active = next != 0;
+                }
+                cut     = next != 0;
+                offset  = 0;
+                payload = 0;
+                return i;
+            }
+            if(i == len)
+            {
+                break;
+            }
+            const std::size_t n{std::min(len - i, end - offset)};
+            offset += n;
+            i += n;
+        }
+        return len;
+    }
+
+private:
+    // check header of command, find its end and offset of its data
+    bool examine()
+    {
+        const Header* header{protocols::CIFSv2::get_header(head)};
+        if(!header || header->nextCommand < 0 || (header->nextCommand % 8) != 0 ||
+           (header->nextCommand != 0 && std::size_t(header->nextCommand) < needed))
+        {
+            return false;
+        }
+        next = header->nextCommand;
+
+        const uint8_t* body{head + sizeof(protocols::CIFSv2::RawMessageHeader)};
+        if(header->isFlag(protocols::CIFSv2::Flags::SERVER_TO_REDIR))
+        {
+            const ReadResponse* response{reinterpret_cast<const ReadResponse*>(body)};
+            if(header->cmd_code == SMBv2Commands::READ && header->status == 0 && response->structureSize == 17 &&
+               response->DataOffset >= sizeof(protocols::CIFSv2::RawMessageHeader) + offsetof(ReadResponse, Buffer))
+            {
+                payload = response->DataOffset;
+            }
+        }
+        else
+        {
+            const WriteRequest* request{reinterpret_cast<const WriteRequest*>(body)};
+            if(header->cmd_code == SMBv2Commands::WRITE && request->structureSize == 49 &&
+               request->dataOffset >= sizeof(protocols::CIFSv2::RawMessageHeader) + offsetof(WriteRequest, Buffer))
+            {
+                payload = request->dataOffset;
+            }
+        }
+
+        if(payload && next && payload >= next) // data isn't inside of command
+        {
+            payload = 0;
+        }
+        return next != 0 || payload != 0;
+    }
+
+    bool        active{false};
+    std::size_t next{0};    // length of command, 0 for the last one
+    std::size_t offset{0};  // of scanned bytes in command
+    std::size_t payload{0}; // offset of data in command, 0 if none
+    alignas(8) uint8_t head[sizeof(protocols::CIFSv2::RawMessageHeader) + sizeof(WriteRequest)];
+};
+
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // COMMAND_CHAIN_H
+//------------------------------------------------------------------------------
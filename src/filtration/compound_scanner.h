@@ -0,0 +1,289 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Scanner of NFSv4 COMPOUND looking for payload of READ and WRITE.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef COMPOUND_SCANNER_H
+#define COMPOUND_SCANNER_H
+//------------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+#include "api/nfs_types.h"
+#include "api/rpc_types.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+// Incremental parser of NFSv4.x COMPOUND call or reply in a stream of bytes.
+// It walks through RPC authentication and operations preceding READ or WRITE
+// up to the length of their data, so filtration can skip the data and copy
+// the rest of message. Scanning stops at the first operation it can't step
+// over, at RPCSEC_GSS (arguments may be wrapped) or after the data is found.
+class CompoundScanner
+{
+    using Op = API::ProcEnumNFS41;
+
+    enum class State
+    {
+        Done,
+        CredFlavor,
+        CredLength,
+        VerfFlavor,
+        VerfLength,
+        AcceptStat,
+        Status,
+        TagLength,
+        MinorVersion,
+        Count,
+        Operation,
+        OpStatus,
+        Handle,
+        Bitmap,
+        Attributes,
+        Payload
+    };
+
+public:
+    // start after fixed part of RPC call header
+    inline void call()
+    {
+        start(State::CredFlavor, true);
+    }
+
+    // start after fixed part of accepted RPC reply header
+    inline void reply()
+    {
+        start(State::VerfFlavor, false);
+    }
+
+    inline void stop() { state = State::Done; }
+    inline bool active() const { return state != State::Done; }
+
+    // Scan bytes of message. Return number of scanned bytes, it is less than
+    // len if the length of payload is found at returned position, then the
+    // length of padded payload is set to payload
+    std::size_t scan(const uint8_t* data, std::size_t len, std::size_t& payload)
+    {
+        std::size_t i{0};
+        while(i < len && active())
+        {
+            if(skip)
+            {
+                const std::size_t n{len - i < skip ? len - i : skip};
+                skip -= n;
+                i += n;
+                continue;
+            }
+
+            word = (word << 8) | data[i++];
+            if(++filled == sizeof(word))
+            {
+                filled = 0;
+                if(next(word))
+                {
+                    payload = padded(word);
+                    state   = State::Done;
+                    return i;
+                }
+            }
+        }
+        return len;
+    }
+
+private:
+    inline void start(State s, bool c)
+    {
+        state     = s;
+        is_call   = c;
+        skip      = 0;
+        word      = 0;
+        filled    = 0;
+        count     = 0;
+        operation = 0;
+    }
+
+    inline static std::size_t padded(uint32_t length)
+    {
+        return (std::size_t{length} + 3) & ~std::size_t{3};
+    }
+
+    // handle next word of stream, return true if it is length of payload
+    bool next(uint32_t value)
+    {
+        const uint32_t rpcsec_gss{6}; // flavor of authentication
+
+        switch(state)
+        {
+        case State::CredFlavor:
+        case State::VerfFlavor:
+            state = (value == rpcsec_gss) ? State::Done
+                                          : (state == State::CredFlavor ? State::CredLength : State::VerfLength);
+            break;
+        case State::CredLength:
+            skip  = padded(value);
+            state = State::VerfFlavor;
+            break;
+        case State::VerfLength:
+            skip  = padded(value);
+            state = is_call ? State::TagLength : State::AcceptStat;
+            break;
+        case State::AcceptStat:
+            state = (value == API::AcceptStat::SUCCESS) ? State::Status : State::Done;
+            break;
+        case State::Status:
+            state = State::TagLength;
+            break;
+        case State::TagLength:
+            skip  = padded(value);
+            state = is_call ? State::MinorVersion : State::Count;
+            break;
+        case State::MinorVersion:
+            state = State::Count;
+            break;
+        case State::Count:
+            count = value;
+            state = State::Operation;
+            break;
+        case State::Operation:
+            if(count-- == 0)
+            {
+                state = State::Done;
+            }
+            else if(is_call)
+            {
+                argument(value);
+            }
+            else
+            {
+                operation = value;
+                state     = State::OpStatus;
+            }
+            break;
+        case State::OpStatus:
+            if(value != 0) // NFS4_OK, compound stops at failed operation
+            {
+                state = State::Done;
+            }
+            else
+            {
+                result(operation);
+            }
+            break;
+        case State::Handle:
+            skip  = padded(value);
+            state = State::Operation;
+            break;
+        case State::Bitmap:
+            skip  = std::size_t{value} * sizeof(uint32_t);
+            state = is_call ? State::Operation : State::Attributes;
+            break;
+        case State::Attributes:
+            skip  = padded(value);
+            state = State::Operation;
+            break;
+        case State::Payload:
+            return true;
+        case State::Done:
+            break;
+        }
+        return false;
+    }
+
+    // step over arguments of operation in call
+    void argument(uint32_t op)
+    {
+        switch(op)
+        {
+        case Op::SEQUENCE:
+            skip = 16 + 4 * 4; // sessionid, sequenceid, slotid, highest_slotid, cachethis
+            break;
+        case Op::PUTFH:
+            state = State::Handle;
+            break;
+        case Op::GETATTR:
+            state = State::Bitmap;
+            break;
+        case Op::READ:
+            skip = 16 + 8 + 4; // stateid, offset, count
+            break;
+        case Op::WRITE:
+            skip  = 16 + 8 + 4; // stateid, offset, stable
+            state = State::Payload;
+            break;
+        case Op::PUTPUBFH:
+        case Op::PUTROOTFH:
+        case Op::SAVEFH:
+        case Op::RESTOREFH:
+        case Op::GETFH:
+        case Op::LOOKUPP:
+            break;
+        default:
+            state = State::Done;
+            break;
+        }
+    }
+
+    // step over result of succeeded operation in reply
+    void result(uint32_t op)
+    {
+        state = State::Operation;
+        switch(op)
+        {
+        case Op::SEQUENCE:
+            skip = 16 + 5 * 4; // sessionid, sequenceid, slotid, highest_slotid, target_highest_slotid, status_flags
+            break;
+        case Op::GETFH:
+            state = State::Handle;
+            break;
+        case Op::GETATTR:
+            state = State::Bitmap;
+            break;
+        case Op::READ:
+            skip  = 4; // eof
+            state = State::Payload;
+            break;
+        case Op::PUTFH:
+        case Op::PUTPUBFH:
+        case Op::PUTROOTFH:
+        case Op::SAVEFH:
+        case Op::RESTOREFH:
+        case Op::LOOKUPP:
+            break;
+        default:
+            state = State::Done;
+            break;
+        }
+    }
+
+    State       state{State::Done};
+    bool        is_call{false};
+    std::size_t skip{0};      // bytes to step over before next word
+    uint32_t    word{0};      // collected bytes of next word
+    uint32_t    filled{0};    // number of collected bytes of word
+    uint32_t    count{0};     // operations left in compound
+    uint32_t    operation{0}; // of current result in reply
+};
+
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // COMPOUND_SCANNER_H
+//------------------------------------------------------------------------------
@@ -0,0 +1,474 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Reassembly of fragmented IPv4 and IPv6 datagrams.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef DEFRAGMENTATION_H
+#define DEFRAGMENTATION_H
+//------------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include <pcap/pcap.h>
+
+#include "filtration/packet.h"
+#include "utils/noncopyable.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+// Reassembly of IP datagrams from fragments marked by PacketInfo.
+// Datagrams are collected in fixed pool of slots, so memory is bounded if
+// fragments are lost: incomplete datagrams are expired by timeout since their
+// first fragment and the oldest one is evicted if all slots are used.
+// Overlapping fragments are discarded (RFC 5722), a partial overlap discards
+// whole datagram. Reassembled datagram is returned as synthetic frame with
+// link layer headers of its first fragment and fixed IP header.
+class Defragmentation final : utils::noncopyable
+{
+public:
+    static const unsigned default_slots{128};                       // max incomplete datagrams
+    static const uint64_t default_timeout{30ULL * 1000 * 1000 * 1000}; // nanoseconds, as Linux
+
+    struct Datagram
+    {
+        struct pcap_pkthdr header; // of synthetic frame, caplen == len
+        const uint8_t*     frame;  // link layer headers and reassembled datagram
+        const uint8_t*     ip;     // IP header of datagram in frame
+    };
+
+    explicit Defragmentation(unsigned slots = default_slots, uint64_t t = default_timeout)
+        : pool(slots)
+        , oldest{nullptr}
+        , newest{nullptr}
+        , timeout{t}
+        , fragments{0}
+        , reassembled{0}
+        , expired{0}
+        , evicted{0}
+        , overlapped{0}
+        , invalid{0}
+    {
+        datagrams.reserve(slots);
+        unused.reserve(slots);
+        for(auto& slot : pool)
+        {
+            unused.push_back(&slot);
+        }
+    }
+
+    // add fragment, return reassembled datagram if fragment completes it,
+    // the datagram is valid until next call
+    const Datagram* add(const PacketInfo& info)
+    {
+        ++fragments;
+        expire(info.timestamp);
+
+        Fragment f;
+        const bool parsed{(*info.fragment >> 4) == 4 ? parse_ipv4(info, f) : parse_ipv6(info, f)};
+        if(!parsed)
+        {
+            ++invalid;
+            return nullptr;
+        }
+
+        Slot* slot{find(f.key, info.timestamp)};
+        if(!insert(*slot, f))
+        {
+            return nullptr;
+        }
+
+        if(f.offset == 0) // save headers of first fragment
+        {
+            slot->headers       = f.headers;
+            slot->ip            = f.ip;
+            slot->nexthdr       = f.nexthdr;
+            slot->next_protocol = f.next_protocol;
+            memcpy(slot->buffer.get() + room - f.headers, info.packet, f.headers);
+        }
+
+        if(!slot->total || !slot->headers || slot->ranges.size() != 1 ||
+           slot->ranges.front().begin != 0 || slot->ranges.front().end != slot->total)
+        {
+            return nullptr; // there are holes
+        }
+
+        build(*slot, info);
+        release(slot);
+        ++reassembled;
+        return &datagram;
+    }
+
+    void print_statistic(std::ostream& out) const
+    {
+        if(!fragments) return;
+
+        out << "IP defragmentation: " << fragments << " fragments, "
+            << reassembled << " datagrams reassembled, "
+            << expired << " expired, "
+            << evicted << " evicted, "
+            << overlapped << " overlapping fragments, "
+            << invalid << " invalid fragments\n";
+    }
+
+private:
+    static const uint32_t room{256};      // for headers before payload
+    static const uint32_t max_payload{65535};
+    static const size_t   max_ranges{64}; // holes of datagram
+
+    struct Key
+    {
+        uint8_t  src[16];
+        uint8_t  dst[16];
+        uint32_t id;
+        uint8_t  protocol; // of IPv4 datagram, 0 for IPv6
+        uint8_t  version;
+
+        bool operator==(const Key& k) const
+        {
+            return id == k.id && protocol == k.protocol && version == k.version &&
+                   memcmp(src, k.src, sizeof(src)) == 0 &&
+                   memcmp(dst, k.dst, sizeof(dst)) == 0;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& k) const
+        {
+            uint64_t hash{k.id ^ (uint64_t{k.version} << 32)};
+            for(std::size_t i = 0; i < sizeof(k.src); i += sizeof(uint32_t))
+            {
+                uint32_t s, d;
+                memcpy(&s, k.src + i, sizeof(s));
+                memcpy(&d, k.dst + i, sizeof(d));
+                hash = (hash ^ s ^ (uint64_t{d} << 16)) * 0x9e3779b97f4a7c15;
+            }
+            return hash ^ (hash >> 32);
+        }
+    };
+
+    struct Range // received part of payload
+    {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    struct Fragment
+    {
+        Key            key;
+        const uint8_t* payload;
+        uint32_t       offset;
+        uint32_t       length;
+        bool           more;
+        uint32_t       headers;       // length of link layer and IP headers
+        uint32_t       ip;            // offset of IP header
+        uint32_t       nexthdr;       // IPv6: offset of next header field before fragment header
+        uint8_t        next_protocol; // IPv6: next header of fragment header
+    };
+
+    struct Slot
+    {
+        Key                        key;
+        uint64_t                   first{0};   // timestamp of first received fragment
+        uint32_t                   total{0};   // length of payload, known from last fragment
+        uint32_t                   headers{0}; // saved from first fragment
+        uint32_t                   ip{0};
+        uint32_t                   nexthdr{0};
+        uint8_t                    next_protocol{0};
+        std::vector<Range>         ranges; // sorted and merged
+        std::unique_ptr<uint8_t[]> buffer; // headers room and payload
+        Slot*                      prev{nullptr};
+        Slot*                      next{nullptr}; // in order of first fragments
+    };
+
+    bool parse_ipv4(const PacketInfo& info, Fragment& f) const
+    {
+        const uint32_t available{info.header->caplen - uint32_t(info.fragment - info.packet)};
+        if(available < sizeof(ip::IPv4Header)) return false;
+
+        auto           header = reinterpret_cast<const ip::IPv4Header*>(info.fragment);
+        const uint32_t ihl{header->ihl()};
+        const uint32_t length{header->length()};
+        if(ihl < sizeof(ip::IPv4Header) || length <= ihl || length > available) return false; // truncated
+
+        memset(&f.key, 0, sizeof(f.key));
+        const in_addr_t src{header->src()};
+        const in_addr_t dst{header->dst()};
+        memcpy(f.key.src, &src, sizeof(src));
+        memcpy(f.key.dst, &dst, sizeof(dst));
+        f.key.id       = header->id();
+        f.key.protocol = header->protocol();
+        f.key.version  = 4;
+
+        f.payload       = info.fragment + ihl;
+        f.offset        = header->offset();
+        f.length        = length - ihl;
+        f.more          = header->more_fragments();
+        f.ip            = info.fragment - info.packet;
+        f.headers       = f.ip + ihl;
+        f.nexthdr       = 0;
+        f.next_protocol = 0;
+        return check(f);
+    }
+
+    bool parse_ipv6(const PacketInfo& info, Fragment& f) const
+    {
+        const uint32_t available{info.header->caplen - uint32_t(info.fragment - info.packet)};
+        if(available < sizeof(ip::IPv6Header)) return false;
+
+        auto           header = reinterpret_cast<const ip::IPv6Header*>(info.fragment);
+        const uint32_t length{uint32_t(sizeof(ip::IPv6Header)) + header->payload_len()};
+        if(length > available) return false; // truncated
+
+        // find fragment header after extension headers of unfragmentable part
+        const uint8_t* end{info.fragment + length};
+        const uint8_t* ptr{info.fragment + sizeof(ip::IPv6Header)};
+        uint32_t       nexthdr{offsetof(ip::ipv6_header, ipv6_nexthdr)};
+        uint8_t        type{header->nexthdr()};
+        while(type != ip::NextProtocol::FRAGMENT)
+        {
+            if(type != ip::NextProtocol::HOPOPTS &&
+               type != ip::NextProtocol::DSTOPTS &&
+               type != ip::NextProtocol::ROUTING)
+            {
+                return false;
+            }
+            if(uint32_t(end - ptr) < 2) return false;
+
+            nexthdr = ptr - info.fragment; // next header is first field of extension
+            type    = ptr[0];
+            ptr += (1U + ptr[1]) * 8;
+            if(ptr > end) return false;
+        }
+
+        if(uint32_t(end - ptr) < sizeof(ip::ipv6_frag)) return false;
+        auto           frag = reinterpret_cast<const ip::ipv6_frag*>(ptr);
+        const uint16_t offlg{ntohs(frag->frag_offlg)};
+
+        memset(&f.key, 0, sizeof(f.key));
+        memcpy(f.key.src, header->src(), sizeof(f.key.src));
+        memcpy(f.key.dst, header->dst(), sizeof(f.key.dst));
+        f.key.id      = ntohl(frag->frag_ident);
+        f.key.version = 6;
+
+        f.payload       = ptr + sizeof(ip::ipv6_frag);
+        f.offset        = offlg & ip::ipv6_frag::OFFSET;
+        f.length        = end - f.payload;
+        f.more          = offlg & ip::ipv6_frag::MORE;
+        f.ip            = info.fragment - info.packet;
+        f.headers       = ptr - info.packet; // without fragment header
+        f.nexthdr       = f.ip + nexthdr;
+        f.next_protocol = frag->frag_nexthdr;
+        return check(f);
+    }
+
+    static bool check(const Fragment& f)
+    {
+        if(f.more && (f.length == 0 || f.length % 8)) return false; // only last may be unaligned
+        if(f.offset + f.length > max_payload) return false;
+        if(f.offset == 0 && f.headers > room) return false;
+        return true;
+    }
+
+    // find slot of datagram or allocate it
+    Slot* find(const Key& key, uint64_t now)
+    {
+        auto i = datagrams.find(key);
+        if(i != datagrams.end()) return i->second;
+
+        if(unused.empty()) // evict the oldest incomplete datagram
+        {
+            ++evicted;
+            release(oldest);
+        }
+
+        Slot* slot{unused.back()};
+        unused.pop_back();
+        if(!slot->buffer)
+        {
+            slot->buffer.reset(new uint8_t[room + max_payload]);
+            slot->ranges.reserve(max_ranges);
+        }
+        slot->key     = key;
+        slot->first   = now;
+        slot->total   = 0;
+        slot->headers = 0;
+        slot->ranges.clear();
+
+        slot->prev = newest;
+        slot->next = nullptr;
+        (newest ? newest->next : oldest) = slot;
+        newest                           = slot;
+
+        datagrams.emplace(key, slot);
+        return slot;
+    }
+
+    void release(Slot* slot)
+    {
+        datagrams.erase(slot->key);
+        (slot->prev ? slot->prev->next : oldest) = slot->next;
+        (slot->next ? slot->next->prev : newest) = slot->prev;
+        unused.push_back(slot);
+    }
+
+    void expire(uint64_t now)
+    {
+        while(oldest && oldest->first + timeout < now)
+        {
+            ++expired;
+            release(oldest);
+        }
+    }
+
+    // copy payload of fragment to slot, return false if fragment is discarded
+    bool insert(Slot& slot, const Fragment& f)
+    {
+        const uint32_t end{f.offset + f.length};
+
+        // first range after begin of fragment
+        auto i = slot.ranges.begin();
+        while(i != slot.ranges.end() && i->end <= f.offset)
+        {
+            ++i;
+        }
+
+        if(i != slot.ranges.end() && i->begin < end) // overlap
+        {
+            ++overlapped;
+            if(i->begin > f.offset || i->end < end) // isn't a duplicate
+            {
+                release(&slot);
+            }
+            return false;
+        }
+
+        const bool beyond{slot.total && end > slot.total};
+        const bool before{!f.more && (slot.total ? end != slot.total : !slot.ranges.empty() && slot.ranges.back().end > end)};
+        if(beyond || before)
+        {
+            ++invalid; // inconsistent length of datagram
+            release(&slot);
+            return false;
+        }
+
+        const bool left{i != slot.ranges.begin() && (i - 1)->end == f.offset};
+        const bool right{i != slot.ranges.end() && i->begin == end};
+        if(left && right)
+        {
+            (i - 1)->end = i->end;
+            slot.ranges.erase(i);
+        }
+        else if(left)
+        {
+            (i - 1)->end = end;
+        }
+        else if(right)
+        {
+            i->begin = f.offset;
+        }
+        else
+        {
+            if(slot.ranges.size() == max_ranges)
+            {
+                ++invalid; // too many holes
+                release(&slot);
+                return false;
+            }
+            slot.ranges.insert(i, Range{f.offset, end});
+        }
+
+        if(!f.more) slot.total = end;
+        memcpy(slot.buffer.get() + room + f.offset, f.payload, f.length);
+        return true;
+    }
+
+    // fix headers saved before payload and fill datagram
+    void build(Slot& slot, const PacketInfo& last)
+    {
+        uint8_t* frame{slot.buffer.get() + room - slot.headers};
+        uint8_t* ip{frame + slot.ip};
+
+        if(slot.key.version == 4)
+        {
+            auto           header = reinterpret_cast<ip::ipv4_header*>(ip);
+            const uint32_t ihl{slot.headers - slot.ip};
+
+            header->ipv4_len           = htons(ihl + slot.total);
+            header->ipv4_fragmentation = header->ipv4_fragmentation & htons(ip::ipv4_header::DF);
+            header->ipv4_checksum      = 0;
+            header->ipv4_checksum      = checksum(ip, ihl);
+        }
+        else
+        {
+            auto header = reinterpret_cast<ip::ipv6_header*>(ip);
+
+            header->ipv6_plen   = htons(slot.headers - slot.ip - sizeof(ip::ipv6_header) + slot.total);
+            frame[slot.nexthdr] = slot.next_protocol;
+        }
+
+        datagram.header.ts     = last.header->ts;
+        datagram.header.caplen = slot.headers + slot.total;
+        datagram.header.len    = datagram.header.caplen;
+        datagram.frame         = frame;
+        datagram.ip            = ip;
+    }
+
+    static uint16_t checksum(const uint8_t* header, uint32_t length)
+    {
+        uint32_t sum{0};
+        for(uint32_t i = 0; i + 1 < length; i += 2)
+        {
+            sum += uint32_t{header[i]} << 8 | header[i + 1];
+        }
+        while(sum >> 16)
+        {
+            sum = (sum & 0xffff) + (sum >> 16);
+        }
+        return htons(~sum & 0xffff);
+    }
+
+    std::vector<Slot>                       pool;
+    std::vector<Slot*>                      unused;
+    std::unordered_map<Key, Slot*, KeyHash> datagrams;
+    Slot*                                   oldest;
+    Slot*                                   newest;
+    const uint64_t                          timeout;
+    Datagram                                datagram;
+
+    uint64_t fragments;
+    uint64_t reassembled;
+    uint64_t expired;     // incomplete datagrams dropped by timeout
+    uint64_t evicted;     // incomplete datagrams dropped if pool is full
+    uint64_t overlapped;  // fragments overlapping received data
+    uint64_t invalid;     // truncated or malformed fragments
+};
+
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // DEFRAGMENTATION_H
+//------------------------------------------------------------------------------
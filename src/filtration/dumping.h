@@ -41,6 +41,9 @@ namespace filtration
 class Dumping final : utils::noncopyable
 {
 public:
+    // packets are dumped as they were captured
+    static const bool whole_frames{true};
+
     class Collection final : utils::noncopyable
     {
         const static int cache_size{4096};
@@ -86,16 +89,7 @@ public:
 
         inline void push(const PacketInfo& info, const uint32_t len)
         {
-            if(info.dumped) // if this packet not dumped yet
-            {
-                TRACE("The packet was collected before");
-            }
-            else
-            {
-                // direct dumping without waiting completeness of analysis and complete() call
-                dumper->dump(info.header, info.packet);
-                info.dumped = true; // set marker of damped packet
-            }
+            dump(info);
             if((payload_len + len) > capacity())
             {
                 resize(payload_len + len);
@@ -105,6 +99,12 @@ public:
             payload_len += len;
         }
 
+        // packet with skipped payload is a part of message too
+        inline void skip_payload(const PacketInfo& info)
+        {
+            dump(info);
+        }
+
         inline void skip_first(const uint32_t /*len*/)
         {
         }
@@ -120,6 +120,20 @@ public:
         inline const uint8_t* data() const { return payload; }
         inline operator bool() const { return dumper != nullptr; }
     private:
+        inline void dump(const PacketInfo& info)
+        {
+            if(info.dumped) // if this packet not dumped yet
+            {
+                TRACE("The packet was collected before");
+            }
+            else
+            {
+                // direct dumping without waiting completeness of analysis and complete() call
+                dumper->dump(info.header, info.packet);
+                info.dumped = true; // set marker of damped packet
+            }
+        }
+
         Dumping* dumper{nullptr};
         uint32_t buff_size{cache_size};
         uint8_t* payload{cache};
@@ -137,6 +151,12 @@ public:
     Dumping(pcap_t* const h, const Params& params);
     ~Dumping();
 
+    // packets are dumped in order of reading, so they aren't tagged
+    inline void set_ordinal(uint64_t /*unused*/) {}
+
+    // nothing refers to closed session, it can be deleted at once
+    inline bool release(utils::NetworkSession* /*unused*/) { return true; }
+
     inline void dump(const pcap_pkthdr* header, const u_char* packet)
     {
         if(limit)
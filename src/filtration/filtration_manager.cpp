@@ -29,6 +29,8 @@
 #include "filtration/filtrators.h"
 #include "filtration/pcap/capture_reader.h"
 #include "filtration/pcap/file_reader.h"
+#include "filtration/pcap/mapped_file_reader.h"
+#include "filtration/pcap/ring_reader.h"
 #include "filtration/processing_thread.h"
 #include "filtration/queuing.h"
 //------------------------------------------------------------------------------
@@ -36,12 +38,15 @@ namespace NST
 {
 namespace filtration
 {
-using CaptureReader = NST::filtration::pcap::CaptureReader;
-using FileReader    = NST::filtration::pcap::FileReader;
+using CaptureReader    = NST::filtration::pcap::CaptureReader;
+using FileReader       = NST::filtration::pcap::FileReader;
+using MappedFileReader = NST::filtration::pcap::MappedFileReader;
+using RingReader       = NST::filtration::pcap::RingReader;
 
 using Parameters        = NST::controller::Parameters;
 using RunningStatus     = NST::controller::RunningStatus;
 using FilteredDataQueue = NST::utils::FilteredDataQueue;
+using OrderedQueues     = NST::utils::OrderedQueues;
 
 namespace // unnamed
 {
@@ -56,11 +61,12 @@ class FiltrationImpl final : public ProcessingThread
 public:
     explicit FiltrationImpl(std::unique_ptr<Reader>& reader,
                             std::unique_ptr<Writer>& writer,
-                            RunningStatus&           status)
+                            RunningStatus&           status,
+                            unsigned                 batch_size)
         : ProcessingThread{status}
         , processor{}
     {
-        processor.reset(new Processor{reader, writer});
+        processor.reset(new Processor{reader, writer, batch_size});
     }
     ~FiltrationImpl() = default;
 
@@ -91,45 +97,121 @@ template <
     typename Writer>
 static auto create_thread(std::unique_ptr<Reader>& reader,
                           std::unique_ptr<Writer>& writer,
-                          RunningStatus&           status)
+                          RunningStatus&           status,
+                          unsigned                 batch_size)
     -> std::unique_ptr<FiltrationImpl<Reader, Writer>>
 {
     using Thread = FiltrationImpl<Reader, Writer>;
 
-    return std::unique_ptr<Thread>{new Thread{reader, writer, status}};
+    return std::unique_ptr<Thread>{new Thread{reader, writer, status, batch_size}};
 }
 
-// create CaptureReader from Parameters emplaced in unique_ptr
-static auto create_capture_reader(const Parameters& params)
-    -> std::unique_ptr<CaptureReader>
+// FiltrationProcessors reading the same input in parallel threads, each of
+// them filters its own partition of sessions to its queue of OrderedQueues
+template <typename Reader>
+class PartitionedFiltrationImpl final : public ProcessingThread
 {
-    auto& capture_params = params.capture_params();
-    if(utils::Out message{}) // print parameters to user
+    using Processor = FiltrationProcessor<Reader, Queueing, Filtrators<Queueing>>;
+
+public:
+    explicit PartitionedFiltrationImpl(OrderedQueues& q, RunningStatus& status)
+        : ProcessingThread{status}
+        , queues(q)
     {
-        message << capture_params;
     }
-    return std::unique_ptr<CaptureReader>{new CaptureReader{capture_params}};
-}
+    ~PartitionedFiltrationImpl() = default;
+
+    void add(std::unique_ptr<Reader>& reader, unsigned batch_size)
+    {
+        const unsigned member = processors.size();
+
+        std::unique_ptr<Queueing> writer{new Queueing{queues.input(member)}};
+        processors.emplace_back(new Processor{reader, writer, batch_size, Partition{member, queues.size()}});
+    }
+
+    virtual void stop() override final
+    {
+        for(auto& processor : processors)
+        {
+            processor->stop();
+        }
+    }
+
+private:
+    virtual void run() override final
+    {
+        std::vector<std::thread> workers;
+        for(unsigned i = 0; i < processors.size(); ++i)
+        {
+            workers.emplace_back(&PartitionedFiltrationImpl::work, this, i);
+        }
+        for(auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        // filtration is done when all threads have read whole input
+        throw controller::ProcessingDone("Filtration is done");
+    }
+
+    void work(unsigned member)
+    {
+        try
+        {
+            processors[member]->run();
+        }
+        catch(const controller::ProcessingDone&)
+        {
+        }
+        catch(...)
+        {
+            ProcessingThread::status.push_current_exception();
+        }
+        queues.input(member).finish();
+    }
+
+    OrderedQueues&                          queues;
+    std::vector<std::unique_ptr<Processor>> processors;
+};
 
 } // unnamed namespace
 
 // capture from network interface and dump to file  - OnlineDumping(Dumping)
 void FiltrationManager::add_online_dumping(const Parameters& params)
 {
-    std::unique_ptr<CaptureReader> reader{create_capture_reader(params)};
+    utils::CPUPlacement placement{cpus};
 
-    auto& dumping_params = params.dumping_params();
+    const auto& capture_params = params.capture_params().front(); // only one interface
+    if(utils::Out message{}) // print parameters to user
+    {
+        message << capture_params;
+    }
+
+    const auto& dumping_params = params.dumping_params();
     if(utils::Out message{}) // print parameters to user
     {
         message << dumping_params;
     }
-    std::unique_ptr<Dumping> writer{new Dumping{reader->get_handle(), dumping_params}};
-    threads.emplace_back(create_thread(reader, writer, status));
+
+    if(capture_params.ring)
+    {
+        std::unique_ptr<RingReader> reader{new RingReader{capture_params}};
+        std::unique_ptr<Dumping>    writer{new Dumping{reader->get_handle(), dumping_params}};
+        threads.emplace_back(create_thread(reader, writer, status, params.batch_size()));
+    }
+    else
+    {
+        std::unique_ptr<CaptureReader> reader{new CaptureReader{capture_params}};
+        std::unique_ptr<Dumping>       writer{new Dumping{reader->get_handle(), dumping_params}};
+        threads.emplace_back(create_thread(reader, writer, status, params.batch_size()));
+    }
 }
 
 //capture data from input file or cin to destination file
 void FiltrationManager::add_offline_dumping(const Parameters& params)
 {
+    utils::CPUPlacement placement{cpus};
+
     auto& dumping_params = params.dumping_params();
     auto& ofile          = dumping_params.output_file;
     auto  ifile          = params.input_file();
@@ -147,49 +229,147 @@ void FiltrationManager::add_offline_dumping(const Parameters& params)
             }
         }
     }
-    std::unique_ptr<FileReader> reader{new FileReader{ifile}};
 
-    if(utils::Out message{}) // print parameters to user
+    // regular pcap/pcapng files are mapped, stdin and other formats are read by libpcap
+    if(MappedFileReader::is_supported(ifile))
     {
-        message << *reader;
+        std::unique_ptr<MappedFileReader> reader{new MappedFileReader{ifile}};
+        if(utils::Out message{}) // print parameters to user
+        {
+            message << *reader;
+        }
+        std::unique_ptr<Dumping> writer{new Dumping{reader->get_handle(),
+                                                    dumping_params}};
+
+        threads.emplace_back(create_thread(reader, writer, status, params.batch_size()));
     }
-    std::unique_ptr<Dumping> writer{new Dumping{reader->get_handle(),
-                                                dumping_params}};
+    else
+    {
+        std::unique_ptr<FileReader> reader{new FileReader{ifile}};
+        if(utils::Out message{}) // print parameters to user
+        {
+            message << *reader;
+        }
+        std::unique_ptr<Dumping> writer{new Dumping{reader->get_handle(),
+                                                    dumping_params}};
 
-    threads.emplace_back(create_thread(reader, writer, status));
+        threads.emplace_back(create_thread(reader, writer, status, params.batch_size()));
+    }
 }
 
 // capture from network interface and pass to queue - OnlineAnalysis(Profiling)
 void FiltrationManager::add_online_analysis(const Parameters&  params,
                                             FilteredDataQueue& queue)
 {
-    std::unique_ptr<CaptureReader> reader{create_capture_reader(params)};
-    std::unique_ptr<Queueing>      writer{new Queueing{queue}};
+    utils::CPUPlacement placement{cpus};
 
-    threads.emplace_back(create_thread(reader, writer, status));
+    // each interface is captured and filtered by own threads,
+    // all threads feed the same queue
+    for(const auto& capture_params : params.capture_params())
+    {
+        if(utils::Out message{}) // print parameters to user
+        {
+            message << capture_params;
+        }
+
+        if(capture_params.ring)
+        {
+            // each thread reads own ring of PACKET_FANOUT group and owns sessions hashed to it
+            for(unsigned member = 0; member < capture_params.fanout; ++member)
+            {
+                std::unique_ptr<RingReader> reader{new RingReader{capture_params, member}};
+                std::unique_ptr<Queueing>   writer{new Queueing{queue}};
+                threads.emplace_back(create_thread(reader, writer, status, params.batch_size()));
+            }
+        }
+        else
+        {
+            std::unique_ptr<CaptureReader> reader{new CaptureReader{capture_params}};
+            std::unique_ptr<Queueing>      writer{new Queueing{queue}};
+            threads.emplace_back(create_thread(reader, writer, status, params.batch_size()));
+        }
+    }
 }
 
 // read from file and pass to queue - OfflineAnalysis(Analysis)
-void FiltrationManager::add_offline_analysis(const std::string& ifile,
+void FiltrationManager::add_offline_analysis(const Parameters&  params,
                                              FilteredDataQueue& queue)
 {
-    std::unique_ptr<FileReader> reader{new FileReader{ifile}};
-    if(utils::Out message{}) // print parameters to user
+    utils::CPUPlacement placement{cpus};
+
+    const auto ifile = params.input_file();
+
+    // regular pcap/pcapng files are mapped, stdin and other formats are read by libpcap
+    if(MappedFileReader::is_supported(ifile))
     {
-        message << *reader;
+        std::unique_ptr<MappedFileReader> reader{new MappedFileReader{ifile}};
+        if(utils::Out message{}) // print parameters to user
+        {
+            message << *reader;
+        }
+        std::unique_ptr<Queueing> writer{new Queueing{queue}};
+
+        threads.emplace_back(create_thread(reader, writer, status, params.batch_size()));
+    }
+    else
+    {
+        std::unique_ptr<FileReader> reader{new FileReader{ifile}};
+        if(utils::Out message{}) // print parameters to user
+        {
+            message << *reader;
+        }
+        std::unique_ptr<Queueing> writer{new Queueing{queue}};
+
+        threads.emplace_back(create_thread(reader, writer, status, params.batch_size()));
+    }
+}
+
+// read from file by several threads and pass to queues merged in order of packets
+void FiltrationManager::add_offline_analysis(const Parameters& params,
+                                             OrderedQueues&    queues)
+{
+    utils::CPUPlacement placement{cpus};
+
+    const auto ifile = params.input_file();
+
+    // each thread maps the file and reads all packets, so the file must be regular
+    if(!MappedFileReader::is_supported(ifile))
+    {
+        throw std::runtime_error{"The jobs require uncompressed pcap or pcapng input file: " + ifile};
+    }
+
+    using Thread = PartitionedFiltrationImpl<MappedFileReader>;
+    std::unique_ptr<Thread> thread{new Thread{queues, status}};
+    for(unsigned i = 0; i < queues.size(); ++i)
+    {
+        std::unique_ptr<MappedFileReader> reader{new MappedFileReader{ifile}};
+        if(i == 0)
+        {
+            if(utils::Out message{}) // print parameters to user
+            {
+                message << *reader << "\n  filtered by " << queues.size() << " threads";
+            }
+        }
+        thread->add(reader, params.batch_size());
     }
-    std::unique_ptr<Queueing> writer{new Queueing{queue}};
 
-    threads.emplace_back(create_thread(reader, writer, status));
+    threads.emplace_back(std::move(thread));
 }
 
-FiltrationManager::FiltrationManager(RunningStatus& s)
+FiltrationManager::FiltrationManager(RunningStatus& s, const utils::CPUSet& c)
     : status(s)
+    , cpus{c}
 {
     if(utils::Out message{utils::Out::Level::All})
     {
         message << "Libpcap version: " << pcap::library_version();
     }
+    if(utils::Out message{}) // print placement of threads
+    {
+        const utils::CPUSet effective{cpus.effective()};
+        message << "Filtration threads are placed on CPUs: " << effective
+                << " (NUMA nodes: " << effective.nodes() << ')';
+    }
 }
 
 FiltrationManager::~FiltrationManager()
@@ -199,6 +379,7 @@ FiltrationManager::~FiltrationManager()
 
 void FiltrationManager::start()
 {
+    utils::CPUPlacement placement{cpus}; // threads inherit it
     for(auto& th : threads)
     {
         th->start();
@@ -27,8 +27,10 @@
 
 #include "controller/parameters.h"
 #include "controller/running_status.h"
+#include "utils/cpu_set.h"
 #include "utils/filtered_data.h"
 #include "utils/noncopyable.h"
+#include "utils/ordered_queues.h"
 //------------------------------------------------------------------------------
 namespace NST
 {
@@ -39,21 +41,25 @@ class FiltrationManager final : utils::noncopyable
     using Parameters        = NST::controller::Parameters;
     using RunningStatus     = NST::controller::RunningStatus;
     using FilteredDataQueue = NST::utils::FilteredDataQueue;
+    using OrderedQueues     = NST::utils::OrderedQueues;
 
 public:
-    FiltrationManager(RunningStatus&);
+    FiltrationManager(RunningStatus&, const utils::CPUSet& cpus);
     ~FiltrationManager();
 
     void add_online_dumping(const Parameters& params);                             // dump to file
     void add_offline_dumping(const Parameters& params);                            // dump to file from input file
     void add_online_analysis(const Parameters& params, FilteredDataQueue& queue);  // capture to queue
-    void add_offline_analysis(const std::string& ifile, FilteredDataQueue& queue); // read file to queue
+    void add_offline_analysis(const Parameters& params, FilteredDataQueue& queue); // read file to queue
+    void add_offline_analysis(const Parameters& params, OrderedQueues& queues);    // read file in parallel
 
     void start();
     void stop();
 
 private:
-    RunningStatus& status;
+    RunningStatus&      status;
+    const utils::CPUSet cpus; // of filtration threads, add_*() run under placement
+                              // on them, so buffers are allocated on their nodes
 
     std::vector<std::unique_ptr<class ProcessingThread>> threads;
 };
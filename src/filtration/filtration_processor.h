@@ -28,13 +28,17 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 
 #include <pcap/pcap.h>
 
 #include "controller/parameters.h"
+#include "controller/running_status.h"
+#include "filtration/defragmentation.h"
 #include "filtration/packet.h"
+#include "filtration/pcap/packet_batch.h"
 #include "filtration/sessions_hash.h"
 #include "protocols/nfs3/nfs3_utils.h"
 #include "protocols/nfs4/nfs4_utils.h"
@@ -67,7 +71,7 @@ template <typename Writer>
 struct UDPSession final : utils::noncopyable, public utils::NetworkSession
 {
 public:
-    UDPSession(Writer* w, uint32_t max_rpc_hdr)
+    UDPSession(Writer* w, uint32_t max_rpc_hdr, PacketPool& /*unused*/)
         : collection{w, this}
         , nfs3_rw_hdr_max{max_rpc_hdr}
     {
@@ -145,6 +149,8 @@ public:
         collection.complete(info);
     }
 
+    bool closed() const { return false; } // released by timeout only
+
     typename Writer::Collection collection;
     uint32_t                    nfs3_rw_hdr_max;
     MessageSet                  nfs3_read_match;
@@ -179,8 +185,9 @@ public:
             {
                 Packet* c = fragments;
                 fragments = c->next;
-                Packet::destroy(c);
+                Packet::destroy(c, *pool);
             }
+            last = nullptr;
 
             sequence = 0;
         }
@@ -257,97 +264,70 @@ public:
                 if(info.dlen > 0 && GT_SEQ(seq, sequence))
                 {
                     //TRACE("ADD FRAGMENT seq: %u dlen: %u sequence: %u", seq, info.dlen, sequence);
-                    fragments = Packet::create(info, fragments);
+                    insert(Packet::create(info, nullptr, *pool));
                 }
             }
         }
 
+        // fragments are ordered by sequence numbers, so only the first one
+        // may fit the stream or be acknowledged
         bool check_fragments(const uint32_t acknowledged)
         {
             Packet* current{fragments};
             if(current)
             {
-                Packet*  prev{nullptr};
-                uint32_t lowest_seq{current->tcp->seq()};
-                while(current)
-                {
-                    const uint32_t current_seq{current->tcp->seq()};
-                    const uint32_t current_len{current->dlen};
+                const uint32_t current_seq{current->seq};
+                const uint32_t current_len{current->dlen};
 
-                    if(GT_SEQ(lowest_seq, current_seq)) // lowest_seq > current_seq
+                if(LT_SEQ(current_seq, sequence)) // current_seq < sequence
+                {
+                    // this sequence number seems dated, but
+                    // check the end to make sure it has no more
+                    // info than we have already seen
+                    uint32_t newseq{current_seq + current_len};
+                    if(GT_SEQ(newseq, sequence))
                     {
-                        lowest_seq = current_seq;
-                    }
+                        // this one has more than we have seen. let's get the
+                        // payload that we have not seen. This happens when
+                        // part of this frame has been retransmitted
+                        uint32_t new_pos{sequence - current_seq};
 
-                    if(LT_SEQ(current_seq, sequence)) // current_seq < sequence
-                    {
-                        // this sequence number seems dated, but
-                        // check the end to make sure it has no more
-                        // info than we have already seen
-                        uint32_t newseq{current_seq + current_len};
-                        if(GT_SEQ(newseq, sequence))
-                        {
-                            // this one has more than we have seen. let's get the
-                            // payload that we have not seen. This happens when
-                            // part of this frame has been retransmitted
-                            uint32_t new_pos{sequence - current_seq};
-
-                            sequence += (current_len - new_pos);
-
-                            if(current->dlen > new_pos)
-                            {
-                                current->data += new_pos;
-                                current->dlen -= new_pos;
-                                reader.push(*current);
-                            }
-                        }
+                        sequence += (current_len - new_pos);
 
-                        // Remove the fragment from the list as the "new" part of it
-                        // has been processed or its data has been seen already in
-                        // another packet.
-                        if(prev)
+                        if(current->dlen > new_pos)
                         {
-                            prev->next = current->next;
-                        }
-                        else
-                        {
-                            fragments = current->next;
+                            current->data += new_pos;
+                            current->dlen -= new_pos;
+                            reader.push(*current);
                         }
+                    }
 
-                        Packet::destroy(current);
+                    // Remove the fragment from the list as the "new" part of it
+                    // has been processed or its data has been seen already in
+                    // another packet.
+                    remove_first();
 
-                        return true;
-                    }
+                    return true;
+                }
 
-                    if(EQ_SEQ(current_seq, sequence))
-                    {
-                        // this fragment fits the stream
-                        sequence += current_len;
-                        if(prev)
-                        {
-                            prev->next = current->next;
-                        }
-                        else
-                        {
-                            fragments = current->next;
-                        }
+                if(EQ_SEQ(current_seq, sequence))
+                {
+                    // this fragment fits the stream
+                    sequence += current_len;
 
-                        reader.push(*current);
-                        Packet::destroy(current);
+                    reader.push(*current);
+                    remove_first();
 
-                        return true;
-                    }
-                    prev    = current;
-                    current = current->next;
-                } // end while
+                    return true;
+                }
 
-                if(GT_SEQ(acknowledged, lowest_seq)) // acknowledged > lowest_seq
+                if(GT_SEQ(acknowledged, current_seq)) // acknowledged > lowest seq
                 {
-                    //TRACE("acknowledged(%u) > lowest_seq(%u) seq:%u", acknowledged, lowest_seq, sequence);
+                    //TRACE("acknowledged(%u) > lowest_seq(%u) seq:%u", acknowledged, current_seq, sequence);
                     // There are frames missing in the capture stream that were seen
                     // by the receiving host. Inform stream about it.
-                    reader.lost(lowest_seq - sequence);
-                    sequence = lowest_seq;
+                    reader.lost(current_seq - sequence);
+                    sequence = current_seq;
                     return true;
                 }
             }
@@ -356,16 +336,53 @@ public:
         }
 
     private:
-        StreamReader reader;    // reader of acknowledged data stream
-        Packet*      fragments{nullptr}; // list of not yet acked fragments
+        // insert fragment in order of sequence numbers, before fragments
+        // with the same number. Usually segments after a lost one are
+        // appended to the end.
+        void insert(Packet* fragment)
+        {
+            if(last && GT_SEQ(fragment->seq, last->seq))
+            {
+                fragment->next = nullptr;
+                last->next     = fragment;
+                last           = fragment;
+                return;
+            }
+
+            Packet** link{&fragments};
+            while(*link && LT_SEQ((*link)->seq, fragment->seq))
+            {
+                link = &(*link)->next;
+            }
+            fragment->next = *link;
+            *link          = fragment;
+            if(!fragment->next) last = fragment;
+        }
+
+        void remove_first()
+        {
+            Packet* first{fragments};
+            fragments = first->next;
+            if(!fragments) last = nullptr;
+            Packet::destroy(first, *pool);
+        }
+
+        StreamReader reader;             // reader of acknowledged data stream
+        Packet*      fragments{nullptr}; // not yet acked fragments ordered by seq
+        Packet*      last{nullptr};      // fragment with the highest seq
         uint32_t     sequence{0};
+        PacketPool*  pool{nullptr};      // of filtration thread for fragments
     };
 
     template <typename Writer>
-    TCPSession(Writer* w, uint32_t max_rpc_hdr)
+    TCPSession(Writer* w, uint32_t max_rpc_hdr, PacketPool& pool)
     {
         flows[0].reader.set_writer(this, w, max_rpc_hdr);
         flows[1].reader.set_writer(this, w, max_rpc_hdr);
+        flows[0].reader.set_peer(flows[1].reader);
+        flows[1].reader.set_peer(flows[0].reader);
+        flows[0].pool = &pool;
+        flows[1].pool = &pool;
     }
 
     void collect(PacketInfo& info)
@@ -377,9 +394,32 @@ public:
             ;
 
         flows[info.direction].reassemble(info);
+
+        if(info.tcp->is(tcp_header::RST))
+        {
+            reset = true;
+        }
+        else if(info.tcp->is(tcp_header::FIN))
+        {
+            fin[info.direction] = true;
+        }
     }
 
+    // both sides have finished or connection was reset
+    bool closed() const { return reset || (fin[0] && fin[1]); }
+
     Flow flows[2];
+    bool fin[2]{false, false};
+    bool reset{false};
+};
+
+// Share of sessions filtered by one of processors reading the same input
+// in parallel. Both directions of a session have the same hash of addresses
+// and ports, so whole session is filtered by one processor.
+struct Partition
+{
+    unsigned member;  // index of processor
+    unsigned members; // number of processors
 };
 
 template <
@@ -388,32 +428,73 @@ template <
     typename Filtrator>
 class FiltrationProcessor final : utils::noncopyable
 {
+    using PacketBatch = NST::filtration::pcap::PacketBatch;
+
+    // sessions hash which packet is dispatched to
+    enum class Route
+    {
+        None,
+        IPv4TCP,
+        IPv4UDP,
+        IPv6TCP,
+        IPv6UDP,
+    };
+
+    // result of parsing packet and lookup of its session in batch
+    struct Lookup
+    {
+        Route          route;
+        std::size_t    hash; // of canonical key
+        utils::Session key;
+        void*          session; // nullptr if session wasn't found
+    };
+
+    using PacketInfoStorage = typename std::aligned_storage<sizeof(PacketInfo), alignof(PacketInfo)>::type;
+
 public:
     explicit FiltrationProcessor(std::unique_ptr<Reader>& r,
-                                 std::unique_ptr<Writer>& w)
+                                 std::unique_ptr<Writer>& w,
+                                 unsigned                 batch_size = 1,
+                                 Partition                p          = Partition{0, 1})
         : reader{std::move(r)}
         , writer{std::move(w)}
-        , ipv4_tcp_sessions{writer.get()}
-        , ipv4_udp_sessions{writer.get()}
-        , ipv6_tcp_sessions{writer.get()}
-        , ipv6_udp_sessions{writer.get()}
+        , pool{Writer::whole_frames}
+        , ipv4_tcp_sessions{writer.get(), pool}
+        , ipv4_udp_sessions{writer.get(), pool}
+        , ipv6_tcp_sessions{writer.get(), pool}
+        , ipv6_udp_sessions{writer.get(), pool}
+        , partition(p)
+        , packets{0}
     {
         // check datalink layer
         datalink = reader->datalink();
-        if(datalink != DLT_EN10MB)
+        if(datalink != DLT_EN10MB && datalink != DLT_LINUX_SLL)
         {
             throw std::runtime_error(std::string("Unsupported Data Link Layer: ") + Reader::datalink_description(datalink));
         }
+        tsunit = reader->tstamp_unit();
+
+        if(batch_size > 1)
+        {
+            // buffer for copies of libpcap packets, unused by in place readers
+            batch.reset(new PacketBatch{batch_size, batch_size * 2048 + 262144 /*max snaplen*/});
+            infos.reset(new PacketInfoStorage[batch_size]);
+            lookups.reset(new Lookup[batch_size]);
+        }
     }
     ~FiltrationProcessor()
     {
         utils::Out message;
         reader->print_statistic(message);
+        encapsulations.print_statistic(message);
+        defragmentation.print_statistic(message);
+        print_evictions(message);
     }
 
     void run()
     {
-        bool done{reader->loop(this, callback)};
+        bool done{batch ? reader->loop(this, batch_callback, *batch)
+                        : reader->loop(this, callback)};
         if(done)
         {
             throw controller::ProcessingDone("Filtration is done");
@@ -430,55 +511,271 @@ public:
         PROF; // Calc how much time was spent in this func
         auto processor = reinterpret_cast<FiltrationProcessor*>(user);
 
-        PacketInfo info(pkthdr, packet, processor->datalink);
+        PacketInfo info(pkthdr, packet, processor->datalink, processor->tsunit);
+        info.pin = processor->reader->pin();
 
-        if(info.tcp)
+        processor->encapsulations.account(info);
+        processor->expire(info.timestamp);
+        processor->writer->set_ordinal(processor->packets++);
+        if(info.fragment)
         {
-            if(pkthdr->caplen != pkthdr->len)
+            processor->reassemble(info);
+            return;
+        }
+
+        const Route r{processor->own(info, route(info))};
+        processor->collect(info, r, nullptr);
+    }
+
+    // Batch is handled in four passes: parse headers of all packets, hash
+    // their keys and prefetch slots of hash tables, probe the slots and
+    // prefetch found sessions, then reassemble packets in order.
+    // So lookups of sessions aren't serialized by reassembly of packets.
+    static void batch_callback(u_char* user, PacketBatch& batch)
+    {
+        PROF; // Calc how much time was spent in this func
+        auto processor = reinterpret_cast<FiltrationProcessor*>(user);
+
+        const unsigned       count{batch.size()};
+        PacketInfo*          infos{reinterpret_cast<PacketInfo*>(processor->infos.get())};
+        Lookup*              lookups{processor->lookups.get()};
+        utils::PinnedBuffer* pin{processor->reader->pin()}; // nullptr if batch keeps copies
+
+        for(unsigned i = 0; i < count; ++i)
+        {
+            if(i + 1 < count)
             {
-                LOGONCE(
-                    "pcap packet was truncated by snaplen option this "
-                    "packed won't correclty reassembled to TCP stream");
-                return;
+                __builtin_prefetch(batch[i + 1].packet);
             }
+            ::new(&infos[i]) PacketInfo(&batch[i].header, batch[i].packet, processor->datalink, processor->tsunit);
+            infos[i].pin = pin;
+            processor->encapsulations.account(infos[i]);
+        }
 
-            if(info.ipv4) // Ethernet:IPv4:TCP
+        // sessions are released before lookups, which keep pointers to them
+        if(count) processor->expire(infos[0].timestamp);
+
+        for(unsigned i = 0; i < count; ++i)
+        {
+            Lookup& lookup = lookups[i];
+            lookup.route   = Route::None;
+            if(infos[i].fragment) continue; // its datagram is looked up after reassembly
+
+            const Route r{route(infos[i])};
+            if(r == Route::None) continue;
+
+            lookup.hash  = hash_key(infos[i], r, lookup.key);
+            lookup.route = processor->own(r, lookup.hash);
+            processor->prefetch_bucket(lookup.route, lookup.hash);
+        }
+
+        for(unsigned i = 0; i < count; ++i)
+        {
+            Lookup& lookup = lookups[i];
+            lookup.session = processor->prefetch(lookup.route, lookup.key, lookup.hash);
+        }
+
+        for(unsigned i = 0; i < count; ++i)
+        {
+            processor->writer->set_ordinal(processor->packets++);
+            if(infos[i].fragment)
             {
-                return processor->ipv4_tcp_sessions.collect_packet(info);
+                processor->reassemble(infos[i]);
             }
-            else if(info.ipv6) // Ethernet:IPv6:TCP
+            else
             {
-                return processor->ipv6_tcp_sessions.collect_packet(info);
+                processor->collect(infos[i], lookups[i].route, lookups[i].session);
             }
+            infos[i].~PacketInfo();
         }
-        else if(info.udp)
+    }
+
+private:
+    static Route route(const PacketInfo& info)
+    {
+        if(info.tcp)
         {
-            if(info.ipv4) // Ethernet:IPv4:UDP
-            {
-                return processor->ipv4_udp_sessions.collect_packet(info);
-            }
-            else if(info.ipv6) // Ethernet:IPv6:UDP
+            if(info.header->caplen != info.header->len)
             {
-                return processor->ipv6_udp_sessions.collect_packet(info);
+                LOGONCE(
+                    "pcap packet was truncated by snaplen option this "
+                    "packed won't correclty reassembled to TCP stream");
+                return Route::None;
             }
+
+            if(info.ipv4) return Route::IPv4TCP; // Ethernet:IPv4:TCP
+            if(info.ipv6) return Route::IPv6TCP; // Ethernet:IPv6:TCP
+        }
+        else if(info.udp)
+        {
+            if(info.ipv4) return Route::IPv4UDP; // Ethernet:IPv4:UDP
+            if(info.ipv6) return Route::IPv6UDP; // Ethernet:IPv6:UDP
         }
 
         LOGONCE(
             "only following stack of protocol is supported: "
-            "Ethernet II:IPv4|IPv6(except additional fragments):TCP|UDP");
+            "Ethernet II|Linux cooked:[VLAN]:IPv4|IPv6:TCP|UDP, "
+            "GRE, ERSPAN and VXLAN tunnels are decapsulated");
+        return Route::None;
+    }
+
+    // fill canonical key of session of packet, return its hash
+    static std::size_t hash_key(PacketInfo& info, Route route, utils::Session& key)
+    {
+        switch(route)
+        {
+        case Route::IPv4TCP:
+            IPv4TCPMapper::fill_hash_key(info, key);
+            return IPv4TCPMapper::KeyHash{}(key);
+        case Route::IPv4UDP:
+            IPv4UDPMapper::fill_hash_key(info, key);
+            return IPv4UDPMapper::KeyHash{}(key);
+        case Route::IPv6TCP:
+            IPv6TCPMapper::fill_hash_key(info, key);
+            return IPv6TCPMapper::KeyHash{}(key);
+        case Route::IPv6UDP:
+            IPv6UDPMapper::fill_hash_key(info, key);
+            return IPv6UDPMapper::KeyHash{}(key);
+        case Route::None:
+            break;
+        }
+        return 0;
+    }
+
+    // drop packet of session filtered by other processor
+    Route own(PacketInfo& info, Route route) const
+    {
+        if(partition.members == 1 || route == Route::None) return route;
+
+        utils::Session key;
+        return own(route, hash_key(info, route, key));
+    }
+
+    Route own(Route route, std::size_t hash) const
+    {
+        if(partition.members == 1 || route == Route::None) return route;
+
+        // CRC32C hash of canonical key is mapped to members by multiplicative spread
+        const uint64_t spread{(uint64_t(hash) * 0x9e3779b97f4a7c15ull) >> 32};
+        return (spread % partition.members) == partition.member ? route : Route::None;
+    }
+
+    void prefetch_bucket(Route route, std::size_t hash) const
+    {
+        switch(route)
+        {
+        case Route::IPv4TCP:
+            return ipv4_tcp_sessions.prefetch_bucket(hash);
+        case Route::IPv4UDP:
+            return ipv4_udp_sessions.prefetch_bucket(hash);
+        case Route::IPv6TCP:
+            return ipv6_tcp_sessions.prefetch_bucket(hash);
+        case Route::IPv6UDP:
+            return ipv6_udp_sessions.prefetch_bucket(hash);
+        case Route::None:
+            break;
+        }
+    }
+
+    void* prefetch(Route route, const utils::Session& key, std::size_t hash) const
+    {
+        switch(route)
+        {
+        case Route::IPv4TCP:
+            return ipv4_tcp_sessions.prefetch(key, hash);
+        case Route::IPv4UDP:
+            return ipv4_udp_sessions.prefetch(key, hash);
+        case Route::IPv6TCP:
+            return ipv6_tcp_sessions.prefetch(key, hash);
+        case Route::IPv6UDP:
+            return ipv6_udp_sessions.prefetch(key, hash);
+        case Route::None:
+            break;
+        }
+        return nullptr;
+    }
+
+    void expire(uint64_t now)
+    {
+        ipv4_tcp_sessions.expire(now);
+        ipv4_udp_sessions.expire(now);
+        ipv6_tcp_sessions.expire(now);
+        ipv6_udp_sessions.expire(now);
+    }
+
+    void print_evictions(std::ostream& out) const
+    {
+        const Evictions* hashes[]{
+            &ipv4_tcp_sessions.evicted(),
+            &ipv4_udp_sessions.evicted(),
+            &ipv6_tcp_sessions.evicted(),
+            &ipv6_udp_sessions.evicted(),
+        };
+
+        Evictions total;
+        for(auto e : hashes)
+        {
+            total.idle += e->idle;
+            total.closed += e->closed;
+        }
+        if(total.idle || total.closed)
+        {
+            out << "Released sessions: " << total.idle << " idle, "
+                << total.closed << " closed by FIN or RST\n";
+        }
+    }
+
+    // filter datagram if fragment completes it
+    void reassemble(const PacketInfo& fragment)
+    {
+        if(auto datagram = defragmentation.add(fragment))
+        {
+            PacketInfo info(&datagram->header, datagram->frame, datagram->ip, fragment.timestamp);
+            collect(info, own(info, route(info)), nullptr);
+        }
+    }
+
+    void collect(PacketInfo& info, Route route, void* session)
+    {
+        switch(route)
+        {
+        case Route::IPv4TCP:
+            return ipv4_tcp_sessions.collect_packet(info, session);
+        case Route::IPv4UDP:
+            return ipv4_udp_sessions.collect_packet(info, session);
+        case Route::IPv6TCP:
+            return ipv6_tcp_sessions.collect_packet(info, session);
+        case Route::IPv6UDP:
+            return ipv6_udp_sessions.collect_packet(info, session);
+        case Route::None:
+            break;
+        }
     }
 
-private:
     std::unique_ptr<Reader> reader;
     std::unique_ptr<Writer> writer;
 
+    PacketPool pool; // out-of-order TCP segments, outlives sessions
+
     SessionsHash<IPv4TCPMapper, TCPSession<Filtrator>, Writer> ipv4_tcp_sessions;
     SessionsHash<IPv4UDPMapper, UDPSession<Writer>, Writer>    ipv4_udp_sessions;
 
     SessionsHash<IPv6TCPMapper, TCPSession<Filtrator>, Writer> ipv6_tcp_sessions;
     SessionsHash<IPv6UDPMapper, UDPSession<Writer>, Writer>    ipv6_udp_sessions;
 
-    int datalink;
+    int      datalink;
+    uint32_t tsunit; // nanoseconds in unit of timestamps of packets
+
+    Encapsulations  encapsulations;
+    Defragmentation defragmentation;
+
+    const Partition partition;
+    uint64_t        packets; // number of read packets
+
+    // state of batch processing, allocated if batch size > 1
+    std::unique_ptr<PacketBatch>         batch;
+    std::unique_ptr<PacketInfoStorage[]> infos;
+    std::unique_ptr<Lookup[]>            lookups;
 };
 
 } // namespace filtration
@@ -23,6 +23,8 @@
 #ifndef IFILTRATOR_H
 #define IFILTRATOR_H
 //------------------------------------------------------------------------------
+#include <algorithm>
+
 #include "filtration/packet.h"
 #include "utils/log.h"
 #include "utils/noncopyable.h"
@@ -41,6 +43,9 @@ class FiltratorImpl : utils::noncopyable
 {
     size_t msg_len;                                 //!< length of current message
     size_t to_be_copied;                            //!<  length of readable piece of message. Initially msg_len or 0 in case of unknown msg
+    size_t to_be_skipped;                           //!< length of payload inside of message skipped before the rest of readable piece
+    size_t parts;                                   //!< number of queued parts of current message
+    bool   cut;                                     //!< current part of message is complete after skipped payload
     using Collection = typename Writer::Collection; //!< Type of collection
     Collection collection;                          //!< storage for collection packet data
 
@@ -62,8 +67,11 @@ public:
      */
     inline void reset()
     {
-        msg_len      = 0;
-        to_be_copied = 0;
+        msg_len       = 0;
+        to_be_copied  = 0;
+        to_be_skipped = 0;
+        parts         = 0;
+        cut           = false;
         collection.reset();
     }
 
@@ -124,7 +132,13 @@ public:
         Filtrator* filtrator = static_cast<Filtrator*>(this);
         if(msg_len != 0)
         {
-            if(to_be_copied == 0 && msg_len >= n)
+            if(to_be_skipped > n)
+            {
+                TRACE("We are lost %u bytes of payload inside of message", n);
+                to_be_skipped -= n;
+                msg_len -= n;
+            }
+            else if(to_be_copied == 0 && to_be_skipped == 0 && msg_len >= n)
             {
                 TRACE("We are lost %u bytes of payload marked for discard", n);
                 msg_len -= n;
@@ -154,29 +168,53 @@ public:
         {
             if(msg_len) // we are on-stream and we are looking to some message
             {
-                if(to_be_copied)
+                if(to_be_copied || to_be_skipped)
                 {
-                    // hdr_len != 0, readout a part of header of current message
-                    if(to_be_copied > info.dlen) // got new part of header (not the all!)
+                    if(to_be_skipped)
                     {
-                        //TRACE("got new part of header (not the all!)");
-                        collection.push(info, info.dlen);
-                        to_be_copied -= info.dlen;
-                        msg_len -= info.dlen;
-                        info.dlen = 0; // return from while
+                        // discard payload inside of message, the rest will be read out
+                        const size_t n{std::min(to_be_skipped, size_t{info.dlen})};
+                        collection.skip_payload(info);
+                        to_be_skipped -= n;
+                        msg_len -= n;
+                        info.dlen -= n;
+                        info.data += n;
                     }
-                    else // hdr_len <= dlen, current message will be complete, also we have some additional data
+                    else
                     {
-                        //TRACE("current message will be complete, also we have some additional data");
-                        collection.push(info, to_be_copied);
-                        info.dlen -= to_be_copied;
-                        info.data += to_be_copied;
+                        // hdr_len != 0, readout a part of header of current message,
+                        // filtrator may find payload which should be skipped after it
+                        // or the end of part of message, the rest is the next part
+                        size_t       payload{0};
+                        const size_t n{filtrator->scan(info.data, std::min(to_be_copied, size_t{info.dlen}), payload, cut)};
+                        collection.push(info, n);
+                        info.dlen -= n;
+                        info.data += n;
+                        msg_len -= n;
+                        to_be_copied -= n;
 
-                        msg_len -= to_be_copied;
-                        to_be_copied = 0;
+                        if(payload)
+                        {
+                            to_be_skipped = std::min(payload, msg_len);
+                            to_be_copied -= std::min(payload, to_be_copied);
+                        }
+                    }
 
-                        collection.skip_first(Filtrator::lengthOfFirstSkipedPart());
+                    // message is complete after its payload, so it is timestamped
+                    // as well as it is copied; also we may have some additional data
+                    if(0 == to_be_skipped && (0 == to_be_copied || cut))
+                    {
+                        if(0 == parts++) // only the first part has header of record
+                        {
+                            collection.skip_first(Filtrator::lengthOfFirstSkipedPart());
+                        }
                         collection.complete(info); // push complete message to queue
+
+                        if(to_be_copied) // the next part of message is read out
+                        {
+                            cut = false;
+                            collection.allocate();
+                        }
                     }
                 }
                 else
@@ -234,6 +272,19 @@ public:
     }
 
 protected:
+    /*!
+     * Scans readable piece of message, by default nothing is skipped
+     * \param data - bytes of message
+     * \param len - length of bytes
+     * \param payload - length of payload to skip after scanned bytes
+     * \param cut - set if the part of message is complete after payload, the rest is queued as the next part
+     * \return number of scanned bytes
+     */
+    inline size_t scan(const uint8_t* /*data*/, size_t len, size_t& /*payload*/, bool& /*cut*/)
+    {
+        return len;
+    }
+
     inline void setMsgLen(size_t value)
     {
         msg_len = value;
@@ -292,6 +343,15 @@ protected:
         return true;
     }
 
+    // skip message of len bytes following collected data, nothing is queued
+    inline bool skip_message(size_t len)
+    {
+        msg_len      = len;
+        to_be_copied = 0;
+        collection.reset();
+        return true;
+    }
+
     inline bool read_message(PacketInfo& info)
     {
         assert(msg_len != 0); // message is found
@@ -300,6 +360,8 @@ protected:
         Filtrator* filtrator = static_cast<Filtrator*>(this);
 
         const size_t written{collection.data_size()};
+        parts = 0;
+        cut   = false;
         msg_len -= written; // substract how written (if written)
         to_be_copied -= std::min(to_be_copied, written);
         if(0 == to_be_copied) // Avoid infinity loop when "msg len" == "data size(collection) (max_header)" {msg_len >= hdr_len}
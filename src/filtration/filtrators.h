@@ -77,6 +77,15 @@ public:
         filtratorRPC.set_writer(session_ptr, w, max_rpc_hdr);
     }
 
+    /*!
+     * Sets filtrators of opposite direction of the same session
+     * \param peer - filtrators of opposite direction
+     */
+    inline void set_peer(Filtrators& peer)
+    {
+        filtratorRPC.set_peer(peer.filtratorRPC);
+    }
+
     inline void lost(const uint32_t n) // we are lost n bytes in sequence
     {
         filtratorCIFS.lost(n);
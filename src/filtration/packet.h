@@ -24,15 +24,22 @@
 //------------------------------------------------------------------------------
 #include <algorithm> // for std::min()
 #include <cassert>
+#include <cstdlib> // for posix_memalign()
 #include <cstring> // for memcpy()
+#include <new>     // for std::bad_alloc
+#include <ostream>
 
 #include <pcap/pcap.h>
 
 #include "protocols/ethernet/ethernet_header.h"
+#include "protocols/gre/gre_header.h"
 #include "protocols/ip/ip_header.h"
 #include "protocols/tcp/tcp_header.h"
 #include "protocols/udp/udp_header.h"
+#include "protocols/vxlan/vxlan_header.h"
+#include "utils/block_allocator.h"
 #include "utils/noncopyable.h"
+#include "utils/pinned_buffer.h"
 #include "utils/sessions.h"
 //------------------------------------------------------------------------------
 namespace NST
@@ -41,15 +48,30 @@ namespace filtration
 {
 using namespace NST::protocols;
 using namespace NST::protocols::ethernet;
+using namespace NST::protocols::gre;
 using namespace NST::protocols::ip;
 using namespace NST::protocols::tcp;
 using namespace NST::protocols::udp;
+using namespace NST::protocols::vxlan;
 
 // Structure of pointers to captured pcap packet's headers. WITHOUT data.
 struct PacketInfo : utils::noncopyable
 {
     using Direction = NST::utils::Session::Direction;
 
+    // encapsulations peeled off from captured packet
+    enum Encapsulation : uint8_t
+    {
+        VLAN   = 0x01, // IEEE 802.1Q tag
+        QINQ   = 0x02, // IEEE 802.1ad or pre-standard service tag
+        GRE    = 0x04, // GRE tunnel
+        ERSPAN = 0x08, // ERSPAN session inside GRE
+        VXLAN  = 0x10, // VXLAN tunnel inside UDP
+        NESTED = 0x80  // nesting deeper than max_depth, packet is skipped
+    };
+
+    static const uint32_t max_depth{8}; // of peeled encapsulations
+
     class Dumped // marker of dumped packet
     {
         friend class Dumping;
@@ -69,9 +91,14 @@ struct PacketInfo : utils::noncopyable
 
     inline PacketInfo(const pcap_pkthdr* h,
                       const uint8_t*     p,
-                      const uint32_t     datalink)
+                      const uint32_t     datalink,
+                      const uint32_t     tsunit = 1000) // nanoseconds in unit of h->ts.tv_usec
         : header{h}
         , packet{p}
+        , timestamp{uint64_t(h->ts.tv_sec) * 1000000000 + uint64_t(h->ts.tv_usec) * tsunit}
+        , fragment{nullptr}
+        , encapsulation{0}
+        , depth{0}
         , eth{nullptr}
         , ipv4{nullptr}
         , ipv6{nullptr}
@@ -79,6 +106,7 @@ struct PacketInfo : utils::noncopyable
         , udp{nullptr}
         , data{packet}
         , dlen{header->caplen}
+        , pin{nullptr}
         , direction{Direction::Unknown}
         , dumped{}
     {
@@ -92,6 +120,38 @@ struct PacketInfo : utils::noncopyable
             break;
         }
     }
+
+    // IP datagram reassembled from fragments, its IP header is at ip in frame
+    inline PacketInfo(const pcap_pkthdr* h,
+                      const uint8_t*     p,
+                      const uint8_t*     ip,
+                      const uint64_t     ts)
+        : header{h}
+        , packet{p}
+        , timestamp{ts}
+        , fragment{nullptr}
+        , encapsulation{0}
+        , depth{0}
+        , eth{nullptr}
+        , ipv4{nullptr}
+        , ipv6{nullptr}
+        , tcp{nullptr}
+        , udp{nullptr}
+        , data{ip}
+        , dlen{header->caplen - uint32_t(ip - packet)}
+        , pin{nullptr}
+        , direction{Direction::Unknown}
+        , dumped{}
+    {
+        if((*ip >> 4) == 4)
+        {
+            check_ipv4();
+        }
+        else
+        {
+            check_ipv6();
+        }
+    }
     void* operator new(size_t)               = delete; // only on stack
     void* operator new[](size_t)             = delete; // only on stack
     void operator delete(void*)              = delete; // only on stack
@@ -105,24 +165,53 @@ struct PacketInfo : utils::noncopyable
         data += sizeof(EthernetHeader);
         dlen -= sizeof(EthernetHeader);
 
-        switch(header->type())
-        {
-        case ethernet_header::IP:
-            check_ipv4();
-            break;
-        case ethernet_header::IPV6:
-            check_ipv6();
-            break;
-        default:
-            return;
-        }
-
         eth = header;
+        check_ethertype(header->type());
     }
 
     inline void check_sll()
     {
-        // TODO: add support Linux cooked sockets
+        if(dlen < sizeof(SLLHeader)) return;
+        auto header = reinterpret_cast<const SLLHeader*>(data);
+
+        data += sizeof(SLLHeader);
+        dlen -= sizeof(SLLHeader);
+
+        check_ethertype(header->type());
+    }
+
+    // dispatch payload of Ethernet or Linux cooked header, VLAN tags are peeled
+    inline void check_ethertype(uint16_t type)
+    {
+        for(;;)
+        {
+            switch(type)
+            {
+            case ethernet_header::IP:
+                check_ipv4();
+                return;
+            case ethernet_header::IPV6:
+                check_ipv6();
+                return;
+            case ethernet_header::VLAN:
+                if(!decapsulate(VLAN)) return;
+                break;
+            case ethernet_header::QINQ:
+            case ethernet_header::QINQ_9100:
+                if(!decapsulate(QINQ)) return;
+                break;
+            default:
+                return;
+            }
+
+            if(dlen < sizeof(VLANHeader)) return;
+            auto tag = reinterpret_cast<const VLANHeader*>(data);
+
+            data += sizeof(VLANHeader);
+            dlen -= sizeof(VLANHeader);
+
+            type = tag->type();
+        }
     }
 
     inline void check_ipv4() __attribute__((always_inline))
@@ -132,17 +221,12 @@ struct PacketInfo : utils::noncopyable
 
         if(header->version() != 4) return;
 
-        /*
-            IP packet may be fragmented by NIC or snaplen parameter of libpcap
-            IP is fragmented AND it is first part of original (offset == 0)
-            - Ok, pass it.
-
-            IP is fragmented AND it is not first part of it (offset != 0)
-             - DISCARD IT! We do not reassemble fragmented IP packets at all
-        */
-        if(header->is_fragmented_and_not_the_first_part())
+        // fragments are passed to Defragmentation and filtered after
+        // reassembly of whole datagram
+        if(header->is_fragmented())
         {
-            return; // discard tail of fragmented ip packets
+            fragment = data;
+            return;
         }
 
         const uint32_t ihl = header->ihl();
@@ -152,19 +236,24 @@ struct PacketInfo : utils::noncopyable
         data += ihl;
         dlen = (std::min((uint16_t)dlen, header->length())) - ihl; // trunk data to length of IP packet
 
+        // header is set before transport layer, because tunnel inside UDP
+        // resets it to inner one
         switch(header->protocol())
         {
         case ip::NextProtocol::TCP:
+            ipv4 = header;
             check_tcp();
             break;
         case ip::NextProtocol::UDP:
+            ipv4 = header;
             check_udp();
             break;
+        case ip::NextProtocol::GRE:
+            check_gre();
+            break;
         default:
             return;
         }
-
-        ipv4 = header;
     }
 
     inline void check_ipv6() __attribute__((always_inline))
@@ -188,16 +277,21 @@ struct PacketInfo : utils::noncopyable
         switch(htype)
         {
         case ip::NextProtocol::TCP:
+            ipv6 = header;
             check_tcp();
             break;
         case ip::NextProtocol::UDP:
+            ipv6 = header;
             check_udp();
             break;
+        case ip::NextProtocol::GRE:
+            check_gre();
+            break;
 
         case ip::NextProtocol::HOPOPTS:
         {
             auto               hbh = reinterpret_cast<const ipv6_hbh*>(data);
-            const unsigned int size{1U + hbh->hbh_len};
+            const unsigned int size{(1U + hbh->hbh_len) * 8};
 
             if(dlen < size) return; // truncated packet
 
@@ -211,7 +305,7 @@ struct PacketInfo : utils::noncopyable
         case ip::NextProtocol::DSTOPTS:
         {
             auto               dest = reinterpret_cast<const ipv6_dest*>(data);
-            const unsigned int size{1U + dest->dest_len};
+            const unsigned int size{(1U + dest->dest_len) * 8};
 
             if(dlen < size) return; // truncated packet
 
@@ -225,7 +319,7 @@ struct PacketInfo : utils::noncopyable
         case ip::NextProtocol::ROUTING:
         {
             auto               route = reinterpret_cast<const ipv6_route*>(data);
-            const unsigned int size{1U + route->route_len};
+            const unsigned int size{(1U + route->route_len) * 8};
 
             if(dlen < size) return; // truncated packet
 
@@ -240,13 +334,18 @@ struct PacketInfo : utils::noncopyable
         {
             auto frag = reinterpret_cast<const ipv6_frag*>(data);
 
-            // isn't first fragment (offset != 0)
-            if((ntohs(frag->frag_offlg) & ipv6_frag::OFFSET) != 0) return;
-
             const unsigned int size{sizeof(ipv6_frag)};
 
             if(dlen < size) return; // truncated packet
 
+            // fragments are passed to Defragmentation, atomic fragment
+            // (offset 0 without more fragments) is handled as is
+            if(ntohs(frag->frag_offlg) & (ipv6_frag::OFFSET | ipv6_frag::MORE))
+            {
+                fragment = reinterpret_cast<const uint8_t*>(header);
+                return;
+            }
+
             data += size;
             dlen -= size;
 
@@ -257,8 +356,6 @@ struct PacketInfo : utils::noncopyable
         default: // unknown header
             return;
         }
-
-        ipv6 = header;
     }
 
     inline void check_tcp() __attribute__((always_inline))
@@ -289,12 +386,111 @@ struct PacketInfo : utils::noncopyable
         data += sizeof(UDPHeader);
         dlen -= sizeof(UDPHeader);
 
+        if(header->dport() == htons(vxlan_header::PORT))
+        {
+            check_vxlan();
+            return;
+        }
+
         udp = header;
     }
 
+    // tunnels are rare, so they are kept out of line of fast path
+
+    __attribute__((noinline)) void check_gre()
+    {
+        if(dlen < sizeof(GREHeader)) return;
+        auto header = reinterpret_cast<const GREHeader*>(data);
+
+        if(header->version() != 0) return;                // enhanced GRE of PPTP
+        if(header->flags() & gre_header::ROUTING) return; // deprecated source routing
+
+        const uint32_t length{header->length()};
+        if(dlen < length) return; // truncated packet
+
+        data += length;
+        dlen -= length;
+
+        if(!tunnel(GRE)) return;
+
+        switch(header->protocol())
+        {
+        case ethernet_header::IP:
+            check_ipv4();
+            break;
+        case ethernet_header::IPV6:
+            check_ipv6();
+            break;
+        case ethernet_header::TEB:
+            check_eth();
+            break;
+        case ethernet_header::ERSPAN:
+        case ethernet_header::ERSPAN3:
+            if(!decapsulate(ERSPAN)) return;
+
+            // Type I has neither sequence number nor ERSPAN header
+            if(header->protocol() == ethernet_header::ERSPAN3 ||
+               (header->flags() & gre_header::SEQUENCE))
+            {
+                if(dlen < sizeof(erspan2_header)) return;
+                auto erspan = reinterpret_cast<const ERSPANHeader*>(data);
+
+                if(erspan->version() != 1 && dlen < sizeof(erspan3_header)) return;
+
+                const uint32_t size{erspan->length()};
+                if(dlen < size) return; // truncated packet
+
+                data += size;
+                dlen -= size;
+            }
+            check_eth();
+            break;
+        }
+    }
+
+    __attribute__((noinline)) void check_vxlan()
+    {
+        if(dlen < sizeof(VXLANHeader)) return;
+        auto header = reinterpret_cast<const VXLANHeader*>(data);
+
+        if(!header->valid()) return;
+
+        data += sizeof(VXLANHeader);
+        dlen -= sizeof(VXLANHeader);
+
+        if(!tunnel(VXLAN)) return;
+
+        check_eth();
+    }
+
+    // account peeled encapsulation, false if nesting is too deep
+    inline bool decapsulate(const Encapsulation type)
+    {
+        encapsulation |= type;
+        if(++depth > max_depth)
+        {
+            encapsulation |= NESTED;
+            return false;
+        }
+        return true;
+    }
+
+    // headers of outer packet are replaced by headers of tunneled one
+    inline bool tunnel(const Encapsulation type)
+    {
+        eth  = nullptr;
+        ipv4 = nullptr;
+        ipv6 = nullptr;
+        return decapsulate(type);
+    }
+
     // libpcap structures
     const pcap_pkthdr* header;
-    const uint8_t*     packet; // real length is in header->caplen
+    const uint8_t*     packet;        // real length is in header->caplen
+    uint64_t           timestamp;     // nanoseconds since the Epoch
+    const uint8_t*     fragment;      // IP header of fragment of datagram or nullptr
+    uint8_t            encapsulation; // Encapsulation flags of peeled headers
+    uint8_t            depth;         // number of peeled encapsulations
 
     // all pointers point to packet array
 
@@ -314,8 +510,9 @@ struct PacketInfo : utils::noncopyable
     // UDP
     const udp::UDPHeader* udp;
 
-    const uint8_t* data; // pointer to packet data
-    uint32_t       dlen; // length of packet data
+    const uint8_t*       data; // pointer to packet data
+    uint32_t             dlen; // length of packet data
+    utils::PinnedBuffer* pin;  // memory of reader which keeps packet, nullptr if it's reused
 
     // Packet transmission direction, set after match packet to session
     Direction direction;
@@ -323,54 +520,198 @@ struct PacketInfo : utils::noncopyable
     mutable Dumped dumped; // flag for dumped packet
 };
 
-// PCAP packet in dynamic allocated memory
+// Size-classed pools of cache-line aligned blocks for packets kept by
+// filtration thread. Blocks bigger than the largest class are allocated
+// from heap.
+class PacketPool final : utils::noncopyable
+{
+public:
+    static const std::size_t alignment{64}; // cache line
+    static const unsigned    classes{10};   // of sizes 256 B .. 128 KB
+
+    explicit PacketPool(bool frames)
+        : whole_frames{frames}
+    {
+    }
+
+    void* allocate(std::size_t size)
+    {
+        ++allocations;
+
+        const unsigned c{size_class(size)};
+        if(c == classes)
+        {
+            void* ptr{nullptr};
+            if(posix_memalign(&ptr, alignment, size)) throw std::bad_alloc{};
+            ++heap_allocations;
+            return ptr;
+        }
+
+        utils::BlockAllocator& pool{pools[c]};
+        if(pool.max_blocks() == 0)
+        {
+            // about 64 KB of blocks are allocated at once
+            const std::size_t size{class_size(c)};
+            pool.init_allocation(size, std::max<std::size_t>(1, 65536 / size), 1, alignment);
+        }
+        return pool.allocate();
+    }
+
+    void deallocate(void* ptr, std::size_t size)
+    {
+        ++deallocations;
+
+        const unsigned c{size_class(size)};
+        if(c == classes)
+        {
+            free(ptr);
+        }
+        else
+        {
+            pools[c].deallocate(ptr);
+        }
+    }
+
+    // numbers of allocations from pool and from system
+    uint64_t allocated() const { return allocations; }
+    uint64_t deallocated() const { return deallocations; }
+    uint64_t system_allocated() const
+    {
+        uint64_t blocks{heap_allocations};
+        for(auto& pool : pools)
+        {
+            blocks += pool.max_blocks();
+        }
+        return blocks;
+    }
+
+    const bool whole_frames; // copy whole frames for dumping or payload only
+
+private:
+    static std::size_t class_size(unsigned c) { return std::size_t{256} << c; }
+    static unsigned    size_class(std::size_t size)
+    {
+        unsigned c{0};
+        while(c < classes && class_size(c) < size) ++c;
+        return c;
+    }
+
+    utils::BlockAllocator pools[classes];
+    uint64_t              allocations{0};
+    uint64_t              deallocations{0};
+    uint64_t              heap_allocations{0};
+};
+
+// Copy of TCP segment in memory of PacketPool. Payload starts at cache line,
+// headers and whole frame are copied only if PacketPool keeps whole frames.
 struct Packet final : public PacketInfo
 {
     Packet() = delete;
 
-    Packet* next; // pointer to next packet or nullptr
+    Packet*  next; // pointer to next packet or nullptr
+    uint32_t seq;  // TCP sequence number
+    uint32_t size; // of block in PacketPool
 
-    static Packet* create(const PacketInfo& info, Packet* next)
+    static Packet* create(const PacketInfo& info, Packet* next, PacketPool& pool)
     {
         assert(info.direction != Direction::Unknown);
 
-        // allocate memory for Packet structure and PCAP packet data
-        // TODO: performance drop! improve data alignment!
-        uint8_t* memory{new uint8_t[sizeof(Packet) + sizeof(pcap_pkthdr) + info.header->caplen]};
+        const bool        whole{pool.whole_frames};
+        const std::size_t offset{(sizeof(Packet) + PacketPool::alignment - 1) & ~(PacketPool::alignment - 1)};
+        const std::size_t size{offset + (whole ? sizeof(pcap_pkthdr) + info.header->caplen : info.dlen)};
 
-        Packet*      fragment{(Packet*)((uint8_t*)memory)};
-        pcap_pkthdr* header{(pcap_pkthdr*)((uint8_t*)memory + sizeof(Packet))};
-        uint8_t*     packet{(uint8_t*)((uint8_t*)memory + sizeof(Packet) + sizeof(pcap_pkthdr))};
+        uint8_t* memory{static_cast<uint8_t*>(pool.allocate(size))};
+        Packet*  fragment{reinterpret_cast<Packet*>(memory)};
 
-        // copy data
-        *header = *info.header;                           // copy packet header
-        memcpy(packet, info.packet, info.header->caplen); // copy packet data
+        if(whole)
+        {
+            pcap_pkthdr* header{(pcap_pkthdr*)(memory + offset)};
+            uint8_t*     packet{memory + offset + sizeof(pcap_pkthdr)};
+
+            // copy data
+            *header = *info.header;                           // copy packet header
+            memcpy(packet, info.packet, info.header->caplen); // copy packet data
+
+            fragment->header = header;
+            fragment->packet = packet;
+
+            // fix pointers from PacketInfo to point to owned copy of packet data
+            fragment->eth  = info.eth ? (const ethernet::EthernetHeader*)(packet + (((const uint8_t*)info.eth) - info.packet)) : nullptr;
+            fragment->ipv4 = info.ipv4 ? (const ip::IPv4Header*)(packet + (((const uint8_t*)info.ipv4) - info.packet)) : nullptr;
+            fragment->ipv6 = info.ipv6 ? (const ip::IPv6Header*)(packet + (((const uint8_t*)info.ipv6) - info.packet)) : nullptr;
+            fragment->tcp  = info.tcp ? (const tcp::TCPHeader*)(packet + (((const uint8_t*)info.tcp) - info.packet)) : nullptr;
+            fragment->udp  = info.udp ? (const udp::UDPHeader*)(packet + (((const uint8_t*)info.udp) - info.packet)) : nullptr;
+            fragment->data = packet + (info.data - info.packet);
+        }
+        else
+        {
+            // readers of stream need only payload, direction and timestamp
+            uint8_t* data{memory + offset};
+            memcpy(data, info.data, info.dlen);
+
+            fragment->header = nullptr;
+            fragment->packet = nullptr;
+            fragment->eth    = nullptr;
+            fragment->ipv4   = nullptr;
+            fragment->ipv6   = nullptr;
+            fragment->tcp    = nullptr;
+            fragment->udp    = nullptr;
+            fragment->data   = data;
+        }
 
-        fragment->header = header;
-        fragment->packet = packet;
+        fragment->timestamp = info.timestamp;
+        fragment->fragment  = nullptr;
 
-        // fix pointers from PacketInfo to point to owned copy of packet data
-        fragment->eth  = info.eth ? (const ethernet::EthernetHeader*)(packet + (((const uint8_t*)info.eth) - info.packet)) : nullptr;
-        fragment->ipv4 = info.ipv4 ? (const ip::IPv4Header*)(packet + (((const uint8_t*)info.ipv4) - info.packet)) : nullptr;
-        fragment->ipv6 = info.ipv6 ? (const ip::IPv6Header*)(packet + (((const uint8_t*)info.ipv6) - info.packet)) : nullptr;
-        fragment->tcp  = info.tcp ? (const tcp::TCPHeader*)(packet + (((const uint8_t*)info.tcp) - info.packet)) : nullptr;
-        fragment->udp  = info.udp ? (const udp::UDPHeader*)(packet + (((const uint8_t*)info.udp) - info.packet)) : nullptr;
+        fragment->encapsulation = info.encapsulation;
+        fragment->depth         = info.depth;
 
-        fragment->data      = packet + (info.data - info.packet);
         fragment->dlen      = info.dlen;
+        fragment->pin       = nullptr;
         fragment->direction = info.direction;
         fragment->dumped    = false;
 
         fragment->next = next;
+        fragment->seq  = info.tcp->seq();
+        fragment->size = uint32_t(size);
 
         return fragment;
     }
 
-    static void destroy(Packet* fragment)
+    static void destroy(Packet* fragment, PacketPool& pool)
+    {
+        pool.deallocate(fragment, fragment->size);
+    }
+};
+
+// Numbers of captured packets by peeled encapsulations
+class Encapsulations
+{
+public:
+    inline void account(const PacketInfo& info)
+    {
+        for(uint8_t flags = info.encapsulation, i = 0; flags; flags >>= 1, ++i)
+        {
+            packets[i] += flags & 1;
+        }
+    }
+
+    void print_statistic(std::ostream& out) const
     {
-        uint8_t* ptr{(uint8_t*)fragment};
-        delete[] ptr;
+        static const char* const names[]{"VLAN", "QinQ", "GRE", "ERSPAN", "VXLAN", nullptr, nullptr, "too deeply nested"};
+
+        const char* separator{"Decapsulated packets: "};
+        for(unsigned i = 0; i < 8; ++i)
+        {
+            if(!packets[i]) continue;
+
+            out << separator << names[i] << ' ' << packets[i];
+            separator = ", ";
+        }
+        if(*separator == ',') out << '\n';
     }
+
+private:
+    uint64_t packets[8]{}; // by bits of PacketInfo::Encapsulation
 };
 
 } // namespace filtration
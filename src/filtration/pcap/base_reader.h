@@ -22,13 +22,16 @@
 #ifndef BASE_READER_H
 #define BASE_READER_H
 //------------------------------------------------------------------------------
+#include <cstdint>
 #include <ostream>
 #include <string>
 
 #include <pcap/pcap.h>
 
+#include "filtration/pcap/packet_batch.h"
 #include "filtration/pcap/pcap_error.h"
 #include "utils/noncopyable.h"
+#include "utils/pinned_buffer.h"
 //------------------------------------------------------------------------------
 namespace NST
 {
@@ -67,6 +70,54 @@ public:
         return err == 0; // count is exhausted
     }
 
+    // read packets by pcap_next_ex() and pass them to callback by batches,
+    // libpcap reuses its buffer for each packet, so they are copied to batch
+    bool loop(void* user, batch_handler callback, PacketBatch& batch, int count = 0)
+    {
+        int processed{0};
+        for(;;)
+        {
+            struct pcap_pkthdr* header;
+            const u_char*       packet;
+
+            const int err{pcap_next_ex(handle, &header, &packet)};
+            if(err == 1) // packet is read
+            {
+                if(!batch.copy(*header, packet))
+                {
+                    flush(user, callback, batch);
+                    if(!batch.copy(*header, packet))
+                    {
+                        throw std::runtime_error{"packet doesn't fit into buffer of batch"};
+                    }
+                }
+
+                if(count > 0 && ++processed == count)
+                {
+                    flush(user, callback, batch);
+                    return true; // count is exhausted
+                }
+                if(batch.full())
+                {
+                    flush(user, callback, batch);
+                }
+            }
+            else if(err == 0) // read timeout expired
+            {
+                flush(user, callback, batch);
+            }
+            else if(err == PCAP_ERROR_BREAK) // end of file or pcap_breakloop()
+            {
+                flush(user, callback, batch);
+                return pcap_file(handle) != nullptr;
+            }
+            else
+            {
+                throw PcapError("pcap_next_ex", pcap_geterr(handle));
+            }
+        }
+    }
+
     inline void               break_loop() { pcap_breakloop(handle); }
     inline pcap_t*&           get_handle() { return handle; }
     inline int                datalink() const { return pcap_datalink(handle); }
@@ -74,7 +125,44 @@ public:
     inline static const char* datalink_description(const int dlt) { return pcap_datalink_val_to_description(dlt); }
     virtual void print_statistic(std::ostream& out) const = 0;
 
+    // memory of packets passed to callbacks, libpcap reuses its buffers
+    inline utils::PinnedBuffer* pin() const { return nullptr; }
+
+    // nanoseconds in unit of pcap_pkthdr::ts.tv_usec of read packets
+    inline uint32_t tstamp_unit() const
+    {
+#ifdef PCAP_TSTAMP_PRECISION_NANO
+        if(pcap_get_tstamp_precision(handle) == PCAP_TSTAMP_PRECISION_NANO) return 1;
+#endif
+        return 1000;
+    }
+
 protected:
+    // handle for dumping of packets that are read without libpcap, with
+    // nanosecond precision of timestamps if libpcap supports it (1.5.0+)
+    static inline pcap_t* open_dead(int linktype, int snaplen)
+    {
+#ifdef PCAP_TSTAMP_PRECISION_NANO
+        pcap_t* dead{pcap_open_dead_with_tstamp_precision(linktype, snaplen, PCAP_TSTAMP_PRECISION_NANO)};
+#else
+        pcap_t* dead{pcap_open_dead(linktype, snaplen)};
+#endif
+        if(!dead)
+        {
+            throw PcapError("pcap_open_dead", "cannot allocate pcap handle");
+        }
+        return dead;
+    }
+
+    static inline void flush(void* user, batch_handler callback, PacketBatch& batch)
+    {
+        if(!batch.empty())
+        {
+            callback((u_char*)user, batch);
+            batch.clear();
+        }
+    }
+
     pcap_t*           handle;
     const std::string source;
 };
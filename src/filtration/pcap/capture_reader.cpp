@@ -60,6 +60,11 @@ CaptureReader::CaptureReader(const Params& params)
         throw PcapError("pcap_set_buffer_size", pcap_statustostr(status));
     }
 
+#ifdef PCAP_TSTAMP_PRECISION_NANO
+    // microseconds are used if the platform doesn't provide nanoseconds
+    pcap_set_tstamp_precision(handle, PCAP_TSTAMP_PRECISION_NANO);
+#endif
+
     if(int status{pcap_activate(handle)})
     {
         throw PcapError("pcap_activate", pcap_statustostr(status));
@@ -136,6 +141,15 @@ std::ostream& operator<<(std::ostream& out, const CaptureReader::Params& params)
         out << "inout";
         break;
     }
+    if(params.ring)
+    {
+        out << "\n  TPACKET_V3 ring : " << params.ring_block_count << " blocks of "
+            << params.ring_block_size << " bytes";
+        if(params.fanout > 1)
+        {
+            out << "\n  fanout threads  : " << params.fanout;
+        }
+    }
     return out;
 }
 
@@ -51,6 +51,10 @@ public:
         int         buffer_size{0};
         bool        promisc{true};
         Direction   direction{Direction::INOUT};
+        bool        ring{false}; // capture via TPACKET_V3 ring instead of libpcap
+        unsigned    ring_block_size{0};
+        unsigned    ring_block_count{0};
+        unsigned    fanout{1}; // number of TPACKET_V3 rings in PACKET_FANOUT group
     };
 
     CaptureReader(const Params& params);
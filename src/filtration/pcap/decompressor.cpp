@@ -0,0 +1,739 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Parallel decompression of compressed trace files.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef WITH_BZIP2
+#include <bzlib.h>
+#endif
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include "filtration/pcap/decompressor.h"
+#include "utils/log.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+namespace pcap
+{
+namespace // unnamed
+{
+const uint64_t npos{std::numeric_limits<uint64_t>::max()};
+
+const std::size_t piece_size{1024 * 1024};      // unit of decoded data
+const std::size_t slot_limit{16 * 1024 * 1024}; // decoded data of range waiting for reader
+const std::size_t stream_buffer{1024 * 1024};   // buffer of stdio stream
+
+// bzip2 magic numbers, they aren't aligned to bytes within stream
+const uint64_t bzip2_block_magic{0x314159265359}; // BCD of pi
+const uint64_t bzip2_eos_magic{0x177245385090};   // BCD of sqrt(pi)
+const uint32_t bzip2_max_block{900000};
+
+// bound of compressed block: 20 bits of the longest Huffman code for each
+// symbol of max block and tables of the block
+const uint64_t max_block_bits{uint64_t{bzip2_max_block} * 20 + 64 * 1024};
+
+// table of shifts of magic within byte for each value of byte following
+// the byte where the magic starts, this byte is fully covered by the magic
+struct MagicTable
+{
+    explicit MagicTable(uint64_t magic)
+        : shifts{}
+    {
+        for(unsigned s = 0; s < 8; ++s)
+        {
+            shifts[(magic >> (32 + s)) & 0xff] |= uint8_t(1 << s);
+        }
+    }
+
+    uint8_t shifts[256];
+};
+
+const MagicTable bzip2_block_table{bzip2_block_magic};
+const MagicTable bzip2_eos_table{bzip2_eos_magic};
+
+// size of gzip member with BGZF extra field or 0
+std::size_t bgzf_length(const uint8_t* member, std::size_t size)
+{
+    const std::size_t header{12};
+    if(size < header + 6 ||
+       member[0] != 0x1f || member[1] != 0x8b || member[2] != 8 || !(member[3] & 0x04 /*FEXTRA*/))
+    {
+        return 0;
+    }
+
+    const std::size_t extra{member[10] | std::size_t(member[11]) << 8};
+    for(std::size_t i = header; i + 4 <= header + extra && i + 4 <= size;)
+    {
+        const std::size_t length{member[i + 2] | std::size_t(member[i + 3]) << 8};
+        if(member[i] == 'B' && member[i + 1] == 'C' && length == 2 && i + 6 <= size)
+        {
+            const std::size_t total{(member[i + 4] | std::size_t(member[i + 5]) << 8) + 1};
+            return total <= size ? total : 0;
+        }
+        i += 4 + length;
+    }
+    return 0;
+}
+
+// thrown by sink to interrupt decoding on destruction of Decompressor
+struct Stopped
+{
+};
+
+} // unnamed namespace
+
+Decompressor::Format Decompressor::detect(const std::string& file)
+{
+    struct stat st;
+    if(stat(file.c_str(), &st) < 0 || !S_ISREG(st.st_mode)) return Format::None;
+
+    const int fd{::open(file.c_str(), O_RDONLY)};
+    if(fd < 0) return Format::None;
+
+    uint8_t       magic[4];
+    const ssize_t n{::read(fd, magic, sizeof(magic))};
+    close(fd);
+    if(n != sizeof(magic)) return Format::None;
+
+    if(magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h' && magic[3] >= '1' && magic[3] <= '9')
+    {
+        return Format::BZip2;
+    }
+    if(magic[0] == 0x1f && magic[1] == 0x8b)
+    {
+        return Format::GZip;
+    }
+    if(magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd)
+    {
+        return Format::ZStd;
+    }
+    return Format::None;
+}
+
+Decompressor::Decompressor(const std::string& file, Format f)
+    : source{file}
+    , format{f}
+    , fd{-1}
+    , data{nullptr}
+    , size{0}
+    , position{0}
+    , next{npos}
+    , offset{0}
+    , covered{0}
+    , max_slots{0}
+    , exhausted{false}
+    , stopping{false}
+{
+    const char* library{nullptr};
+    switch(format)
+    {
+    case Format::BZip2:
+#ifndef WITH_BZIP2
+        library = "libbz2";
+#endif
+        position = 32; // after stream header 'BZh[1-9]'
+        break;
+    case Format::GZip:
+#ifndef WITH_ZLIB
+        library = "zlib";
+#endif
+        break;
+    case Format::ZStd:
+#ifndef WITH_ZSTD
+        library = "libzstd";
+#endif
+        break;
+    case Format::None:
+        throw std::runtime_error{"Unknown compression format of: " + file};
+    }
+    if(library)
+    {
+        throw std::runtime_error{"nfstrace is built without " + std::string{library} +
+                                 ", decompress " + file + " by external tool"};
+    }
+
+    fd = ::open(file.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        throw std::system_error{errno, std::system_category(), "open(" + file + ")"};
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) < 0)
+    {
+        close(fd);
+        throw std::system_error{errno, std::system_category(), "fstat(" + file + ")"};
+    }
+    size = st.st_size;
+
+    void* map{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)};
+    if(map == MAP_FAILED)
+    {
+        close(fd);
+        throw std::system_error{errno, std::system_category(), "mmap(" + file + ")"};
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    data = reinterpret_cast<const uint8_t*>(map);
+
+    const unsigned count{std::max(1u, std::thread::hardware_concurrency())};
+    max_slots = count * 2;
+    for(unsigned i = 0; i < count; ++i)
+    {
+        threads.emplace_back(&Decompressor::worker, this);
+    }
+}
+
+Decompressor::~Decompressor()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    consumed.notify_all();
+    produced.notify_all();
+
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    munmap(const_cast<uint8_t*>(data), size);
+    close(fd);
+}
+
+FILE* Decompressor::open()
+{
+    cookie_io_functions_t functions;
+    functions.read  = &Decompressor::cookie_read;
+    functions.write = nullptr;
+    functions.seek  = nullptr;
+    functions.close = nullptr;
+
+    FILE* stream{fopencookie(this, "r", functions)};
+    if(!stream)
+    {
+        throw std::system_error{errno, std::system_category(), "fopencookie"};
+    }
+    setvbuf(stream, nullptr, _IOFBF, stream_buffer);
+    return stream;
+}
+
+void Decompressor::worker()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    for(;;)
+    {
+        consumed.wait(lock, [&] { return stopping || exhausted || slots.size() < max_slots; });
+        if(stopping || exhausted) return;
+
+        // ranges are split in order of input, so their slots are ordered too
+        Range range;
+        slots.emplace_back(new Slot{});
+        Slot& slot{*slots.back()};
+        try
+        {
+            if(!split(range))
+            {
+                slots.pop_back();
+                exhausted = true;
+                produced.notify_all();
+                return;
+            }
+            slot.begin = range.begin;
+        }
+        catch(...)
+        {
+            slot.error    = std::current_exception();
+            slot.complete = true;
+            exhausted     = true;
+            produced.notify_all();
+            return;
+        }
+
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            decode(range, [&](std::vector<char>&& piece) { push(slot, std::move(piece)); });
+        }
+        catch(const Stopped&)
+        {
+        }
+        catch(...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        slot.end      = range.end;
+        slot.error    = error;
+        slot.complete = true;
+        produced.notify_all();
+    }
+}
+
+bool Decompressor::split(Range& range)
+{
+    switch(format)
+    {
+    case Format::BZip2: return split_bzip2(range);
+    case Format::GZip: return split_gzip(range);
+    case Format::ZStd: return split_zstd(range);
+    case Format::None: break;
+    }
+    return false;
+}
+
+void Decompressor::decode(Range& range, const Sink& sink) const
+{
+    switch(format)
+    {
+    case Format::BZip2: decode_bzip2(range, sink); break;
+    case Format::GZip: decode_gzip(range, sink); break;
+    case Format::ZStd: decode_zstd(range, sink); break;
+    case Format::None: break;
+    }
+}
+
+void Decompressor::push(Slot& slot, std::vector<char>&& piece)
+{
+    if(piece.empty()) return;
+
+    std::unique_lock<std::mutex> lock{mutex};
+    consumed.wait(lock, [&] { return stopping || slot.buffered < slot_limit; });
+    if(stopping) throw Stopped{};
+
+    slot.buffered += piece.size();
+    slot.pieces.push_back(std::move(piece));
+    produced.notify_all();
+}
+
+ssize_t Decompressor::read(char* buffer, std::size_t length)
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    for(;;)
+    {
+        if(slots.empty())
+        {
+            if(exhausted) return 0; // end of file
+            produced.wait(lock);
+            continue;
+        }
+
+        Slot& slot{*slots.front()};
+        if(slot.begin < covered) // range is decoded as part of previous one
+        {
+            slot.pieces.clear();
+            slot.buffered = 0;
+            consumed.notify_all();
+            if(slot.complete)
+            {
+                slots.pop_front();
+                continue;
+            }
+            produced.wait(lock);
+            continue;
+        }
+        if(!slot.pieces.empty())
+        {
+            std::vector<char>& piece{slot.pieces.front()};
+            const std::size_t  n{std::min(length, piece.size() - offset)};
+            memcpy(buffer, piece.data() + offset, n);
+            offset += n;
+            if(offset == piece.size())
+            {
+                slot.buffered -= piece.size();
+                slot.pieces.pop_front();
+                offset = 0;
+                consumed.notify_all();
+            }
+            return n;
+        }
+
+        if(slot.complete)
+        {
+            if(slot.error)
+            {
+                try
+                {
+                    std::rethrow_exception(slot.error);
+                }
+                catch(const std::exception& e)
+                {
+                    LOGONCE("%s", e.what());
+                }
+                errno = EIO;
+                return -1;
+            }
+            covered = slot.end;
+            slots.pop_front();
+            consumed.notify_all();
+            continue;
+        }
+        produced.wait(lock);
+    }
+}
+
+ssize_t Decompressor::cookie_read(void* cookie, char* buffer, std::size_t size)
+{
+    return reinterpret_cast<Decompressor*>(cookie)->read(buffer, size);
+}
+
+bool Decompressor::split_bzip2(Range& range)
+{
+    for(;;)
+    {
+        bool eos;
+        if(next == npos)
+        {
+            const uint64_t found{find_bzip2_magic(position, eos)};
+            if(found == npos) return false;
+            if(eos) // skip end of stream, next stream may be concatenated
+            {
+                position = found + 48 + 32;
+                continue;
+            }
+            next = found;
+        }
+
+        // block lasts up to next block or end of stream
+        range.begin = next;
+        range.crc   = uint32_t(bits(next + 48, 32));
+
+        const uint64_t end{find_bzip2_magic(next + 48, eos)};
+        range.end = (end == npos) ? uint64_t{size} * 8 : end;
+        if(end != npos && !eos)
+        {
+            next = end;
+        }
+        else
+        {
+            next     = npos;
+            position = range.end;
+        }
+        return true;
+    }
+}
+
+bool Decompressor::split_gzip(Range& range)
+{
+    if(position >= size) return false;
+
+    // BGZF members are independent, other data is decoded sequentially
+    const std::size_t length{bgzf_length(data + position, size - position)};
+    range.begin = position;
+    range.end   = length ? position + length : size;
+    position    = range.end;
+    return true;
+}
+
+bool Decompressor::split_zstd(Range& range)
+{
+    if(position >= size) return false;
+
+    range.begin = position;
+    range.end   = size;
+#ifdef WITH_ZSTD
+    const std::size_t length{ZSTD_findFrameCompressedSize(data + position, size - position)};
+    if(!ZSTD_isError(length))
+    {
+        range.end = position + length;
+    }
+#endif
+    position = range.end;
+    return true;
+}
+
+void Decompressor::decode_bzip2(Range& range, const Sink& sink) const
+{
+    // The block lasts up to the next magic number unless the magic number
+    // happens to be inside of compressed data. Then decoding of the block
+    // fails, so the block is extended up to the following magic number.
+    // Decoding of the range starting at such magic number fails too, its
+    // slot is dropped by read() as covered by the extended range.
+    const uint64_t total{uint64_t{size} * 8};
+    const uint64_t limit{range.begin + max_block_bits};
+    for(;;)
+    {
+        bool decoded{false};
+        try
+        {
+            decode_bzip2_block(range, [&](std::vector<char>&& piece) {
+                decoded = decoded || !piece.empty();
+                sink(std::move(piece));
+            });
+            return;
+        }
+        catch(const std::runtime_error&)
+        {
+            if(decoded || range.end >= std::min(total, limit)) throw;
+        }
+
+        bool           eos;
+        const uint64_t end{find_bzip2_magic(range.end + 48, eos)};
+        range.end = (end == npos) ? total : end;
+    }
+}
+
+void Decompressor::decode_bzip2_block(const Range& range, const Sink& sink) const
+{
+#ifdef WITH_BZIP2
+    // make standalone stream of one block
+    std::vector<char> stream{'B', 'Z', 'h', '9'};
+    stream.reserve(stream.size() + (range.end - range.begin) / 8 + 16);
+
+    uint64_t acc{0};
+    unsigned n{0};
+    auto     put = [&](uint64_t value, unsigned count) {
+        acc = (acc << count) | (value & ((uint64_t{1} << count) - 1));
+        n += count;
+        while(n >= 8)
+        {
+            n -= 8;
+            stream.push_back(char(acc >> n));
+        }
+    };
+
+    for(uint64_t pos = range.begin; pos < range.end;)
+    {
+        const unsigned count = unsigned(std::min<uint64_t>(32, range.end - pos));
+        put(bits(pos, count), count);
+        pos += count;
+    }
+    put(bzip2_eos_magic >> 24, 24);
+    put(bzip2_eos_magic, 24);
+    put(range.crc, 32); // CRC of stream with single block is CRC of the block
+    if(n) put(0, 8 - n);
+
+    struct Stream : bz_stream
+    {
+        Stream()
+            : bz_stream{}
+        {
+            if(BZ2_bzDecompressInit(this, 0, 0) != BZ_OK)
+            {
+                throw std::runtime_error{"BZ2_bzDecompressInit failed"};
+            }
+        }
+        ~Stream() { BZ2_bzDecompressEnd(this); }
+    } strm;
+
+    strm.next_in  = stream.data();
+    strm.avail_in = unsigned(stream.size());
+
+    int ret;
+    do
+    {
+        std::vector<char> piece(piece_size);
+        strm.next_out  = piece.data();
+        strm.avail_out = unsigned(piece.size());
+
+        ret = BZ2_bzDecompress(&strm);
+        if(ret != BZ_OK && ret != BZ_STREAM_END)
+        {
+            throw std::runtime_error{"bzip2 data of " + source + " is corrupted"};
+        }
+        if(ret == BZ_OK && strm.avail_in == 0 && strm.avail_out != 0)
+        {
+            throw std::runtime_error{"bzip2 data of " + source + " is truncated"};
+        }
+
+        piece.resize(piece.size() - strm.avail_out);
+        sink(std::move(piece));
+    } while(ret != BZ_STREAM_END);
+#else
+    (void)range;
+    (void)sink;
+#endif
+}
+
+void Decompressor::decode_gzip(const Range& range, const Sink& sink) const
+{
+#ifdef WITH_ZLIB
+    struct Stream : z_stream
+    {
+        Stream()
+            : z_stream{}
+        {
+            if(inflateInit2(this, 16 + MAX_WBITS /*gzip header*/) != Z_OK)
+            {
+                throw std::runtime_error{"inflateInit2 failed"};
+            }
+        }
+        ~Stream() { inflateEnd(this); }
+    } strm;
+
+    const uint8_t* input{data + range.begin};
+    std::size_t    remaining{range.end - range.begin};
+    for(;;)
+    {
+        if(strm.avail_in == 0) // avail_in is 32-bit
+        {
+            const std::size_t n{std::min<std::size_t>(remaining, std::numeric_limits<uInt>::max())};
+            strm.next_in  = const_cast<Bytef*>(input);
+            strm.avail_in = uInt(n);
+            input += n;
+            remaining -= n;
+        }
+
+        std::vector<char> piece(piece_size);
+        strm.next_out  = reinterpret_cast<Bytef*>(piece.data());
+        strm.avail_out = uInt(piece.size());
+
+        const int ret{inflate(&strm, Z_NO_FLUSH)};
+        piece.resize(piece.size() - strm.avail_out);
+        sink(std::move(piece));
+
+        if(ret == Z_STREAM_END)
+        {
+            if(strm.avail_in == 0 && remaining == 0) return;
+            inflateReset(&strm); // concatenated member
+        }
+        else if(ret == Z_BUF_ERROR && strm.avail_in == 0 && remaining == 0)
+        {
+            throw std::runtime_error{"gzip data of " + source + " is truncated"};
+        }
+        else if(ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+            throw std::runtime_error{"gzip data of " + source + " is corrupted"};
+        }
+    }
+#else
+    (void)range;
+    (void)sink;
+#endif
+}
+
+void Decompressor::decode_zstd(const Range& range, const Sink& sink) const
+{
+#ifdef WITH_ZSTD
+    struct Stream
+    {
+        Stream()
+            : stream{ZSTD_createDStream()}
+        {
+            if(!stream || ZSTD_isError(ZSTD_initDStream(stream)))
+            {
+                ZSTD_freeDStream(stream);
+                throw std::runtime_error{"ZSTD_initDStream failed"};
+            }
+        }
+        ~Stream() { ZSTD_freeDStream(stream); }
+
+        ZSTD_DStream* stream;
+    } strm;
+
+    ZSTD_inBuffer input{data + range.begin, range.end - range.begin, 0};
+    std::size_t   ret{1};
+    while(input.pos < input.size || ret != 0)
+    {
+        std::vector<char> piece(piece_size);
+        ZSTD_outBuffer    output{piece.data(), piece.size(), 0};
+
+        const std::size_t consumed{input.pos};
+        ret = ZSTD_decompressStream(strm.stream, &output, &input);
+        if(ZSTD_isError(ret))
+        {
+            throw std::runtime_error{"zstd data of " + source + " is corrupted: " + ZSTD_getErrorName(ret)};
+        }
+        if(ret != 0 && output.pos == 0 && input.pos == consumed)
+        {
+            throw std::runtime_error{"zstd data of " + source + " is truncated"};
+        }
+
+        piece.resize(output.pos);
+        sink(std::move(piece));
+    }
+#else
+    (void)range;
+    (void)sink;
+#endif
+}
+
+uint64_t Decompressor::find_bzip2_magic(uint64_t from, bool& eos) const
+{
+    const uint64_t total{uint64_t{size} * 8};
+
+    // magic starting in byte q-1 fully covers byte q
+    for(std::size_t q = from / 8 + 1; q < size; ++q)
+    {
+        const uint8_t block{bzip2_block_table.shifts[data[q]]};
+        const uint8_t end{bzip2_eos_table.shifts[data[q]]};
+        if(!(block | end)) continue;
+
+        for(unsigned s = 0; s < 8; ++s)
+        {
+            const uint64_t pos{uint64_t{q - 1} * 8 + s};
+            if(pos < from || pos + 48 > total) continue;
+
+            if(((block >> s) & 1) && bits(pos, 48) == bzip2_block_magic)
+            {
+                // magic, CRC, randomised bit and origPtr must be in bounds
+                if(pos + 48 + 32 + 1 + 24 <= total && bits(pos + 81, 24) < bzip2_max_block)
+                {
+                    eos = false;
+                    return pos;
+                }
+            }
+            if(((end >> s) & 1) && bits(pos, 48) == bzip2_eos_magic)
+            {
+                eos = true;
+                return pos;
+            }
+        }
+    }
+    return npos;
+}
+
+uint64_t Decompressor::bits(uint64_t position, unsigned count) const
+{
+    // count must not exceed 56 bits
+    const std::size_t byte{std::size_t(position / 8)};
+
+    uint64_t value{0};
+    for(std::size_t i = 0; i < 8; ++i)
+    {
+        value = (value << 8) | ((byte + i < size) ? data[byte + i] : 0);
+    }
+    return (value << (position % 8)) >> (64 - count);
+}
+
+} // namespace pcap
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Parallel decompression of compressed trace files.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+//------------------------------------------------------------------------------
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/noncopyable.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+namespace pcap
+{
+// Decompressor of .bz2, .gz and .zst files mapped into memory.
+// The input is split into independent ranges that are decoded by pool of
+// threads ahead of the reader, decoded data is read in order of ranges via
+// stdio stream that can be passed to pcap_fopen_offline():
+//  - bzip2 blocks are located by their bit-aligned magic numbers and each
+//    block is decoded as standalone stream, a magic number which happens
+//    to be inside of compressed data is detected by failed decoding;
+//  - gzip members with BGZF block size are decoded in parallel, other
+//    deflate streams are decoded sequentially by one thread;
+//  - zstd frames are decoded in parallel, single frame sequentially.
+// Decoded data of each range is limited, so the pool is stalled if the
+// reader falls behind.
+class Decompressor final : utils::noncopyable
+{
+public:
+    enum class Format
+    {
+        None, // isn't compressed or unknown format
+        BZip2,
+        GZip,
+        ZStd,
+    };
+
+    // detect format of regular file by magic number
+    static Format detect(const std::string& file);
+
+    Decompressor(const std::string& file, Format format);
+    ~Decompressor();
+
+    // stream of decompressed data, it must be closed before destruction
+    FILE* open();
+
+private:
+    struct Range // independent part of input, bits for bzip2 and bytes otherwise
+    {
+        uint64_t begin;
+        uint64_t end;
+        uint32_t crc; // CRC of bzip2 block
+    };
+
+    struct Slot // decoded data of range
+    {
+        uint64_t                      begin{0}; // of range
+        uint64_t                      end{0};   // of range, it may be extended by decoding
+        std::deque<std::vector<char>> pieces;
+        std::size_t                   buffered{0};
+        bool                          complete{false};
+        std::exception_ptr            error;
+    };
+
+    using Sink = std::function<void(std::vector<char>&&)>;
+
+    void worker();
+    bool split(Range& range);
+    void decode(Range& range, const Sink& sink) const;
+    void push(Slot& slot, std::vector<char>&& piece);
+    ssize_t read(char* buffer, std::size_t size);
+
+    bool split_bzip2(Range& range);
+    bool split_gzip(Range& range);
+    bool split_zstd(Range& range);
+    void decode_bzip2(Range& range, const Sink& sink) const;
+    void decode_bzip2_block(const Range& range, const Sink& sink) const;
+    void decode_gzip(const Range& range, const Sink& sink) const;
+    void decode_zstd(const Range& range, const Sink& sink) const;
+
+    uint64_t find_bzip2_magic(uint64_t from, bool& eos) const;
+    uint64_t bits(uint64_t position, unsigned count) const;
+
+    static ssize_t cookie_read(void* cookie, char* buffer, std::size_t size);
+
+    const std::string source;
+    const Format      format;
+    int               fd;
+    const uint8_t*    data;
+    std::size_t       size;
+    uint64_t          position; // start of next range in input
+    uint64_t          next;     // found bzip2 block or npos
+
+    std::mutex                        mutex;
+    std::condition_variable           produced;
+    std::condition_variable           consumed;
+    std::deque<std::unique_ptr<Slot>> slots;     // in order of ranges
+    std::size_t                       offset;    // in front piece of front slot
+    uint64_t                          covered;   // end of ranges which are read
+    std::size_t                       max_slots; // ranges decoded ahead
+    bool                              exhausted; // all ranges are split
+    bool                              stopping;
+
+    std::vector<std::thread> threads;
+};
+
+} // namespace pcap
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // DECOMPRESSOR_H
+//------------------------------------------------------------------------------
@@ -30,20 +30,58 @@ namespace pcap
 {
 FileReader::FileReader(const std::string& file)
     : BaseReader{file}
+    , decompressor{}
 {
     char errbuf[PCAP_ERRBUF_SIZE];
 
-    // open pcap device for reading from file in file system
+    const Decompressor::Format format{Decompressor::detect(file)};
+    if(format != Decompressor::Format::None)
+    {
+        // read decompressed data from stream filled by pool of threads
+        decompressor.reset(new Decompressor{file, format});
+        FILE* stream{decompressor->open()};
+
+#ifdef PCAP_TSTAMP_PRECISION_NANO
+        handle = pcap_fopen_offline_with_tstamp_precision(stream, PCAP_TSTAMP_PRECISION_NANO, errbuf);
+#else
+        handle = pcap_fopen_offline(stream, errbuf);
+#endif
+        if(!handle)
+        {
+            fclose(stream);
+            throw PcapError("pcap_fopen_offline", errbuf);
+        }
+        return;
+    }
+
+    // open pcap device for reading from file in file system,
+    // libpcap scales timestamps to requested precision
+#ifdef PCAP_TSTAMP_PRECISION_NANO
+    handle = pcap_open_offline_with_tstamp_precision(file.c_str(), PCAP_TSTAMP_PRECISION_NANO, errbuf);
+#else
     handle = pcap_open_offline(file.c_str(), errbuf);
+#endif
     if(!handle)
     {
         throw PcapError("pcap_open_offline", errbuf);
     }
 }
 
+FileReader::~FileReader()
+{
+    // stream of decompressor is closed by pcap_close()
+    if(handle)
+    {
+        pcap_close(handle);
+        handle = nullptr;
+    }
+}
+
 std::ostream& operator<<(std::ostream& out, FileReader& f)
 {
-    out << "Read packets from: " << f.source << '\n';
+    out << "Read packets from: " << f.source;
+    if(f.decompressor) out << " (decompressed)";
+    out << '\n';
     const int dlt{f.datalink()};
     out << "  datalink: " << f.datalink_name(dlt) << " (" << f.datalink_description(dlt) << ")\n";
     out << "  version: " << f.major_version() << '.' << f.minor_version();
@@ -23,8 +23,10 @@
 #define FILE_READER_H
 //------------------------------------------------------------------------------
 #include <cstdio>
+#include <memory>
 
 #include "filtration/pcap/base_reader.h"
+#include "filtration/pcap/decompressor.h"
 //------------------------------------------------------------------------------
 namespace NST
 {
@@ -36,7 +38,7 @@ class FileReader final : public BaseReader
 {
 public:
     explicit FileReader(const std::string& file);
-    ~FileReader() override = default;
+    ~FileReader() override;
 
     inline FILE*         get_file() { return pcap_file(handle); }
     void                 print_statistic(std::ostream& /*out*/) const override {}
@@ -44,6 +46,9 @@ public:
     inline int           minor_version() { return pcap_minor_version(handle); }
     inline bool          is_swapped() { return pcap_is_swapped(handle); }
     friend std::ostream& operator<<(std::ostream& out, FileReader& f);
+
+private:
+    std::unique_ptr<Decompressor> decompressor; // for compressed files
 };
 
 } // namespace pcap
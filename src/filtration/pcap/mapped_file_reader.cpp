@@ -0,0 +1,549 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Read packets from memory-mapped pcap and pcapng files.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "filtration/pcap/mapped_file_reader.h"
+#include "filtration/pcap/mapping.h"
+#include "filtration/pcap/pcap_error.h"
+#include "utils/log.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+namespace pcap
+{
+namespace // unnamed
+{
+// magic numbers of supported formats as they are read in native byte order
+const uint32_t pcap_magic{0xa1b2c3d4};
+const uint32_t pcap_swapped_magic{0xd4c3b2a1};
+const uint32_t pcap_nsec_magic{0xa1b23c4d};
+const uint32_t pcap_nsec_swapped_magic{0x4d3cb2a1};
+const uint32_t pcapng_section_magic{0x0a0d0d0a}; // palindrome
+const uint32_t pcapng_byte_order_magic{0x1a2b3c4d};
+
+// pcapng block types
+const uint32_t pcapng_interface_block{0x00000001};
+const uint32_t pcapng_packet_block{0x00000002}; // obsolete
+const uint32_t pcapng_simple_packet_block{0x00000003};
+const uint32_t pcapng_enhanced_packet_block{0x00000006};
+
+// pcapng options of Interface Description Block
+const uint16_t pcapng_opt_endofopt{0};
+const uint16_t pcapng_opt_if_tsresol{9};
+const uint16_t pcapng_opt_if_tsoffset{14};
+
+const std::size_t file_header_size{24};
+const std::size_t record_header_size{16};
+const uint32_t    max_snaplen{262144};
+
+// size of region read ahead and kept in memory behind the current position
+const std::size_t window{64 * 1024 * 1024};
+
+inline uint32_t read_magic(const uint8_t* p)
+{
+    uint32_t magic;
+    memcpy(&magic, p, sizeof(magic));
+    return magic;
+}
+
+} // unnamed namespace
+
+MappedFileReader::MappedFileReader(const std::string& file)
+    : BaseReader{file}
+    , fd{-1}
+    , data{nullptr}
+    , mapping{nullptr}
+    , size{0}
+    , offset{0}
+    , advised{0}
+    , released{0}
+    , format{Format::PCAP}
+    , swapped{false}
+    , nsec{false}
+    , unit{1000}
+    , linktype{DLT_NULL}
+    , snaplen{0}
+    , major{0}
+    , minor{0}
+    , interfaces{}
+    , stopped{false}
+{
+    fd = open(file.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        throw std::system_error{errno, std::system_category(), "open(" + file + ")"};
+    }
+
+    try
+    {
+        struct stat st;
+        if(fstat(fd, &st) < 0)
+        {
+            throw std::system_error{errno, std::system_category(), "fstat(" + file + ")"};
+        }
+        size = st.st_size;
+        if(size < sizeof(uint32_t))
+        {
+            throw std::runtime_error{"Truncated trace file: " + file};
+        }
+
+        void* map{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)};
+        if(map == MAP_FAILED)
+        {
+            throw std::system_error{errno, std::system_category(), "mmap(" + file + ")"};
+        }
+        data    = reinterpret_cast<const uint8_t*>(map);
+        mapping = new Mapping{map, size};
+
+        // ask kernel for aggressive read ahead, errors are ignored
+        madvise(map, size, MADV_SEQUENTIAL);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        const uint32_t magic{read_magic(data)};
+        if(magic == pcapng_section_magic)
+        {
+            format = Format::PCAPNG;
+            if(size < 28)
+            {
+                throw std::runtime_error{"Truncated trace file: " + file};
+            }
+            read_section_header(data, size);
+
+            // lookup first interface for datalink of handle
+            for(std::size_t pos{u32(data + 4)}; pos + 12 <= size;)
+            {
+                const uint32_t type{u32(data + pos)};
+                const uint32_t length{u32(data + pos + 4)};
+                if(type == pcapng_section_magic || length < 12 || pos + length > size) break;
+                if(type == pcapng_interface_block && length >= 20)
+                {
+                    linktype = u16(data + pos + 8);
+                    snaplen  = u32(data + pos + 12);
+                    break;
+                }
+                pos += length;
+            }
+        }
+        else
+        {
+            swapped = (magic == pcap_swapped_magic || magic == pcap_nsec_swapped_magic);
+            nsec    = (magic == pcap_nsec_magic || magic == pcap_nsec_swapped_magic);
+            if(!swapped && !nsec && magic != pcap_magic)
+            {
+                throw std::runtime_error{"Unknown format of trace file: " + file};
+            }
+            if(size < file_header_size)
+            {
+                throw std::runtime_error{"Truncated trace file: " + file};
+            }
+            major    = u16(data + 4);
+            minor    = u16(data + 6);
+            snaplen  = u32(data + 16);
+            linktype = u32(data + 20) & 0x03ffffff; // without FCS length
+            offset   = file_header_size;
+        }
+
+        if(!snaplen || snaplen > max_snaplen) snaplen = max_snaplen;
+        handle = open_dead(linktype, snaplen);
+        unit   = tstamp_unit();
+    }
+    catch(...)
+    {
+        if(mapping) mapping->release();
+        else if(data) munmap(const_cast<uint8_t*>(data), size);
+        close(fd);
+        throw;
+    }
+}
+
+MappedFileReader::~MappedFileReader()
+{
+    mapping->release(); // it's unmapped when queued data don't reference it
+    close(fd);
+}
+
+bool MappedFileReader::is_supported(const std::string& file)
+{
+    struct stat st;
+    if(stat(file.c_str(), &st) < 0 || !S_ISREG(st.st_mode)) return false;
+
+    const int fd{open(file.c_str(), O_RDONLY)};
+    if(fd < 0) return false;
+
+    uint8_t       buffer[sizeof(uint32_t)];
+    const ssize_t n{read(fd, buffer, sizeof(buffer))};
+    close(fd);
+    if(n != sizeof(buffer)) return false;
+
+    switch(read_magic(buffer))
+    {
+    case pcap_magic:
+    case pcap_swapped_magic:
+    case pcap_nsec_magic:
+    case pcap_nsec_swapped_magic:
+    case pcapng_section_magic:
+        return true;
+    }
+    return false;
+}
+
+bool MappedFileReader::loop(void* user, pcap_handler callback, int count)
+{
+    struct pcap_pkthdr header;
+    const uint8_t*     packet;
+
+    int processed{0};
+    while(!stopped.load(std::memory_order_relaxed))
+    {
+        if(!next(header, packet))
+        {
+            return true; // end of file
+        }
+
+        callback((u_char*)user, &header, packet);
+
+        if(count > 0 && ++processed == count)
+        {
+            return true; // count is exhausted
+        }
+    }
+    return false;
+}
+
+bool MappedFileReader::loop(void* user, batch_handler callback, PacketBatch& batch, int count)
+{
+    struct pcap_pkthdr header;
+    const uint8_t*     packet;
+
+    int processed{0};
+    while(!stopped.load(std::memory_order_relaxed))
+    {
+        if(!next(header, packet))
+        {
+            flush(user, callback, batch);
+            return true; // end of file
+        }
+
+        batch.add(header, packet); // mapping is valid until destruction
+
+        if(count > 0 && ++processed == count)
+        {
+            flush(user, callback, batch);
+            return true; // count is exhausted
+        }
+        if(batch.full())
+        {
+            flush(user, callback, batch);
+        }
+    }
+    flush(user, callback, batch);
+    return false;
+}
+
+void MappedFileReader::break_loop()
+{
+    stopped.store(true, std::memory_order_relaxed);
+}
+
+bool MappedFileReader::next(struct pcap_pkthdr& header, const uint8_t*& packet)
+{
+    if(offset + window / 2 >= advised) advise();
+
+    return format == Format::PCAP ? next_pcap(header, packet)
+                                  : next_pcapng(header, packet);
+}
+
+bool MappedFileReader::next_pcap(struct pcap_pkthdr& header, const uint8_t*& packet)
+{
+    if(offset + record_header_size > size)
+    {
+        if(offset != size) LOGONCE("trace file %s is truncated", source.c_str());
+        return false;
+    }
+
+    const uint8_t* record{data + offset};
+    const uint32_t caplen{u32(record + 8)};
+    if(caplen > size - offset - record_header_size)
+    {
+        LOGONCE("trace file %s is truncated", source.c_str());
+        offset = size;
+        return false;
+    }
+
+    const uint32_t fraction{u32(record + 4)};
+    header.ts.tv_sec  = u32(record);
+    header.ts.tv_usec = (nsec ? fraction : fraction * 1000) / unit;
+    header.caplen     = caplen;
+    header.len        = u32(record + 12);
+
+    packet = record + record_header_size;
+    offset += record_header_size + caplen;
+    return true;
+}
+
+bool MappedFileReader::next_pcapng(struct pcap_pkthdr& header, const uint8_t*& packet)
+{
+    while(offset + 12 <= size)
+    {
+        const uint8_t* block{data + offset};
+        const uint32_t type{u32(block)};
+        if(type == pcapng_section_magic)
+        {
+            // byte order of new section is defined by its header
+            read_section_header(block, size - offset);
+        }
+
+        const uint32_t length{u32(block + 4)};
+        if(length < 12 || length % 4 || length > size - offset)
+        {
+            LOGONCE("trace file %s is truncated or corrupted", source.c_str());
+            offset = size;
+            return false;
+        }
+        offset += length;
+
+        uint32_t id;
+        uint64_t timestamp{0};
+        uint32_t caplen;
+        switch(type)
+        {
+        case pcapng_interface_block:
+            read_interface(block, length);
+            continue;
+        case pcapng_enhanced_packet_block:
+            if(length < 32) continue;
+            id        = u32(block + 8);
+            timestamp = (uint64_t{u32(block + 12)} << 32) | u32(block + 16);
+            caplen    = u32(block + 20);
+            header.len = u32(block + 24);
+            packet    = block + 28;
+            if(caplen > length - 32) continue; // corrupted block
+            break;
+        case pcapng_packet_block:
+            if(length < 32) continue;
+            id        = u16(block + 8);
+            timestamp = (uint64_t{u32(block + 12)} << 32) | u32(block + 16);
+            caplen    = u32(block + 20);
+            header.len = u32(block + 24);
+            packet    = block + 28;
+            if(caplen > length - 32) continue; // corrupted block
+            break;
+        case pcapng_simple_packet_block:
+            if(length < 16 || interfaces.empty()) continue;
+            id         = 0;
+            header.len = u32(block + 8);
+            caplen     = std::min(header.len, length - 16);
+            if(interfaces[0].snaplen) caplen = std::min(caplen, interfaces[0].snaplen);
+            packet = block + 12;
+            break;
+        default:
+            continue; // skip all other blocks
+        }
+
+        if(id >= interfaces.size()) continue;
+        const Interface& interface{interfaces[id]};
+        if(interface.linktype != linktype)
+        {
+            LOGONCE("packets of interfaces with datalink different from first one are skipped");
+            continue;
+        }
+
+        header.caplen = caplen;
+        set_timestamp(header, interface, timestamp);
+        return true;
+    }
+
+    if(offset != size)
+    {
+        LOGONCE("trace file %s is truncated", source.c_str());
+        offset = size;
+    }
+    return false;
+}
+
+void MappedFileReader::read_section_header(const uint8_t* block, std::size_t length)
+{
+    if(length < 16)
+    {
+        throw std::runtime_error{"Truncated section header in: " + source};
+    }
+    const uint32_t magic{read_magic(block + 8)};
+    if(magic != pcapng_byte_order_magic && magic != __builtin_bswap32(pcapng_byte_order_magic))
+    {
+        throw std::runtime_error{"Corrupted section header in: " + source};
+    }
+    swapped = (magic != pcapng_byte_order_magic);
+    major   = u16(block + 12);
+    minor   = u16(block + 14);
+    interfaces.clear();
+}
+
+void MappedFileReader::read_interface(const uint8_t* block, uint32_t length)
+{
+    if(length < 20) return;
+
+    Interface interface;
+    interface.linktype   = u16(block + 8);
+    interface.snaplen    = u32(block + 12);
+    interface.resolution = 1000000; // microseconds by default
+    interface.exponent   = 0;
+    interface.offset     = 0;
+
+    // walk options up to trailing block length
+    const uint8_t* option{block + 16};
+    const uint8_t* end{block + length - 4};
+    while(option + 4 <= end)
+    {
+        const uint16_t code{u16(option)};
+        const uint16_t size{u16(option + 2)};
+        const uint8_t* value{option + 4};
+        if(code == pcapng_opt_endofopt || value + size > end) break;
+
+        if(code == pcapng_opt_if_tsresol && size >= 1)
+        {
+            const uint8_t resolution{value[0]};
+            if(resolution & 0x80) // power of 2
+            {
+                interface.resolution = 0;
+                interface.exponent   = resolution & 0x7f;
+            }
+            else // power of 10
+            {
+                interface.resolution = 1;
+                for(uint8_t i = 0; i < resolution && i < 19; ++i)
+                {
+                    interface.resolution *= 10;
+                }
+            }
+        }
+        else if(code == pcapng_opt_if_tsoffset && size >= 8)
+        {
+            // value is 64-bit field in byte order of section
+            uint64_t raw;
+            memcpy(&raw, value, sizeof(raw));
+            interface.offset = int64_t(swapped ? __builtin_bswap64(raw) : raw);
+        }
+
+        option = value + ((size + 3) & ~3);
+    }
+
+    interfaces.push_back(interface);
+}
+
+void MappedFileReader::set_timestamp(struct pcap_pkthdr& header, const Interface& i, uint64_t units) const
+{
+    uint64_t seconds;
+    uint64_t nanoseconds;
+    if(i.resolution) // units are power of 10 parts of second
+    {
+        seconds = units / i.resolution;
+
+        const uint64_t fraction{units % i.resolution};
+        if(i.resolution >= 1000000000)
+        {
+            nanoseconds = fraction / (i.resolution / 1000000000);
+        }
+        else
+        {
+            nanoseconds = fraction * (1000000000 / i.resolution);
+        }
+    }
+    else // units are power of 2 parts of second
+    {
+        const uint8_t  e{std::min<uint8_t>(i.exponent, 63)};
+        const uint64_t fraction{units & ((uint64_t{1} << e) - 1)};
+        seconds     = units >> e;
+        nanoseconds = static_cast<uint64_t>(static_cast<long double>(fraction) * 1000000000 / (uint64_t{1} << e));
+    }
+
+    header.ts.tv_sec  = seconds + i.offset;
+    header.ts.tv_usec = nanoseconds / unit;
+}
+
+void MappedFileReader::advise()
+{
+    // read ahead next window
+    const std::size_t end{std::min(size, advised + window)};
+    if(advised < end)
+    {
+        madvise(const_cast<uint8_t*>(data) + advised, end - advised, MADV_WILLNEED);
+        advised = end;
+    }
+
+    // release pages that are far behind the current position, pages of
+    // packets referenced by queued data are read from the file again
+    if(offset > released + 2 * window)
+    {
+        const std::size_t page{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+        const std::size_t to{(offset - window) & ~(page - 1)};
+        madvise(const_cast<uint8_t*>(data) + released, to - released, MADV_DONTNEED);
+        released = to;
+    }
+}
+
+inline uint16_t MappedFileReader::u16(const uint8_t* p) const
+{
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return swapped ? __builtin_bswap16(value) : value;
+}
+
+inline uint32_t MappedFileReader::u32(const uint8_t* p) const
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return swapped ? __builtin_bswap32(value) : value;
+}
+
+std::ostream& operator<<(std::ostream& out, MappedFileReader& f)
+{
+    out << "Read packets from: " << f.source << " (memory-mapped)\n";
+    const int dlt{f.datalink()};
+    out << "  datalink: " << f.datalink_name(dlt) << " (" << f.datalink_description(dlt) << ")\n";
+    if(f.format == MappedFileReader::Format::PCAPNG)
+    {
+        out << "  format: pcapng " << f.major << '.' << f.minor;
+    }
+    else
+    {
+        out << "  version: " << f.major << '.' << f.minor;
+        if(f.nsec) out << "\n  Note: file has nanosecond timestamps";
+    }
+    if(f.swapped) out << "\n  Note: file has data in swapped byte-order";
+    return out;
+}
+
+} // namespace pcap
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Read packets from memory-mapped pcap and pcapng files.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef MAPPED_FILE_READER_H
+#define MAPPED_FILE_READER_H
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "filtration/pcap/base_reader.h"
+#include "utils/pinned_buffer.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+namespace pcap
+{
+// Reader of trace files mapped into memory. It passes pointers into the
+// mapping to callbacks, so packets aren't copied. Supported formats are
+// classic pcap (both byte orders, micro- and nanosecond timestamps) and
+// pcapng (Enhanced, Simple and obsolete Packet Blocks). Other formats and
+// stdin must be read by libpcap's FileReader, see is_supported().
+// The pcap handle is opened "dead" and used for dumping of packets.
+class MappedFileReader final : public BaseReader
+{
+public:
+    explicit MappedFileReader(const std::string& file);
+    ~MappedFileReader() override;
+
+    // is the file a regular file in a format handled by this reader
+    static bool is_supported(const std::string& file);
+
+    // hide BaseReader's libpcap loops
+    bool loop(void* user, pcap_handler callback, int count = 0);
+    bool loop(void* user, batch_handler callback, PacketBatch& batch, int count = 0);
+    void break_loop();
+
+    void print_statistic(std::ostream& /*out*/) const override {}
+
+    // packets stay in the mapping, so they are referenced instead of copy
+    inline utils::PinnedBuffer* pin() const { return mapping; }
+
+    friend std::ostream& operator<<(std::ostream& out, MappedFileReader& f);
+
+private:
+    enum class Format
+    {
+        PCAP,
+        PCAPNG,
+    };
+
+    struct Interface // pcapng Interface Description Block
+    {
+        int      linktype;
+        uint32_t snaplen;
+        uint64_t resolution; // units per second, 0 means power of 2
+        uint8_t  exponent;   // power of 2 if resolution is 0
+        int64_t  offset;     // seconds added to timestamps
+    };
+
+    bool next(struct pcap_pkthdr& header, const uint8_t*& packet);
+    bool next_pcap(struct pcap_pkthdr& header, const uint8_t*& packet);
+    bool next_pcapng(struct pcap_pkthdr& header, const uint8_t*& packet);
+    void read_section_header(const uint8_t* block, std::size_t length);
+    void read_interface(const uint8_t* block, uint32_t length);
+    void set_timestamp(struct pcap_pkthdr& header, const Interface& i, uint64_t units) const;
+    void advise();
+
+    inline uint16_t u16(const uint8_t* p) const;
+    inline uint32_t u32(const uint8_t* p) const;
+
+    int                  fd;
+    const uint8_t*       data;
+    utils::PinnedBuffer* mapping; // owner of data
+    std::size_t          size;
+    std::size_t          offset;   // position of next record
+    std::size_t          advised;  // end of region advised to be read ahead
+    std::size_t          released; // begin of region that wasn't released
+
+    Format   format;
+    bool     swapped;
+    bool     nsec;
+    uint32_t unit; // nanoseconds in unit of timestamps passed to callbacks
+    int      linktype;
+    uint32_t snaplen;
+    uint16_t major;
+    uint16_t minor;
+
+    std::vector<Interface> interfaces; // of current pcapng section
+
+    std::atomic<bool> stopped;
+};
+
+} // namespace pcap
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // MAPPED_FILE_READER_H
+//------------------------------------------------------------------------------
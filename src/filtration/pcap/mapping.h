@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Memory mapping of reader pinned by references to packets.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef MAPPING_H
+#define MAPPING_H
+//------------------------------------------------------------------------------
+#include <cstddef>
+
+#include <sys/mman.h>
+
+#include "utils/pinned_buffer.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+namespace pcap
+{
+// Mapped memory is unmapped by the last release, so packets referenced by
+// queued data stay valid after destruction of reader
+class Mapping final : public utils::PinnedBuffer
+{
+public:
+    Mapping(void* address, std::size_t length)
+        : addr{address}
+        , size{length}
+    {
+    }
+
+private:
+    ~Mapping() override
+    {
+        munmap(addr, size);
+    }
+
+    void* const       addr;
+    const std::size_t size;
+};
+
+// Part of mapping which is reused by reader when it isn't pinned
+class MappingPart final : public utils::PinnedBuffer
+{
+public:
+    explicit MappingPart(utils::PinnedBuffer* mapping)
+        : whole{mapping}
+    {
+        whole->acquire();
+    }
+
+private:
+    ~MappingPart() override
+    {
+        whole->release();
+    }
+
+    utils::PinnedBuffer* const whole;
+};
+
+} // namespace pcap
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // MAPPING_H
+//------------------------------------------------------------------------------
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Batch of captured packets passed to filtration at once.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef PACKET_BATCH_H
+#define PACKET_BATCH_H
+//------------------------------------------------------------------------------
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include <pcap/pcap.h>
+
+#include "utils/noncopyable.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+namespace pcap
+{
+// Sequence of up to capacity() packets. Packets are either referenced in
+// place (readers of memory-mapped rings and files keep them valid until the
+// batch is handled) or copied to the internal buffer (libpcap reuses its
+// buffer on each pcap_next_ex() call).
+class PacketBatch final : utils::noncopyable
+{
+public:
+    struct Frame final
+    {
+        struct pcap_pkthdr header;
+        const uint8_t*     packet;
+    };
+
+    PacketBatch(unsigned capacity, std::size_t buffer_size = 0)
+        : frames{new Frame[capacity]}
+        , buffer{new uint8_t[buffer_size]}
+        , max_frames{capacity}
+        , count{0}
+        , buffer_size{buffer_size}
+        , used{0}
+    {
+    }
+
+    // reference packet in place, it must be valid until the batch is cleared
+    inline void add(const pcap_pkthdr& header, const uint8_t* packet)
+    {
+        assert(count < max_frames);
+        frames[count].header = header;
+        frames[count].packet = packet;
+        ++count;
+    }
+
+    // copy packet to internal buffer, return false if there is no room for it
+    inline bool copy(const pcap_pkthdr& header, const uint8_t* packet)
+    {
+        const std::size_t size{(header.caplen + alignment - 1) & ~(alignment - 1)};
+        if(used + size > buffer_size) return false;
+
+        uint8_t* data{buffer.get() + used};
+        memcpy(data, packet, header.caplen);
+        used += size;
+        add(header, data);
+        return true;
+    }
+
+    inline void clear()
+    {
+        count = 0;
+        used  = 0;
+    }
+
+    inline unsigned     size() const { return count; }
+    inline unsigned     capacity() const { return max_frames; }
+    inline bool         empty() const { return count == 0; }
+    inline bool         full() const { return count == max_frames; }
+    inline const Frame& operator[](unsigned i) const { return frames[i]; }
+
+private:
+    static const std::size_t alignment{16};
+
+    std::unique_ptr<Frame[]>   frames;
+    std::unique_ptr<uint8_t[]> buffer;
+    const unsigned             max_frames;
+    unsigned                   count;
+    const std::size_t          buffer_size;
+    std::size_t                used;
+};
+
+// callback for batches of packets like pcap_handler for single packet
+using batch_handler = void (*)(u_char* user, PacketBatch& batch);
+
+} // namespace pcap
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // PACKET_BATCH_H
+//------------------------------------------------------------------------------
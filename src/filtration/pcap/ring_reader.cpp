@@ -0,0 +1,485 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Capture packets from NIC via memory-mapped TPACKET_V3 ring.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "filtration/pcap/bpf.h"
+#include "filtration/pcap/mapping.h"
+#include "filtration/pcap/pcap_error.h"
+#include "filtration/pcap/ring_reader.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+namespace pcap
+{
+#ifdef __linux__
+
+namespace // unnamed
+{
+[[noreturn]] void throw_system_error(const char* func)
+{
+    throw std::system_error{errno, std::system_category(), func};
+}
+
+const unsigned vlan_tag_len{4}; // room for reinsertion of stripped 802.1Q tag
+const unsigned frame_size{2048};
+
+// pass each frame to callback
+struct PacketHandler final
+{
+    inline void packet(const pcap_pkthdr& header, const uint8_t* data)
+    {
+        callback(reinterpret_cast<u_char*>(user), &header, data);
+    }
+    inline void block_end() {}
+
+    void*        user;
+    pcap_handler callback;
+};
+
+// collect frames of block in place and pass them to callback by batches
+struct BatchHandler final
+{
+    inline void packet(const pcap_pkthdr& header, const uint8_t* data)
+    {
+        batch.add(header, data);
+        if(batch.full()) block_end();
+    }
+    inline void block_end()
+    {
+        if(!batch.empty())
+        {
+            callback(reinterpret_cast<u_char*>(user), batch);
+            batch.clear();
+        }
+    }
+
+    void*         user;
+    batch_handler callback;
+    PacketBatch&  batch;
+};
+
+} // unnamed namespace
+
+RingReader::RingReader(const Params& params, unsigned index)
+    : BaseReader{params.interface}
+    , fd{-1}
+    , ring{nullptr}
+    , ring_size{0}
+    , block_size{params.ring_block_size}
+    , block_count{params.ring_block_count}
+    , current{0}
+    , ifindex{0}
+    , member{index}
+    , fanout{params.fanout}
+    , loopback{false}
+    , unit{1000}
+    , timeout_ms{params.timeout_ms}
+    , direction{params.direction}
+    , stopped{false}
+    , mapping{nullptr}
+    , blocks{}
+    , held{}
+    , pinned{nullptr}
+    , packets{0}
+    , drops{0}
+    , freezes{0}
+    , copied{0}
+{
+    const char* device{source.c_str()};
+    ifindex = if_nametoindex(device);
+    if(!ifindex)
+    {
+        throw_system_error("if_nametoindex");
+    }
+
+    // socket with zero protocol doesn't receive packets until bind()
+    fd = ::socket(AF_PACKET, SOCK_RAW, 0);
+    if(fd < 0)
+    {
+        throw_system_error("socket");
+    }
+
+    try
+    {
+        struct ifreq ifr;
+        std::memset(&ifr, 0, sizeof(ifr));
+        std::strncpy(ifr.ifr_name, device, sizeof(ifr.ifr_name) - 1);
+        if(ioctl(fd, SIOCGIFHWADDR, &ifr) < 0)
+        {
+            throw_system_error("ioctl(SIOCGIFHWADDR)");
+        }
+        switch(ifr.ifr_hwaddr.sa_family)
+        {
+        case ARPHRD_LOOPBACK:
+            loopback = true;
+            break;
+        case ARPHRD_ETHER:
+            break;
+        default:
+            throw std::runtime_error{std::string{"TPACKET_V3 ring supports only Ethernet interfaces: "} + device};
+        }
+
+        handle = open_dead(DLT_EN10MB, params.snaplen);
+        unit   = tstamp_unit();
+
+        char        errbuf[PCAP_ERRBUF_SIZE]; // storage of error description
+        bpf_u_int32 localnet, netmask;
+        if(pcap_lookupnet(device, &localnet, &netmask, errbuf) < 0)
+        {
+            throw PcapError("pcap_lookupnet", errbuf);
+        }
+
+        // filter and snaplen are applied by the kernel
+        BPF         bpf(handle, params.filter.c_str(), netmask);
+        sock_fprog  fprog;
+        fprog.len    = static_cast<bpf_program*>(bpf)->bf_len;
+        fprog.filter = reinterpret_cast<sock_filter*>(static_cast<bpf_program*>(bpf)->bf_insns);
+        if(setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) < 0)
+        {
+            throw_system_error("setsockopt(SO_ATTACH_FILTER)");
+        }
+
+        const int version{TPACKET_V3};
+        if(setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0)
+        {
+            throw_system_error("setsockopt(PACKET_VERSION)");
+        }
+
+        const unsigned reserve{vlan_tag_len};
+        if(setsockopt(fd, SOL_PACKET, PACKET_RESERVE, &reserve, sizeof(reserve)) < 0)
+        {
+            throw_system_error("setsockopt(PACKET_RESERVE)");
+        }
+
+        tpacket_req3 req;
+        std::memset(&req, 0, sizeof(req));
+        req.tp_block_size       = block_size;
+        req.tp_block_nr         = block_count;
+        req.tp_frame_size       = frame_size;
+        req.tp_frame_nr         = (block_size / frame_size) * block_count;
+        req.tp_retire_blk_tov   = params.timeout_ms;
+        req.tp_feature_req_word = 0;
+        if(setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0)
+        {
+            throw_system_error("setsockopt(PACKET_RX_RING)");
+        }
+
+        ring_size = std::size_t{block_size} * block_count;
+        void* map{mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)};
+        if(map == MAP_FAILED)
+        {
+            ring = nullptr;
+            throw_system_error("mmap");
+        }
+        ring    = reinterpret_cast<uint8_t*>(map);
+        mapping = new Mapping{map, ring_size};
+        for(unsigned i = 0; i < block_count; ++i)
+        {
+            blocks.push_back(new MappingPart{mapping});
+        }
+        held.reserve(block_count);
+
+        if(params.promisc)
+        {
+            packet_mreq mreq;
+            std::memset(&mreq, 0, sizeof(mreq));
+            mreq.mr_ifindex = ifindex;
+            mreq.mr_type    = PACKET_MR_PROMISC;
+            if(setsockopt(fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+            {
+                throw_system_error("setsockopt(PACKET_ADD_MEMBERSHIP)");
+            }
+        }
+
+        sockaddr_ll addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sll_family   = AF_PACKET;
+        addr.sll_protocol = htons(ETH_P_ALL);
+        addr.sll_ifindex  = ifindex;
+        if(bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+        {
+            throw_system_error("bind");
+        }
+
+        if(fanout > 1)
+        {
+            // the group is unique for the process and the interface, kernel
+            // defragments IP packets before hashing
+            const int group{static_cast<int>((getpid() + ifindex) & 0xffff)};
+            const int arg{group | ((PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG) << 16)};
+            if(setsockopt(fd, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)) < 0)
+            {
+                throw_system_error("setsockopt(PACKET_FANOUT)");
+            }
+        }
+    }
+    catch(...)
+    {
+        for(auto block : blocks) block->release();
+        if(mapping) mapping->release();
+        else if(ring) munmap(ring, ring_size);
+        close(fd);
+        throw;
+    }
+}
+
+RingReader::~RingReader()
+{
+    // the ring is unmapped when queued data don't reference its blocks
+    for(auto block : blocks) block->release();
+    mapping->release();
+    close(fd);
+}
+
+bool RingReader::loop(void* user, pcap_handler callback, int count)
+{
+    PacketHandler handler{user, callback};
+    return read_blocks(handler, count);
+}
+
+bool RingReader::loop(void* user, batch_handler callback, PacketBatch& batch, int count)
+{
+    BatchHandler handler{user, callback, batch};
+    return read_blocks(handler, count);
+}
+
+template <typename Handler>
+bool RingReader::read_blocks(Handler& handler, int count)
+{
+    int processed{0};
+    while(!stopped.load(std::memory_order_relaxed))
+    {
+        if(!held.empty())
+        {
+            return_blocks();
+            if(std::find(held.begin(), held.end(), current) != held.end())
+            {
+                // the ring is wrapped, wait for analysis of the block
+                std::this_thread::sleep_for(std::chrono::microseconds{100});
+                continue;
+            }
+        }
+
+        auto  block  = reinterpret_cast<tpacket_block_desc*>(ring + std::size_t{current} * block_size);
+        auto& status = block->hdr.bh1.block_status;
+        if(!(__atomic_load_n(&status, __ATOMIC_ACQUIRE) & TP_STATUS_USER))
+        {
+            pollfd pfd;
+            pfd.fd      = fd;
+            pfd.events  = POLLIN | POLLERR;
+            pfd.revents = 0;
+            if(poll(&pfd, 1, timeout_ms) < 0 && errno != EINTR)
+            {
+                throw_system_error("poll");
+            }
+            continue;
+        }
+
+        // packets are referenced in place until a half of ring is held
+        if(held.size() < block_count / 2)
+        {
+            pinned = blocks[current];
+        }
+        else
+        {
+            pinned = nullptr;
+            ++copied;
+        }
+
+        // walk the retired block in place
+        const uint32_t packets_in_block{block->hdr.bh1.num_pkts};
+        uint8_t*       ptr{reinterpret_cast<uint8_t*>(block) + block->hdr.bh1.offset_to_first_pkt};
+        for(uint32_t i = 0; i < packets_in_block; ++i)
+        {
+            auto frame = reinterpret_cast<tpacket3_hdr*>(ptr);
+            auto sll   = reinterpret_cast<const sockaddr_ll*>(ptr + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+            ptr += frame->tp_next_offset;
+
+            const bool outgoing{sll->sll_pkttype == PACKET_OUTGOING};
+            if((outgoing && (loopback || direction == Direction::IN)) ||
+               (!outgoing && direction == Direction::OUT))
+            {
+                continue; // loopback packets are seen twice
+            }
+
+            struct pcap_pkthdr header;
+            header.ts.tv_sec  = frame->tp_sec;
+            header.ts.tv_usec = frame->tp_nsec / unit;
+            header.caplen     = frame->tp_snaplen;
+            header.len        = frame->tp_len;
+
+            uint8_t* data{reinterpret_cast<uint8_t*>(frame) + frame->tp_mac};
+            if(frame->tp_status & TP_STATUS_VLAN_VALID && header.caplen >= 2 * ETH_ALEN)
+            {
+                // kernel strips 802.1Q tag, move MAC addresses into reserved room and restore it
+                const uint16_t tpid{static_cast<uint16_t>(frame->tp_status & TP_STATUS_VLAN_TPID_VALID ? frame->hv1.tp_vlan_tpid : ETH_P_8021Q)};
+                const uint16_t tci{static_cast<uint16_t>(frame->hv1.tp_vlan_tci)};
+
+                data -= vlan_tag_len;
+                std::memmove(data, data + vlan_tag_len, 2 * ETH_ALEN);
+                data[2 * ETH_ALEN + 0] = tpid >> 8;
+                data[2 * ETH_ALEN + 1] = tpid & 0xff;
+                data[2 * ETH_ALEN + 2] = tci >> 8;
+                data[2 * ETH_ALEN + 3] = tci & 0xff;
+                header.caplen += vlan_tag_len;
+                header.len += vlan_tag_len;
+            }
+
+            handler.packet(header, data);
+        }
+        handler.block_end(); // frames are valid until the block is returned
+
+        if(pinned && pinned->pinned())
+        {
+            held.push_back(current);
+        }
+        else
+        {
+            __atomic_store_n(&status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        }
+        pinned  = nullptr;
+        current = (current + 1) % block_count;
+
+        processed += packets_in_block;
+        if(count > 0 && processed >= count)
+        {
+            return true; // count is exhausted
+        }
+    }
+    return false;
+}
+
+void RingReader::break_loop()
+{
+    stopped.store(true, std::memory_order_relaxed);
+}
+
+// return held blocks which aren't referenced anymore
+void RingReader::return_blocks()
+{
+    for(std::size_t i = 0; i < held.size();)
+    {
+        if(blocks[held[i]]->pinned())
+        {
+            ++i;
+            continue;
+        }
+
+        auto block = reinterpret_cast<tpacket_block_desc*>(ring + std::size_t{held[i]} * block_size);
+        __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+        held[i] = held.back();
+        held.pop_back();
+    }
+}
+
+void RingReader::update_statistic() const
+{
+    tpacket_stats_v3 stat;
+    socklen_t        len{sizeof(stat)};
+    std::memset(&stat, 0, sizeof(stat));
+    if(getsockopt(fd, SOL_PACKET, PACKET_STATISTICS, &stat, &len) < 0)
+    {
+        throw_system_error("getsockopt(PACKET_STATISTICS)");
+    }
+    packets += stat.tp_packets;
+    drops += stat.tp_drops;
+    freezes += stat.tp_freeze_q_cnt;
+}
+
+#else // __linux__
+
+RingReader::RingReader(const Params& params, unsigned)
+    : BaseReader{params.interface}
+{
+    throw std::runtime_error{"TPACKET_V3 ring is supported only on Linux"};
+}
+
+RingReader::~RingReader()
+{
+}
+
+bool RingReader::loop(void*, pcap_handler, int)
+{
+    return false;
+}
+
+bool RingReader::loop(void*, batch_handler, PacketBatch&, int)
+{
+    return false;
+}
+
+void RingReader::break_loop()
+{
+}
+
+void RingReader::return_blocks()
+{
+}
+
+void RingReader::update_statistic() const
+{
+}
+
+#endif // __linux__
+
+void RingReader::print_statistic(std::ostream& out) const
+{
+    update_statistic();
+    out << "Statistics from interface: " << source << " (TPACKET_V3 ring";
+    if(fanout > 1)
+    {
+        out << ", fanout member " << member + 1 << '/' << fanout;
+    }
+    out << ")\n"
+        << "  packets received by filtration: " << packets << '\n'
+        << "  packets dropped by kernel     : " << drops << '\n'
+        << "  ring freeze events            : " << freezes << '\n'
+        << "  blocks copied by filtration   : " << copied;
+}
+
+} // namespace pcap
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
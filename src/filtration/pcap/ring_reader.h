@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Capture packets from NIC via memory-mapped TPACKET_V3 ring.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef RING_READER_H
+#define RING_READER_H
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "filtration/pcap/base_reader.h"
+#include "filtration/pcap/capture_reader.h"
+#include "utils/pinned_buffer.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+namespace pcap
+{
+// Reader of AF_PACKET socket with TPACKET_V3 ring (Linux only).
+// The kernel fills whole blocks of frames, the reader walks each retired
+// block in place and passes frames to the callback without copying, then
+// returns the block to the kernel. Blocks referenced by queued data are held
+// until analysis releases them, up to a half of the ring, later blocks are
+// copied by filtration. The pcap handle is opened "dead" and
+// used only for compilation of BPF and for dumping of captured packets.
+// If Params::fanout > 1 the socket joins PACKET_FANOUT_HASH group of the
+// interface, the kernel distributes packets between member sockets by
+// symmetric flow hash, so both directions of a session are read by the
+// same member.
+class RingReader final : public BaseReader
+{
+public:
+    using Params    = CaptureReader::Params;
+    using Direction = CaptureReader::Direction;
+
+    RingReader(const Params& params, unsigned member = 0 /*index in fanout group*/);
+    ~RingReader() override;
+
+    // hide BaseReader's libpcap loops
+    bool loop(void* user, pcap_handler callback, int count = 0);
+    bool loop(void* user, batch_handler callback, PacketBatch& batch, int count = 0);
+    void break_loop();
+
+    void print_statistic(std::ostream& out) const override;
+
+    // block of packets passed to callbacks or nullptr if they must be copied
+    inline utils::PinnedBuffer* pin() const { return pinned; }
+
+private:
+    template <typename Handler>
+    bool read_blocks(Handler& handler, int count);
+    void return_blocks();
+    void update_statistic() const;
+
+    int               fd;
+    uint8_t*          ring;
+    std::size_t       ring_size;
+    unsigned          block_size;
+    unsigned          block_count;
+    unsigned          current; // index of next block to read
+    unsigned          ifindex;
+    unsigned          member;
+    unsigned          fanout;
+    bool              loopback;
+    uint32_t          unit; // nanoseconds in unit of timestamps
+    int               timeout_ms;
+    Direction         direction;
+
+    std::atomic<bool> stopped;
+
+    utils::PinnedBuffer*              mapping; // owner of ring
+    std::vector<utils::PinnedBuffer*> blocks;  // parts of mapping
+    std::vector<unsigned>             held;    // indexes of blocks referenced by analysis
+    utils::PinnedBuffer*              pinned;  // block being read
+
+    // kernel resets its counters after each read, so accumulate them
+    mutable uint64_t packets;
+    mutable uint64_t drops;
+    mutable uint64_t freezes;
+    uint64_t         copied; // blocks read while a half of ring is held
+};
+
+} // namespace pcap
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // RING_READER_H
+//------------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Bounded set of xids of calls awaiting their replies.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef PENDING_CALLS_H
+#define PENDING_CALLS_H
+//------------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace filtration
+{
+// Replies of some calls are never seen: packets are dropped by kernel or by
+// queues, capture starts in the middle of stream or client gives up the call
+// after reconnect. So the set keeps at most limit xids, the oldest ones are
+// evicted by newer calls. Positions of xids in ring of insertions are mapped
+// to tell a live xid from an erased one which was reused later.
+class PendingCalls
+{
+public:
+    explicit PendingCalls(std::size_t limit = 1024)
+        : capacity{limit}
+        , next{0}
+    {
+    }
+
+    inline std::size_t size() const { return calls.size(); }
+
+    void insert(uint32_t xid)
+    {
+        if(ring.size() < capacity) // ring grows up to limit on demand
+        {
+            ring.push_back(xid);
+        }
+        else
+        {
+            auto evicted = calls.find(ring[next]);
+            if(evicted != calls.end() && evicted->second == next)
+            {
+                calls.erase(evicted);
+            }
+            ring[next] = xid;
+        }
+        calls[xid] = next;
+        next       = (next + 1) % capacity;
+    }
+
+    // return true if xid was awaited
+    inline bool erase(uint32_t xid)
+    {
+        return calls.erase(xid) > 0;
+    }
+
+private:
+    const std::size_t                         capacity;
+    std::size_t                               next;  // position of the next xid in ring
+    std::vector<uint32_t>                     ring;  // xids in order of insertion
+    std::unordered_map<uint32_t, std::size_t> calls; // xid -> its position in ring
+};
+
+} // namespace filtration
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // PENDING_CALLS_H
+//------------------------------------------------------------------------------
@@ -27,6 +27,7 @@
 #include "utils/filtered_data.h"
 #include "utils/log.h"
 #include "utils/noncopyable.h"
+#include "utils/ordered_queues.h"
 #include "utils/sessions.h"
 //------------------------------------------------------------------------------
 namespace NST
@@ -39,12 +40,16 @@ class Queueing final : utils::noncopyable
     using Data  = NST::utils::FilteredData;
 
 public:
+    // only payload of packets is queued
+    static const bool whole_frames{false};
+
     class Collection final : utils::noncopyable
     {
     public:
         Collection() = default;
         inline Collection(Queueing* q, utils::NetworkSession* s) noexcept
             : queue{&q->queue}
+            , ordinal{&q->ordinal}
             , session{s}
         {
         }
@@ -54,6 +59,7 @@ public:
         inline void set(Queueing& q, utils::NetworkSession* s)
         {
             queue   = &q.queue;
+            ordinal = &q.ordinal;
             session = s;
         }
 
@@ -90,28 +96,40 @@ public:
             ptr->resize(amount);
         }
 
-        // Extend input element automatically
+        // Extend input element automatically. Data in memory of reader are
+        // referenced in place, they are copied only if message spans packets,
+        // copies of packets are appended to data without reallocation
         inline void push(const PacketInfo& info, const uint32_t len)
         {
             assert(nullptr != ptr);
 
-            uint8_t*       offset_ptr{ptr->data + ptr->dlen};
-            const uint32_t avail{ptr->capacity() - ptr->dlen};
-            if(len > avail) // inappropriate case. Must be one resize when get entire message size
+            if(info.pin)
             {
-                ptr->resize(ptr->dlen + len);       // [! unbound extension !]
-                offset_ptr = ptr->data + ptr->dlen; // update pointer
+                if(ptr->dlen == 0)
+                {
+                    ptr->reference(info.data, len, info.pin);
+                    return;
+                }
+                if(ptr->precede(info.data, info.pin)) // the same packet
+                {
+                    ptr->extend(len);
+                    return;
+                }
             }
-            memcpy(offset_ptr, info.data, len);
-            ptr->dlen += len;
+            ptr->append(info.data, len);
+        }
+
+        // payload of message is skipped after collected data
+        inline void skip_payload(const PacketInfo& /*info*/)
+        {
+            ptr->payload = ptr->dlen;
         }
 
         // TODO: workaround
         // we should remove RM(uin32_t) from collected data
         inline void skip_first(const uint32_t len)
         {
-            ptr->dlen -= len;
-            ptr->data += len;
+            ptr->skip_first(len);
         }
 
         void complete(const PacketInfo& info)
@@ -122,8 +140,9 @@ public:
             assert(info.direction != utils::Session::Direction::Unknown);
 
             ptr->session   = session;
-            ptr->timestamp = info.header->ts;
             ptr->direction = info.direction;
+            ptr->ordinal   = *ordinal;
+            ptr->set_timestamp(info.timestamp);
 
             queue->push(ptr);
             ptr = nullptr;
@@ -135,12 +154,20 @@ public:
         inline operator bool() const { return ptr != nullptr; }
     private:
         Queue*                 queue{nullptr};
+        const uint64_t*        ordinal{nullptr};
         Queue::Ptr             ptr;
         utils::NetworkSession* session{nullptr};
     };
 
     Queueing(Queue& q)
         : queue(q)
+        , input{nullptr}
+    {
+    }
+    // queue of one of threads filtering the same input in parallel
+    Queueing(utils::OrderedQueues::Input& i)
+        : queue(i.get_queue())
+        , input{&i}
     {
     }
     ~Queueing()
@@ -148,8 +175,34 @@ public:
     }
     Queueing(Queueing&&)      = delete;
 
+    // data completed by the next packet are tagged by its ordinal
+    inline void set_ordinal(uint64_t n)
+    {
+        ordinal = n;
+        if(input && (n % progress_step) == 0)
+        {
+            input->set_progress(n);
+        }
+    }
+
+    // queue data without payload after all data of closed session, the
+    // session can be deleted when analysis marks it as released
+    bool release(utils::NetworkSession* session)
+    {
+        Queue::Ptr ptr{queue.allocate()};
+        ptr->session   = session;
+        ptr->direction = session->direction;
+        ptr->ordinal   = ordinal;
+        queue.push(ptr, false); // it is never dropped
+        return false;
+    }
+
 private:
-    Queue& queue;
+    static const uint64_t progress_step{256}; // packets between updates of progress
+
+    Queue&                       queue;
+    utils::OrderedQueues::Input* input;
+    uint64_t                     ordinal{0};
 };
 
 } // namespace filtration
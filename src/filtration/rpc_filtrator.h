@@ -27,7 +27,9 @@
 
 #include <pcap/pcap.h>
 
+#include "filtration/compound_scanner.h"
 #include "filtration/filtratorimpl.h"
+#include "filtration/pending_calls.h"
 #include "protocols/netbios/netbios.h"
 #include "protocols/nfs3/nfs3_utils.h"
 #include "protocols/nfs4/nfs4_utils.h"
@@ -59,6 +61,25 @@ public:
         BaseImpl::setWriterImpl(session_ptr, w, max_rpc_hdr);
     }
 
+    inline void reset()
+    {
+        continued = false;
+        nfs4_scanner.stop();
+        BaseImpl::reset();
+    }
+
+    // replies of NFSv4 COMPOUND are matched to calls read by peer
+    inline void set_peer(RPCFiltrator& filtrator)
+    {
+        peer = &filtrator;
+    }
+
+    // scan NFSv4 COMPOUND for payload of READ or WRITE to skip it
+    inline size_t scan(const uint8_t* data, size_t len, size_t& payload, bool& /*cut*/)
+    {
+        return nfs4_scanner.scan(data, len, payload);
+    }
+
     constexpr static size_t lengthOfBaseHeader()
     {
         return sizeof(RecordMark) + sizeof(ReplyHeader); // Minimum of replay&call headers
@@ -96,13 +117,21 @@ public:
 
     inline bool collect_header(PacketInfo& info, typename Writer::Collection&)
     {
+        if(continued) // only record mark of the next fragment is read
+        {
+            return BaseImpl::collect_header(info, sizeof(RecordMark), sizeof(RecordMark));
+        }
         return BaseImpl::collect_header(info, lengthOfCallHeader(), lengthOfReplyHeader());
     }
 
     inline bool find_and_read_message(PacketInfo& info, typename Writer::Collection& collection)
     {
         const RecordMark* rm{reinterpret_cast<const RecordMark*>(collection.data())};
-        //if(rm->is_last()); // TODO: handle sequence field of record mark
+        if(continued) // message is read from the first fragment of record, the rest are skipped
+        {
+            continued = !rm->is_last();
+            return BaseImpl::skip_message(rm->fragment_len());
+        }
         if(collection.data_size() < (sizeof(CallHeader) + sizeof(RecordMark)) && (rm->fragment())->type() != MsgType::REPLY) // if message not Reply, try collect the rest for Call
         {
             return true;
@@ -111,6 +140,16 @@ public:
         {
             if(validate_header(rm->fragment(), rm->fragment_len() + sizeof(RecordMark)))
             {
+                continued = !rm->is_last();
+                if(nfs4_scanner.active()) // scan collected bytes following fixed header
+                {
+                    const size_t offset{sizeof(RecordMark) + (rm->fragment()->type() == MsgType::CALL ? sizeof(CallHeader) : sizeof(ReplyHeader))};
+                    size_t       payload{0};
+                    if(collection.data_size() > offset)
+                    {
+                        nfs4_scanner.scan(collection.data() + offset, collection.data_size() - offset, payload);
+                    }
+                }
                 return BaseImpl::read_message(info);
             }
         }
@@ -119,6 +158,7 @@ public:
 
     inline bool validate_header(const MessageHeader* const msg, const size_t len)
     {
+        nfs4_scanner.stop();
         switch(msg->type())
         {
         case MsgType::CALL:
@@ -146,6 +186,11 @@ public:
                 }
                 else if(protocols::NFS4::Validator::check(call))
                 {
+                    if(API::ProcEnumNFS4::COMPOUND == call->proc()) // skip payload of READ and WRITE
+                    {
+                        nfs4_compound_match.insert(call->xid());
+                        nfs4_scanner.call();
+                    }
                     BaseImpl::setToBeCopied(len);
                 }
                 else
@@ -176,6 +221,11 @@ public:
                 }
                 else
                 {
+                    if(peer && peer->nfs4_compound_match.erase(reply->xid()) &&
+                       reply->stat() == ReplyStat::MSG_ACCEPTED)
+                    {
+                        nfs4_scanner.reply(); // skip payload of READ
+                    }
                     BaseImpl::setToBeCopied(len); // length of current RPC message
                 }
                 //TRACE("%p| MATCH RPC Reply xid:%u len: %u", this, reply->xid(), msg_len);
@@ -200,8 +250,12 @@ public:
     }
 
 private:
-    size_t     nfs3_rw_hdr_max{512}; // limit for NFSv3 to truncate WRITE call and READ reply messages
-    MessageSet nfs3_read_match;
+    size_t          nfs3_rw_hdr_max{512}; // limit for NFSv3 to truncate WRITE call and READ reply messages
+    MessageSet      nfs3_read_match;
+    PendingCalls    nfs4_compound_match; // xids of NFSv4 COMPOUND calls
+    CompoundScanner nfs4_scanner;
+    RPCFiltrator*   peer{nullptr};     // filtrator of opposite direction
+    bool            continued{false}; // record continues in the next fragment
 };
 
 } // namespace filtration
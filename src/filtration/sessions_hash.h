@@ -22,23 +22,35 @@
 #ifndef SESSIONS_HASH_H
 #define SESSIONS_HASH_H
 //------------------------------------------------------------------------------
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <memory>
 #include <type_traits>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <pcap/pcap.h>
 
 #include "controller/parameters.h"
 #include "filtration/packet.h"
+#include "utils/crc32c.h"
 #include "utils/noncopyable.h"
 #include "utils/out.h"
 #include "utils/sessions.h"
+#include "utils/timer_wheel.h"
 //------------------------------------------------------------------------------
 namespace NST
 {
 namespace filtration
 {
+// numbers of sessions released by filtration
+struct Evictions
+{
+    uint64_t idle{0};   // by timeout
+    uint64_t closed{0}; // after FIN or RST
+};
+
 struct MapperImpl
 {
     using Session        = NST::utils::Session;
@@ -57,14 +69,28 @@ struct MapperImpl
         return (key.ip.v4.addr[0] < key.ip.v4.addr[1]) ? Session::Source : Session::Destination;
     }
 
+    // keys are canonical: the smaller endpoint is the first, so both
+    // directions of a session have the same key and one comparison matches it
+    static inline void ipv4_canonical(Session& key, Session::Direction direction)
+    {
+        if(direction == Session::Destination)
+        {
+            std::swap(key.port[0], key.port[1]);
+            std::swap(key.ip.v4.addr[0], key.ip.v4.addr[1]);
+        }
+    }
+
+    static inline uint32_t ports(const Session& key)
+    {
+        return uint32_t{key.port[0]} | (uint32_t{key.port[1]} << 16);
+    }
+
     struct IPv4PortsKeyHash final
     {
         inline std::size_t operator()(const Session& key) const
         {
-            return key.port[0] +
-                   key.port[1] +
-                   key.ip.v4.addr[0] +
-                   key.ip.v4.addr[1];
+            const uint32_t words[]{key.ip.v4.addr[0], key.ip.v4.addr[1], ports(key)};
+            return utils::CRC32C::extend(~0u, words, sizeof(words) / sizeof(words[0]));
         }
     };
 
@@ -72,18 +98,9 @@ struct MapperImpl
     {
         inline bool operator()(const Session& a, const Session& b) const
         {
-            if((a.port[0] == b.port[0]) &&
-               (a.port[1] == b.port[1]) &&
-               (a.ip.v4.addr[0] == b.ip.v4.addr[0]) &&
-               (a.ip.v4.addr[1] == b.ip.v4.addr[1]))
-                return true;
-
-            if((a.port[1] == b.port[0]) &&
-               (a.port[0] == b.port[1]) &&
-               (a.ip.v4.addr[1] == b.ip.v4.addr[0]) &&
-               (a.ip.v4.addr[0] == b.ip.v4.addr[1]))
-                return true;
-            return false;
+            return ports(a) == ports(b) &&
+                   a.ip.v4.addr[0] == b.ip.v4.addr[0] &&
+                   a.ip.v4.addr[1] == b.ip.v4.addr[1];
         }
     };
 
@@ -105,6 +122,15 @@ struct MapperImpl
         return (s[3] < d[3]) ? Session::Source : Session::Destination;
     }
 
+    static inline void ipv6_canonical(Session& key, Session::Direction direction)
+    {
+        if(direction == Session::Destination)
+        {
+            std::swap(key.port[0], key.port[1]);
+            std::swap(key.ip.v6.addr_uint32[0], key.ip.v6.addr_uint32[1]);
+        }
+    }
+
     static inline void copy_ipv6(uint32_t dst[4], const uint8_t src[16])
     {
         uint8_t* d{reinterpret_cast<uint8_t*>(dst)};
@@ -115,19 +141,9 @@ struct MapperImpl
     {
         std::size_t operator()(const Session& key) const
         {
-            std::size_t ret = key.port[0] + key.port[1];
-
-            ret += key.ip.v6.addr_uint32[0][0];
-            ret += key.ip.v6.addr_uint32[0][1];
-            ret += key.ip.v6.addr_uint32[0][2];
-            ret += key.ip.v6.addr_uint32[0][3];
-
-            ret += key.ip.v6.addr_uint32[1][0];
-            ret += key.ip.v6.addr_uint32[1][1];
-            ret += key.ip.v6.addr_uint32[1][2];
-            ret += key.ip.v6.addr_uint32[1][3];
-
-            return ret;
+            const uint32_t* addr{key.ip.v6.addr_uint32[0]}; // both addresses
+            const uint32_t  port{ports(key)};
+            return utils::CRC32C::extend(utils::CRC32C::extend(~0u, addr, 8), &port, 1);
         }
     };
 
@@ -143,18 +159,9 @@ struct MapperImpl
 
         bool operator()(const Session& a, const Session& b) const
         {
-            if((a.port[0] == b.port[0]) && (a.port[1] == b.port[1]))
-            {
-                if(eq_ipv6_address(a.ip.v6.addr_uint32[0], b.ip.v6.addr_uint32[0]) && eq_ipv6_address(a.ip.v6.addr_uint32[1], b.ip.v6.addr_uint32[1]))
-                    return true;
-            }
-
-            if((a.port[1] == b.port[0]) && (a.port[0] == b.port[1]))
-            {
-                if(eq_ipv6_address(a.ip.v6.addr_uint32[1], b.ip.v6.addr_uint32[0]) && eq_ipv6_address(a.ip.v6.addr_uint32[0], b.ip.v6.addr_uint32[1]))
-                    return true;
-            }
-            return false;
+            return ports(a) == ports(b) &&
+                   eq_ipv6_address(a.ip.v6.addr_uint32[0], b.ip.v6.addr_uint32[0]) &&
+                   eq_ipv6_address(a.ip.v6.addr_uint32[1], b.ip.v6.addr_uint32[1]);
         }
     };
 };
@@ -170,6 +177,7 @@ struct IPv4TCPMapper final : private MapperImpl
         key.ip.v4.addr[1] = info.ipv4->dst();
 
         info.direction = MapperImpl::ipv4_direction(key);
+        MapperImpl::ipv4_canonical(key, info.direction);
     }
 
     static inline void fill_session(const PacketInfo& info, NetworkSession& session)
@@ -200,6 +208,7 @@ struct IPv4UDPMapper final : private MapperImpl
         key.ip.v4.addr[1] = info.ipv4->dst();
 
         info.direction = MapperImpl::ipv4_direction(key);
+        MapperImpl::ipv4_canonical(key, info.direction);
     }
 
     static inline void fill_session(const PacketInfo& info, NetworkSession& session)
@@ -230,6 +239,7 @@ struct IPv6TCPMapper final : private MapperImpl
         MapperImpl::copy_ipv6(key.ip.v6.addr_uint32[1], info.ipv6->dst());
 
         info.direction = MapperImpl::ipv6_direction(key);
+        MapperImpl::ipv6_canonical(key, info.direction);
     }
 
     static inline void fill_session(const PacketInfo& info, NetworkSession& session)
@@ -260,6 +270,7 @@ struct IPv6UDPMapper final : private MapperImpl
         MapperImpl::copy_ipv6(key.ip.v6.addr_uint32[1], info.ipv6->dst());
 
         info.direction = MapperImpl::ipv6_direction(key);
+        MapperImpl::ipv6_canonical(key, info.direction);
     }
 
     static inline void fill_session(const PacketInfo& info, NetworkSession& session)
@@ -279,65 +290,317 @@ struct IPv6UDPMapper final : private MapperImpl
     using KeyEqual = MapperImpl::IPv6PortsKeyEqual;
 };
 
-// SessionsHash creates sessions and stores them in hash
+// Open addressing hash table of pointers to nodes with canonical keys.
+// Slots keep hashes of keys, so probing compares keys only on matching hash.
+// Collisions are resolved by linear probing, erased slots are filled by
+// backward shift of following nodes, so there are no tombstones.
+template <
+    typename Node, // has member key
+    typename KeyHash,
+    typename KeyEqual>
+class SessionsTable final : utils::noncopyable
+{
+    struct Slot
+    {
+        std::size_t hash;
+        Node*       node; // nullptr if slot is empty
+    };
+
+public:
+    explicit SessionsTable(std::size_t capacity = 1024) // power of 2
+        : slots(capacity, Slot{0, nullptr})
+        , mask{capacity - 1}
+        , count{0}
+    {
+        assert((capacity & mask) == 0);
+    }
+
+    inline std::size_t size() const { return count; }
+    inline std::size_t capacity() const { return slots.size(); }
+
+    Node* find(const utils::Session& key) const
+    {
+        return find(key, KeyHash{}(key));
+    }
+
+    // hash is KeyHash of key computed before, e.g. by prefetch_bucket() caller
+    Node* find(const utils::Session& key, std::size_t hash) const
+    {
+        for(std::size_t i = hash & mask;; i = (i + 1) & mask)
+        {
+            const Slot& slot{slots[i]};
+            if(!slot.node) return nullptr;
+            if(slot.hash == hash && KeyEqual{}(slot.node->key, key)) return slot.node;
+        }
+    }
+
+    // fetch home slot of hash to cache before find(key, hash)
+    inline void prefetch_bucket(std::size_t hash) const
+    {
+        __builtin_prefetch(&slots[hash & mask]);
+    }
+
+    // node with the same key mustn't be in table
+    void insert(Node* node)
+    {
+        if((count + 1) * 4 > slots.size() * 3) // keep load factor <= 0.75
+        {
+            grow();
+        }
+        place(KeyHash{}(node->key), node);
+        ++count;
+    }
+
+    void erase(const Node* node)
+    {
+        std::size_t i{KeyHash{}(node->key) & mask};
+        while(slots[i].node != node)
+        {
+            assert(slots[i].node);
+            i = (i + 1) & mask;
+        }
+
+        // shift back following nodes which aren't in their home slots
+        for(std::size_t j = (i + 1) & mask; slots[j].node; j = (j + 1) & mask)
+        {
+            const std::size_t home{slots[j].hash & mask};
+            if(((j - home) & mask) >= ((j - i) & mask))
+            {
+                slots[i] = slots[j];
+                i        = j;
+            }
+        }
+        slots[i] = Slot{0, nullptr};
+        --count;
+    }
+
+    template <typename Visitor>
+    void for_each(Visitor visit) const
+    {
+        for(const Slot& slot : slots)
+        {
+            if(slot.node) visit(slot.node);
+        }
+    }
+
+private:
+    void place(std::size_t hash, Node* node)
+    {
+        std::size_t i{hash & mask};
+        while(slots[i].node)
+        {
+            i = (i + 1) & mask;
+        }
+        slots[i] = Slot{hash, node};
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old(slots.size() * 2, Slot{0, nullptr});
+        old.swap(slots);
+        mask = slots.size() - 1;
+        for(const Slot& slot : old)
+        {
+            if(slot.node) place(slot.hash, slot.node);
+        }
+    }
+
+    std::vector<Slot> slots;
+    std::size_t       mask;
+    std::size_t       count;
+};
+
+// SessionsHash creates sessions and stores them in hash. Sessions idle for
+// timeout or closed by FIN/RST are removed from hash by timer wheel driven by
+// timestamps of packets. Writer may refer to removed session until it
+// marks the session as released, so it is deleted later.
 template <
     typename Mapper,      // map PacketInfo& to SessionImpl*
     typename SessionImpl, // mapped type
     typename Writer>
 class SessionsHash final : utils::noncopyable
 {
+    // session with its key and state of eviction, allocated once, so
+    // pointers to nodes stay valid while table grows
+    struct Node
+    {
+        Node(const utils::Session& k, uint64_t timestamp, Writer* w, uint32_t max_hdr, PacketPool& p)
+            : key(k)
+            , last{timestamp}
+            , tick{0}
+            , closing{0}
+            , session{w, max_hdr, p}
+        {
+        }
+
+        const utils::Session key;
+        uint64_t             last;    // timestamp of last packet
+        uint64_t             tick;    // of scheduled timer, 0 - not scheduled
+        uint64_t             closing; // tick of release after FIN or RST, 0 - open
+        SessionImpl          session;
+    };
+
 public:
-    static_assert(std::is_convertible<SessionImpl, utils::NetworkSession>::value,
+    static_assert(std::is_convertible<SessionImpl*, utils::NetworkSession*>::value,
                   "SessionImpl must be convertible to utils::NetworkSession");
 
-    using Container = std::unordered_map<utils::Session, SessionImpl*,
-                                         typename Mapper::KeyHash,
-                                         typename Mapper::KeyEqual>;
+    using Container = SessionsTable<Node,
+                                    typename Mapper::KeyHash,
+                                    typename Mapper::KeyEqual>;
 
-    SessionsHash(Writer* w)
+    static const uint64_t tick_ns{1000000000}; // resolution of timeouts
+    static const uint64_t linger{2};           // ticks after FIN or RST
+
+    SessionsHash(Writer* w, PacketPool& p)
         : sessions{}
         , writer{w}
+        , pool(p)
         , max_hdr{0}
+        , timeout{0}
     {
         max_hdr = controller::Parameters::rpcmsg_limit();
+        timeout = controller::Parameters::session_timeout();
     }
     ~SessionsHash()
     {
-        for(auto& s : sessions)
+        sessions.for_each([](Node* node) { delete node; });
+        for(auto node : retired)
         {
-            delete s.second;
+            delete node;
         }
     }
 
-    void collect_packet(PacketInfo& info)
+    // Batch of packets is looked up in two passes: hashes of all keys are
+    // computed and their slots are prefetched, then slots are probed and found
+    // sessions are prefetched. So cache misses of packets overlap.
+    inline void prefetch_bucket(std::size_t hash) const
     {
-        utils::Session key;
-        Mapper::fill_hash_key(info, key);
+        sessions.prefetch_bucket(hash);
+    }
 
-        auto i = sessions.find(key);
-        if(i == sessions.end())
+    // find session by key and its hash and prefetch it, return nullptr if
+    // not found
+    void* prefetch(const utils::Session& key, std::size_t hash) const
+    {
+        Node* node{sessions.find(key, hash)};
+        if(node)
         {
-            std::unique_ptr<SessionImpl> ptr{new SessionImpl{writer, max_hdr}};
+            __builtin_prefetch(&node->last, 1);
+            __builtin_prefetch(&node->session);
+            __builtin_prefetch(reinterpret_cast<const char*>(&node->session) + 64);
+        }
+        return node;
+    }
 
-            auto res = sessions.emplace(key, ptr.get());
-            if(res.second) // add new - success
+    // collect packet to session found by prefetch() or to found/created one
+    void collect_packet(PacketInfo& info, void* found = nullptr)
+    {
+        Node* node{static_cast<Node*>(found)};
+        if(!node)
+        {
+            utils::Session key;
+            Mapper::fill_hash_key(info, key);
+
+            node = sessions.find(key);
+            if(!node)
             {
-                ptr.release();
-                i = res.first;
+                std::unique_ptr<Node> ptr{new Node{key, info.timestamp, writer, max_hdr, pool}};
+                sessions.insert(ptr.get());
+                node = ptr.release();
 
                 // fill new session after construction
-                utils::NetworkSession& session = *(res.first->second);
+                utils::NetworkSession& session = node->session;
                 Mapper::fill_session(info, session);
+
+                if(timeout)
+                {
+                    schedule(*node, info.timestamp / tick_ns + timeout);
+                }
             }
         }
 
-        i->second->collect(info);
+        node->session.collect(info);
+        node->last = info.timestamp;
+
+        if(!node->closing && node->session.closed())
+        {
+            node->closing = info.timestamp / tick_ns + linger;
+            if(!node->tick || node->closing < node->tick)
+            {
+                schedule(*node, node->closing);
+            }
+        }
     }
 
+    // remove sessions expired at timestamp now and delete released ones,
+    // sessions found by prefetch() before become invalid
+    void expire(uint64_t now)
+    {
+        const uint64_t tick{now / tick_ns};
+        if(tick <= wheel.now()) return; // once per tick
+
+        wheel.advance(tick, [this, tick](const utils::Session& key, uint64_t scheduled) {
+            Node* node{sessions.find(key)};
+            if(!node || node->tick != scheduled) return; // stale timer
+
+            const uint64_t idle{timeout ? node->last / tick_ns + timeout : std::numeric_limits<uint64_t>::max()};
+            const uint64_t deadline{node->closing ? std::min(node->closing, idle) : idle};
+            if(deadline > tick)
+            {
+                schedule(*node, deadline);
+                return;
+            }
+
+            if(node->closing) ++evictions.closed;
+            else ++evictions.idle;
+            retire(node);
+        });
+
+        for(std::size_t i = 0; i < retired.size();)
+        {
+            if(retired[i]->session.released.load(std::memory_order_acquire))
+            {
+                delete retired[i];
+                retired[i] = retired.back();
+                retired.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    const Evictions& evicted() const { return evictions; }
+
 private:
-    Container sessions;
-    Writer*   writer;
-    uint32_t  max_hdr;
+    void schedule(Node& node, uint64_t tick)
+    {
+        node.tick = std::max(tick, wheel.now() + 1);
+        wheel.schedule(node.key, node.tick);
+    }
+
+    void retire(Node* node)
+    {
+        sessions.erase(node);
+        if(writer->release(&node->session))
+        {
+            delete node;
+        }
+        else
+        {
+            retired.push_back(node);
+        }
+    }
+
+    Container                         sessions;
+    Writer*                           writer;
+    PacketPool&                       pool;
+    uint32_t                          max_hdr;
+    uint64_t                          timeout; // in ticks, 0 - never
+    utils::TimerWheel<utils::Session> wheel;
+    std::vector<Node*>                retired; // until released by writer
+    Evictions                         evictions;
 };
 
 } // namespace filtration
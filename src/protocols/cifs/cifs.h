@@ -215,8 +215,8 @@ inline const Cmd command(Data& request, Data& response, Session* session)
     Cmd cmd;
     cmd.session = session;
     // Set time stamps
-    cmd.ctimestamp = &request->timestamp;
-    cmd.rtimestamp = &response->timestamp;
+    cmd.ctimestamp = &request->timestamp.tv;
+    cmd.rtimestamp = &response->timestamp.tv;
 
     return cmd;
 }
@@ -171,8 +171,8 @@ inline const Cmd command(Data& request, Data& response, Session* session)
     Cmd cmd;
     cmd.session = session;
     // Set time stamps
-    cmd.ctimestamp = &request->timestamp;
-    cmd.rtimestamp = response ? &response->timestamp : &request->timestamp;
+    cmd.ctimestamp = &request->timestamp.tv;
+    cmd.rtimestamp = response ? &response->timestamp.tv : &request->timestamp.tv;
 
     //
     // Since we have to modify structures before command creation
@@ -42,17 +42,22 @@ struct ethernet_header
 
     enum EtherType
     {
-        PUP      = 0x0200, // Xerox PUP
-        SPRITE   = 0x0500, // Sprite
-        IP       = 0x0800, // IP
-        ARP      = 0x0806, // Address resolution
-        REVARP   = 0x8035, // Reverse ARP
-        AT       = 0x809B, // AppleTalk protocol
-        AARP     = 0x80F3, // AppleTalk ARP
-        VLAN     = 0x8100, // IEEE 802.1Q VLAN tagging
-        IPX      = 0x8137, // IPX
-        IPV6     = 0x86dd, // IP protocol version 6
-        LOOPBACK = 0x9000  // used to test interfaces
+        PUP       = 0x0200, // Xerox PUP
+        SPRITE    = 0x0500, // Sprite
+        IP        = 0x0800, // IP
+        ARP       = 0x0806, // Address resolution
+        ERSPAN3   = 0x22eb, // ERSPAN Type III
+        TEB       = 0x6558, // Transparent Ethernet Bridging
+        REVARP    = 0x8035, // Reverse ARP
+        AT        = 0x809B, // AppleTalk protocol
+        AARP      = 0x80F3, // AppleTalk ARP
+        VLAN      = 0x8100, // IEEE 802.1Q VLAN tagging
+        IPX       = 0x8137, // IPX
+        IPV6      = 0x86dd, // IP protocol version 6
+        QINQ      = 0x88a8, // IEEE 802.1ad Service VLAN tagging
+        ERSPAN    = 0x88be, // ERSPAN Type I and II
+        LOOPBACK  = 0x9000, // used to test interfaces
+        QINQ_9100 = 0x9100  // pre-standard QinQ tagging
     };
 
     uint8_t  eth_dhost[ADDR_LEN]; // destination host address
@@ -67,6 +72,41 @@ struct EthernetHeader : private ethernet_header
     inline uint16_t       type() const { return ntohs(eth_type); }
 } __attribute__((__packed__));
 
+// IEEE 802.1Q tag, follows addresses of Ethernet header (or another tag)
+// the EtherType of tag is already read as type of outer header
+struct vlan_header
+{
+    uint16_t vlan_tci;  // priority, drop eligible indicator and VLAN ID
+    uint16_t vlan_type; // protocol of encapsulated frame (EtherType values)
+} __attribute__((packed));
+
+struct VLANHeader : private vlan_header
+{
+    inline uint16_t id() const { return ntohs(vlan_tci) & 0x0fff; }
+    inline uint16_t type() const { return ntohs(vlan_type); }
+} __attribute__((__packed__));
+
+// Linux cooked capture header (DLT_LINUX_SLL), used for capture on "any"
+struct sll_header
+{
+    enum
+    {
+        ADDR_LEN = 8
+    };
+
+    uint16_t sll_pkttype;        // packet type (to us, broadcast, outgoing...)
+    uint16_t sll_hatype;         // link-layer address type (ARPHRD_ values)
+    uint16_t sll_halen;          // link-layer address length
+    uint8_t  sll_addr[ADDR_LEN]; // link-layer address
+    uint16_t sll_protocol;       // protocol (EtherType values)
+} __attribute__((packed));
+
+struct SLLHeader : private sll_header
+{
+    inline uint16_t packet_type() const { return ntohs(sll_pkttype); }
+    inline uint16_t type() const { return ntohs(sll_protocol); }
+} __attribute__((__packed__));
+
 } // namespace ethernet
 } // namespace protocols
 } // namespace NST
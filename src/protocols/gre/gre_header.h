@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Definition of GRE and ERSPAN headers.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef GRE_HEADER_H
+#define GRE_HEADER_H
+//------------------------------------------------------------------------------
+#include <cstdint>
+
+#include <arpa/inet.h> // for ntohs()
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace protocols
+{
+namespace gre
+{
+// Generic Routing Encapsulation RFC 2784, RFC 2890
+struct gre_header
+{
+    enum Flags
+    {
+        CHECKSUM = 0x8000, // checksum and reserved fields are present
+        ROUTING  = 0x4000, // routing field is present (RFC 1701, deprecated)
+        KEY      = 0x2000, // key field is present
+        SEQUENCE = 0x1000, // sequence number field is present
+        VERSION  = 0x0007  // 0 - GRE, 1 - enhanced GRE of PPTP
+    };
+
+    uint16_t gre_flags;    // flags and version
+    uint16_t gre_protocol; // protocol of payload (EtherType values)
+} __attribute__((packed));
+
+struct GREHeader : private gre_header
+{
+    inline uint16_t flags() const { return ntohs(gre_flags); }
+    inline uint16_t version() const { return flags() & VERSION; }
+    inline uint16_t protocol() const { return ntohs(gre_protocol); }
+
+    // length of header with optional fields
+    inline uint32_t length() const
+    {
+        const uint16_t f{flags()};
+        return sizeof(gre_header) + ((f & CHECKSUM) ? 4 : 0) + ((f & KEY) ? 4 : 0) + ((f & SEQUENCE) ? 4 : 0);
+    }
+} __attribute__((__packed__));
+
+// Encapsulated Remote SPAN Type II, follows GRE header with sequence number
+struct erspan2_header
+{
+    uint16_t ers_ver_vlan;    // version (1) and original VLAN
+    uint16_t ers_cos_session; // class of service, encapsulation, truncated flag and session ID
+    uint32_t ers_index;       // reserved and port index
+} __attribute__((packed));
+
+// Encapsulated Remote SPAN Type III
+struct erspan3_header
+{
+    enum
+    {
+        OPTIONAL = 0x0001 // platform specific subheader follows
+    };
+
+    uint16_t ers_ver_vlan;    // version (2) and original VLAN
+    uint16_t ers_cos_session; // class of service, BSO, truncated flag and session ID
+    uint32_t ers_timestamp;   // timestamp in units of granularity
+    uint16_t ers_sgt;         // security group tag
+    uint16_t ers_flags;       // P, frame type, hardware ID, direction, granularity, O
+} __attribute__((packed));
+
+struct ERSPANHeader : private erspan3_header
+{
+    inline uint8_t version() const { return ntohs(ers_ver_vlan) >> 12; }
+
+    // length of Type II or Type III header with optional subheader
+    inline uint32_t length() const
+    {
+        if(version() == 1) return sizeof(erspan2_header);
+        return sizeof(erspan3_header) + ((ntohs(ers_flags) & OPTIONAL) ? 8 : 0);
+    }
+} __attribute__((__packed__));
+
+} // namespace gre
+} // namespace protocols
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // GRE_HEADER_H
+//------------------------------------------------------------------------------
@@ -70,6 +70,7 @@ struct IPv4Header : private ipv4_header
     inline uint8_t  version()  const { return ipv4_vhl >> 4;        }
     inline uint8_t  ihl()      const { return (ipv4_vhl & 0x0f) << 2 /* *4 */; } // return number of bytes
     inline uint16_t length()   const { return ntohs(ipv4_len);      }
+    inline uint16_t id()       const { return ntohs(ipv4_id);       }
     inline uint16_t offset()   const { return (ntohs(ipv4_fragmentation) & OFFMASK) << 3 /* *8 */; } // return number of bytes
     inline uint8_t  protocol() const { return ipv4_protocol;        }
     inline in_addr_t src()     const { return ipv4_src;             }
@@ -77,6 +78,7 @@ struct IPv4Header : private ipv4_header
     inline uint16_t checksum() const { return ntohs(ipv4_checksum); }
 
     inline bool is_fragmented() const { return ipv4_fragmentation & htons(MF | OFFMASK); }
+    inline bool more_fragments() const { return ipv4_fragmentation & htons(MF); }
     inline bool is_fragmented_and_not_the_first_part() const
     {
         return ipv4_fragmentation & htons(OFFMASK) /*offset() != 0*/;
@@ -100,8 +100,8 @@ public:
 
         session = s;
 
-        ctimestamp = &c.data().timestamp;
-        rtimestamp = &r.data().timestamp;
+        ctimestamp = &c.data().timestamp.tv;
+        rtimestamp = &r.data().timestamp.tv;
     }
 
     inline ~NFSProcedure()
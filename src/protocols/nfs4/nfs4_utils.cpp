@@ -24,6 +24,7 @@
 #include "api/plugin_api.h" // for NST_PUBLIC
 #include "protocols/nfs/nfs_utils.h"
 #include "protocols/nfs4/nfs4_utils.h"
+#include "protocols/xdr/xdr_decoder.h"
 //------------------------------------------------------------------------------
 using namespace NST::API::NFS4;
 using namespace NST::protocols::NFS; // NFS helpers
@@ -3118,7 +3119,7 @@ xdr_READ4resok (XDR* xdrs, READ4resok* objp)
     {
         return FALSE;
     }
-    if (!xdr_bytes (xdrs, (char**)&objp->data.data_val, (u_int*) &objp->data.data_len, ~0))
+    if (!xdr::xdr_payload (xdrs, (char**)&objp->data.data_val, (u_int*) &objp->data.data_len))
     {
         return FALSE;
     }
@@ -3651,7 +3652,7 @@ xdr_WRITE4args (XDR* xdrs, WRITE4args* objp)
     {
         return FALSE;
     }
-    if (!xdr_bytes (xdrs, (char**)&objp->data.data_val, (u_int*) &objp->data.data_len, ~0))
+    if (!xdr::xdr_payload (xdrs, (char**)&objp->data.data_val, (u_int*) &objp->data.data_len))
     {
         return FALSE;
     }
@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Definition of VXLAN header and constants.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef VXLAN_HEADER_H
+#define VXLAN_HEADER_H
+//------------------------------------------------------------------------------
+#include <cstdint>
+
+#include <arpa/inet.h> // for ntohl()
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace protocols
+{
+namespace vxlan
+{
+// Virtual eXtensible Local Area Network RFC 7348
+struct vxlan_header
+{
+    enum
+    {
+        PORT = 4789, // IANA assigned UDP destination port
+        VNI  = 0x08  // VXLAN Network Identifier is valid
+    };
+
+    uint8_t  vxlan_flags;       // I flag, others are reserved
+    uint8_t  vxlan_reserved[3]; // reserved
+    uint32_t vxlan_vni;         // VXLAN Network Identifier and reserved byte
+} __attribute__((packed));
+
+struct VXLANHeader : private vxlan_header
+{
+    inline bool     valid() const { return vxlan_flags & VNI; }
+    inline uint32_t vni() const { return ntohl(vxlan_vni) >> 8; }
+} __attribute__((__packed__));
+
+} // namespace vxlan
+} // namespace protocols
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // VXLAN_HEADER_H
+//------------------------------------------------------------------------------
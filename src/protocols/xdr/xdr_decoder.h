@@ -22,13 +22,16 @@
 #ifndef XDR_DECODER_H
 #define XDR_DECODER_H
 //------------------------------------------------------------------------------
-#include <utility>
+#include <cstring>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 #include <rpc/rpc.h>
 //------------------------------------------------------------------------------
 #include "api/nfs3_types_rpcgen.h"
 #include "utils/filtered_data.h"
+#include "utils/noncopyable.h"
 //------------------------------------------------------------------------------
 using NST::utils::FilteredData;
 using NST::utils::FilteredDataQueue;
@@ -48,13 +51,31 @@ public:
     }
 };
 
-class XDRDecoder
+// Decoder of XDR data. Contiguous data are decoded by memory stream of RPC
+// library, data in chunks are decoded by own stream walking through parts
+// of FilteredData without flattening them
+class XDRDecoder : utils::noncopyable
 {
 public:
     XDRDecoder(FilteredDataQueue::Ptr&& p)
         : ptr{std::move(p)}
     {
-        xdrmem_create(&txdr, (char*)ptr->data, ptr->dlen, XDR_DECODE);
+        if(nullptr == ptr->tail())
+        {
+            xdrmem_create(&txdr, (char*)ptr->data, ptr->dlen, XDR_DECODE);
+        }
+        else
+        {
+            txdr.x_op      = XDR_DECODE;
+            txdr.x_ops     = &chunked_ops();
+            txdr.x_public  = nullptr;
+            txdr.x_private = this;
+            txdr.x_base    = nullptr;
+            txdr.x_handy   = 0;
+            seek(0);
+        }
+        // offset of payload skipped by filtration for xdr_payload()
+        txdr.x_public = ptr->payload ? reinterpret_cast<char*>(&ptr->payload) : nullptr;
     }
     ~XDRDecoder()
     {
@@ -64,10 +85,184 @@ public:
     XDR*                xdr() { return &txdr; }
     const FilteredData& data() const { return *ptr; }
 private:
+    using Chunk = FilteredData::Chunk;
+    using Ops   = std::remove_const_t<std::remove_pointer_t<decltype(XDR::x_ops)>>;
+
+    static inline XDRDecoder* self(const XDR* xdrs)
+    {
+        return static_cast<XDRDecoder*>(xdrs->x_private);
+    }
+
+    // Set current part to one which contains position, end of data is allowed
+    bool seek(uint32_t position)
+    {
+        if(position > ptr->dlen) return false;
+
+        next   = ptr->tail();
+        offset = 0;
+        begin  = ptr->data;
+        end    = ptr->data + ptr->head_length();
+        while(position - offset > uint32_t(end - begin) && next)
+        {
+            offset += uint32_t(end - begin);
+            step();
+        }
+        pos = begin + (position - offset);
+        return true;
+    }
+
+    inline void step()
+    {
+        begin = next->bytes();
+        end   = next->bytes() + next->length;
+        next  = next->next;
+    }
+
+    bool read(char* addr, uint32_t len)
+    {
+        while(len)
+        {
+            if(pos == end)
+            {
+                if(nullptr == next) return false;
+                offset += uint32_t(end - begin);
+                step();
+                pos = begin;
+            }
+            const uint32_t room{uint32_t(end - pos)};
+            const uint32_t n{len < room ? len : room};
+            memcpy(addr, pos, n);
+            pos += n;
+            addr += n;
+            len -= n;
+        }
+        return true;
+    }
+
+    // Operations of stream. Their signatures differ between RPC libraries,
+    // so they are templates deduced from pointers in xdr_ops
+    template <typename X, typename L>
+    static bool_t getlong(X* xdrs, L* lp)
+    {
+        int32_t word;
+        if(!self(xdrs)->read(reinterpret_cast<char*>(&word), sizeof(word))) return FALSE;
+        const int32_t* buf{&word};
+        *lp = IXDR_GET_LONG(buf);
+        return TRUE;
+    }
+    template <typename X, typename I>
+    static bool_t getint32(X* xdrs, I* ip)
+    {
+        int32_t word;
+        if(!self(xdrs)->read(reinterpret_cast<char*>(&word), sizeof(word))) return FALSE;
+        *ip = static_cast<I>(ntohl(word));
+        return TRUE;
+    }
+    template <typename X, typename V>
+    static bool_t put(X*, V*)
+    {
+        return FALSE; // decoding only
+    }
+    template <typename X>
+    static bool_t getbytes(X* xdrs, char* addr, u_int len)
+    {
+        return self(xdrs)->read(addr, len) ? TRUE : FALSE;
+    }
+    template <typename X>
+    static bool_t putbytes(X*, const char*, u_int)
+    {
+        return FALSE;
+    }
+    template <typename X>
+    static u_int getpostn(X* xdrs)
+    {
+        const XDRDecoder* d{self(xdrs)};
+        return d->offset + uint32_t(d->pos - d->begin);
+    }
+    template <typename X>
+    static bool_t setpostn(X* xdrs, u_int position)
+    {
+        return self(xdrs)->seek(position) ? TRUE : FALSE;
+    }
+    // Only bytes contiguous in current part can be inlined, otherwise
+    // callers of xdr_inline() fall back to reading bytes
+    template <typename X>
+    static int32_t* inlined(X* xdrs, u_int len)
+    {
+        XDRDecoder* d{self(xdrs)};
+        if(len > uint32_t(d->end - d->pos)) return nullptr;
+        int32_t* buf{reinterpret_cast<int32_t*>(const_cast<uint8_t*>(d->pos))};
+        d->pos += len;
+        return buf;
+    }
+    template <typename X>
+    static void destroy(X*)
+    {
+    }
+
+    // getint32/putint32 exist in xdr_ops of glibc only
+    template <typename O>
+    static auto set_int32(O& ops, int) -> decltype(ops.x_getint32, void())
+    {
+        ops.x_getint32 = &getint32;
+        ops.x_putint32 = &put;
+    }
+    template <typename O>
+    static void set_int32(O&, long)
+    {
+    }
+
+    static const Ops& chunked_ops()
+    {
+        static const Ops ops = [] {
+            Ops o = {};
+            o.x_getlong  = &getlong;
+            o.x_putlong  = &put;
+            o.x_getbytes = &getbytes;
+            o.x_putbytes = &putbytes;
+            o.x_getpostn = &getpostn;
+            o.x_setpostn = &setpostn;
+            o.x_inline   = &inlined;
+            o.x_destroy  = &destroy;
+            set_int32(o, 0);
+            return o;
+        }();
+        return ops;
+    }
+
     XDR                    txdr;
     FilteredDataQueue::Ptr ptr;
+
+    // position of chunked stream
+    const uint8_t* pos{nullptr};   // current byte
+    const uint8_t* begin{nullptr}; // of current part
+    const uint8_t* end{nullptr};   // of current part
+    const Chunk*   next{nullptr};  // part following current one
+    uint32_t       offset{0};      // of current part in data
 };
 
+// Decode opaque payload of NFSv4 READ or WRITE. Filtration may skip bytes
+// of payload and keep only its length, then data are set to nullptr
+inline bool_t xdr_payload(XDR* xdrs, char** data, u_int* size)
+{
+    if(xdrs->x_op != XDR_DECODE || nullptr == xdrs->x_public)
+    {
+        return xdr_bytes(xdrs, data, size, ~0u);
+    }
+
+    const u_int begin{xdr_getpos(xdrs)};
+    if(!xdr_u_int(xdrs, size))
+    {
+        return FALSE;
+    }
+    if(*reinterpret_cast<const uint32_t*>(xdrs->x_public) == xdr_getpos(xdrs))
+    {
+        *data = nullptr;
+        return TRUE;
+    }
+    return xdr_setpos(xdrs, begin) && xdr_bytes(xdrs, data, size, ~0u);
+}
+
 } // namespace xdr
 } // namespace protocols
 } // namespace NST
@@ -54,11 +54,15 @@ public:
         assert(max_chunks() == free_chunks());
     }
 
+    // chunks are aligned to alignment, which is a power of 2 >= padding
     void init_allocation(std::size_t chunk_size,
                          std::size_t block_size,
-                         std::size_t block_limit)
+                         std::size_t block_limit,
+                         std::size_t alignment = padding)
     {
-        chunk = ((chunk_size + padding - 1) / padding) * padding;
+        assert(alignment >= padding && (alignment & (alignment - 1)) == 0);
+        align = alignment;
+        chunk = ((chunk_size + align - 1) / align) * align;
         assert(chunk % padding == 0);
         assert(chunk >= chunk_size);
         assert(chunk >= sizeof(Chunk));
@@ -106,16 +110,18 @@ public:
     std::size_t max_memory() const noexcept { return block * limit * chunk; }
     std::size_t max_blocks() const noexcept { return limit; }
     std::size_t free_chunks() const noexcept { return nfree; }
+    std::size_t chunk_size() const noexcept { return chunk; }
 private:
     Chunk* getof(std::size_t i, const Chunks& chunks) const noexcept
     {
         assert(i < block);
-        return reinterpret_cast<Chunk*>(&chunks.get()[i * chunk]);
+        const std::uintptr_t base{(reinterpret_cast<std::uintptr_t>(chunks.get()) + align - 1) & ~(align - 1)};
+        return reinterpret_cast<Chunk*>(base + i * chunk);
     }
 
     Chunk* preallocate_block()
     {
-        Chunks chunks(std::make_unique<Chunks::element_type[]>(block * chunk));
+        Chunks chunks(std::make_unique<Chunks::element_type[]>(block * chunk + align - 1));
 
         // link chunks to a list
         for(std::size_t i = 0; i < block - 1; ++i)
@@ -131,6 +137,7 @@ private:
 
     Chunk*      list  = nullptr; // head of list of free chunks
     std::size_t chunk = 0;       // size of chunk
+    std::size_t align = padding; // alignment of chunks
     std::size_t block = 0;       // num chunks in block
     std::size_t limit = 0;       // max blocks, soft limit
     std::size_t nfree = 0;       // num of avaliable chunks
@@ -0,0 +1,245 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Placement of threads on sets of CPUs.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef CPU_SET_H
+#define CPU_SET_H
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "utils/noncopyable.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace utils
+{
+// Sorted set of CPU numbers written as list of numbers and ranges: "0-3,8".
+// The empty set means that placement of threads isn't changed.
+class CPUSet final
+{
+public:
+    CPUSet() = default;
+
+    // throws std::invalid_argument if the list is malformed
+    explicit CPUSet(const std::string& list)
+    {
+        std::size_t i{0};
+        while(i < list.size())
+        {
+            const unsigned first{number(list, i)};
+            unsigned       last{first};
+            if(i < list.size() && list[i] == '-')
+            {
+                last = number(list, ++i);
+                if(last < first)
+                {
+                    throw std::invalid_argument{"Invalid range of CPUs: " + list};
+                }
+            }
+            for(unsigned cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+            if(i < list.size() && list[i++] != ',')
+            {
+                throw std::invalid_argument{"Invalid list of CPUs: " + list};
+            }
+        }
+        std::sort(cpus.begin(), cpus.end());
+        cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    }
+
+    inline bool                         empty() const { return cpus.empty(); }
+    inline const std::vector<unsigned>& list() const { return cpus; }
+
+    // CPUs which the calling thread may run on
+    static CPUSet of_current_thread()
+    {
+        CPUSet set;
+#ifdef __linux__
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if(pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask) == 0)
+        {
+            for(unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if(CPU_ISSET(cpu, &mask))
+                {
+                    set.cpus.push_back(cpu);
+                }
+            }
+        }
+#endif
+        return set;
+    }
+
+    // CPUs of threads placed on the set, CPUs of the calling thread if the
+    // set is empty
+    CPUSet effective() const
+    {
+        return empty() ? of_current_thread() : *this;
+    }
+
+    // NUMA nodes of the CPUs, empty if they are unknown
+    CPUSet nodes() const
+    {
+        CPUSet set;
+#ifdef __linux__
+        for(const unsigned cpu : cpus)
+        {
+            const std::string path{"/sys/devices/system/cpu/cpu" + std::to_string(cpu)};
+            if(DIR* dir = opendir(path.c_str()))
+            {
+                while(const struct dirent* entry = readdir(dir))
+                {
+                    const std::string name{entry->d_name};
+                    if(name.size() > 4 && name.compare(0, 4, "node") == 0)
+                    {
+                        set.cpus.push_back(std::strtoul(name.c_str() + 4, nullptr, 10));
+                    }
+                }
+                closedir(dir);
+            }
+        }
+        std::sort(set.cpus.begin(), set.cpus.end());
+        set.cpus.erase(std::unique(set.cpus.begin(), set.cpus.end()), set.cpus.end());
+#endif
+        return set;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const CPUSet& set)
+    {
+        const auto& c = set.cpus;
+        for(std::size_t i = 0; i < c.size();)
+        {
+            std::size_t j{i};
+            while(j + 1 < c.size() && c[j + 1] == c[j] + 1)
+            {
+                ++j;
+            }
+            out << (i ? "," : "") << c[i];
+            if(j > i)
+            {
+                out << '-' << c[j];
+            }
+            i = j + 1;
+        }
+        return out;
+    }
+
+private:
+    static unsigned number(const std::string& list, std::size_t& i)
+    {
+        const std::size_t begin{i};
+        while(i < list.size() && list[i] >= '0' && list[i] <= '9')
+        {
+            ++i;
+        }
+        if(i == begin || i - begin > 6)
+        {
+            throw std::invalid_argument{"Invalid list of CPUs: " + list};
+        }
+        return std::stoul(list.substr(begin, i - begin));
+    }
+
+    std::vector<unsigned> cpus;
+};
+
+// The calling thread runs on CPUs of the set until destruction, then its
+// previous placement is restored. Threads created meanwhile inherit the
+// placement and pages touched first meanwhile are allocated by the kernel on
+// NUMA nodes of the set, so buffers of a stage are created under placement
+// of threads which use them.
+class CPUPlacement final : noncopyable
+{
+public:
+    // throws std::system_error if the thread can't be placed on the set
+    explicit CPUPlacement(const CPUSet& set)
+        : placed{false}
+    {
+        if(set.empty())
+        {
+            return;
+        }
+#ifdef __linux__
+        CPU_ZERO(&previous);
+        int err{pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous)};
+        if(err == 0)
+        {
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            for(const unsigned cpu : set.list())
+            {
+                if(cpu >= CPU_SETSIZE)
+                {
+                    throw std::system_error{EINVAL, std::system_category(), "CPU out of range"};
+                }
+                CPU_SET(cpu, &mask);
+            }
+            err = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+        }
+        if(err != 0)
+        {
+            std::ostringstream what;
+            what << "Can't place thread on CPUs " << set;
+            throw std::system_error{err, std::system_category(), what.str()};
+        }
+        placed = true;
+#else
+        throw std::system_error{ENOTSUP, std::system_category(), "Placement of threads on CPUs"};
+#endif
+    }
+
+    ~CPUPlacement()
+    {
+#ifdef __linux__
+        if(placed)
+        {
+            pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+        }
+#endif
+    }
+
+private:
+#ifdef __linux__
+    cpu_set_t previous;
+#endif
+    bool placed;
+};
+
+} // namespace utils
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // CPU_SET_H
+//------------------------------------------------------------------------------
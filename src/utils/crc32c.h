@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: CRC32C (Castagnoli) of 32-bit words for hashing of keys.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef CRC32C_H
+#define CRC32C_H
+//------------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+//------------------------------------------------------------------------------
+#if defined(__x86_64__) || defined(__i386__)
+#define NST_CRC32C_SSE42 1
+#endif
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace utils
+{
+// CRC32C of words, each word is taken as 4 bytes in little-endian order.
+// The crc32 instruction of SSE4.2 is used if CPU supports it, otherwise CRC
+// is calculated by table. Both give the same values, without initial and
+// final inversions of CRC.
+class CRC32C final
+{
+public:
+    CRC32C() = delete;
+
+    static inline uint32_t extend(uint32_t crc, const uint32_t* words, std::size_t count)
+    {
+#ifdef NST_CRC32C_SSE42
+        if(hardware_supported())
+        {
+            return hardware(crc, words, count);
+        }
+#endif
+        return software(crc, words, count);
+    }
+
+    static uint32_t software(uint32_t crc, const uint32_t* words, std::size_t count)
+    {
+        const uint32_t* t{table()};
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            crc ^= words[i];
+            crc = t[crc & 0xff] ^ (crc >> 8);
+            crc = t[crc & 0xff] ^ (crc >> 8);
+            crc = t[crc & 0xff] ^ (crc >> 8);
+            crc = t[crc & 0xff] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#ifdef NST_CRC32C_SSE42
+    __attribute__((target("sse4.2"))) static uint32_t hardware(uint32_t crc, const uint32_t* words, std::size_t count)
+    {
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            crc = __builtin_ia32_crc32si(crc, words[i]);
+        }
+        return crc;
+    }
+
+    static inline bool hardware_supported()
+    {
+        static const bool sse42{__builtin_cpu_supports("sse4.2") != 0};
+        return sse42;
+    }
+#else
+    static inline bool hardware_supported() { return false; }
+#endif
+
+private:
+    static const uint32_t* table()
+    {
+        struct Table
+        {
+            Table()
+            {
+                for(uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t crc{i};
+                    for(int bit = 0; bit < 8; ++bit)
+                    {
+                        crc = (crc & 1) ? (crc >> 1) ^ 0x82f63b78 : (crc >> 1); // reversed polynomial
+                    }
+                    values[i] = crc;
+                }
+            }
+            uint32_t values[256];
+        };
+        static const Table t;
+        return t.values;
+    }
+};
+
+} // namespace utils
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // CRC32C_H
+//------------------------------------------------------------------------------
@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Wakeup of a consumer thread waiting for pushed data.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef DOORBELL_H
+#define DOORBELL_H
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#ifdef __linux__
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#include "utils/noncopyable.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace utils
+{
+// Producers ring the doorbell after they push data, the consumer waits for
+// the ring after it has taken out all data. Only the first ring after the
+// consumer has reset the doorbell writes shared memory and only a ring of
+// sleeping consumer costs a system call (futex on Linux). Before sleeping
+// the consumer polls the doorbell for a while, the time of polling adapts
+// to the gaps between rings: it grows if the ring comes while polling and
+// shrinks otherwise.
+class Doorbell final : noncopyable
+{
+    enum State : int
+    {
+        Idle,    // consumer takes out data
+        Rung,    // data were pushed after the reset
+        Sleeping // consumer sleeps until the ring
+    };
+
+public:
+    // max time of polling before sleep, 0 means sleep at once
+    explicit Doorbell(std::chrono::microseconds spin = std::chrono::microseconds{0})
+        : limit{spin}
+        , budget{spin}
+        , state{Idle}
+    {
+    }
+
+    // called by producers after data are pushed
+    void ring() noexcept
+    {
+        // pushed data must be visible to the consumer which reads the state
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(state.load(std::memory_order_relaxed) == Rung)
+        {
+            return; // the consumer will take out data anyway
+        }
+        if(state.exchange(Rung) == Sleeping)
+        {
+            wake();
+        }
+    }
+
+    // Called by the consumer, return true if the doorbell was rung and false
+    // on timeout. The doorbell is reset, so data pushed after return will
+    // ring it again.
+    bool wait(std::chrono::milliseconds timeout)
+    {
+        int expected{Idle};
+        if(poll() || !state.compare_exchange_strong(expected, Sleeping))
+        {
+            return reset();
+        }
+        sleep(timeout);
+        return reset();
+    }
+
+private:
+    // poll the doorbell before sleeping
+    bool poll()
+    {
+        if(limit.count() == 0)
+        {
+            return false;
+        }
+
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point until{Clock::now() + budget};
+        do
+        {
+            if(state.load(std::memory_order_relaxed) == Rung)
+            {
+                budget = std::min(limit, budget * 2);
+                return true;
+            }
+        } while(Clock::now() < until);
+
+        budget = std::max(std::chrono::microseconds{1}, budget / 2);
+        return false;
+    }
+
+    bool reset()
+    {
+        const bool rung{state.exchange(Idle) == Rung};
+        // data pushed before the ring must be visible after the reset
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return rung;
+    }
+
+#ifdef __linux__
+    void sleep(std::chrono::milliseconds timeout)
+    {
+        const std::chrono::seconds s{std::chrono::duration_cast<std::chrono::seconds>(timeout)};
+        struct timespec ts;
+        ts.tv_sec  = s.count();
+        ts.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - s).count();
+
+        // returns at once if the state isn't Sleeping anymore
+        syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAIT_PRIVATE, int{Sleeping}, &ts, nullptr, 0);
+    }
+
+    void wake() noexcept
+    {
+        syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+#else
+    void sleep(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        condition.wait_for(lock, timeout, [&]() { return state.load() != Sleeping; });
+    }
+
+    void wake() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex}; // the consumer checks the state or waits
+        }
+        condition.notify_one();
+    }
+
+    std::mutex              mutex;
+    std::condition_variable condition;
+#endif
+
+    const std::chrono::microseconds limit;  // max time of polling
+    std::chrono::microseconds       budget; // time of next polling
+    std::atomic<int>                state;
+
+    static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex requires atomic of size of int");
+};
+
+} // namespace utils
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // DOORBELL_H
+//------------------------------------------------------------------------------
@@ -24,10 +24,11 @@
 //------------------------------------------------------------------------------
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 
-#include <sys/time.h>
-
+#include "api/procedure.h"
 #include "utils/noncopyable.h"
+#include "utils/pinned_buffer.h"
 #include "utils/queue.h"
 #include "utils/sessions.h"
 //------------------------------------------------------------------------------
@@ -35,78 +36,240 @@ namespace NST
 {
 namespace utils
 {
+// Data of filtered message. The first part of data is in cache, in flattened
+// memory or in referenced memory of reader. Bytes which don't fit into cache
+// are appended in chunks, so growing message isn't reallocated, and headers
+// of message are contiguous in the first part.
+// The cache is memory of queue element trailing FilteredData, its size is
+// set by queue (see --qelement option). FilteredData created outside queue
+// has no cache and allocates memory for the first part.
 struct FilteredData final : noncopyable
 {
     using Direction = NST::utils::Session::Direction;
 
+    // part of data appended after the first one
+    struct Chunk
+    {
+        Chunk*   next;
+        uint32_t size;   // capacity of bytes()
+        uint32_t length; // of data in bytes()
+
+        inline uint8_t*       bytes() { return reinterpret_cast<uint8_t*>(this + 1); }
+        inline const uint8_t* bytes() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+    };
+
 public:
     NetworkSession* session{nullptr}; // pointer to immutable session in Filtration
-    struct timeval  timestamp;        // timestamp of last collected packet
+    API::Timestamp  timestamp;        // timestamp of last collected packet
     Direction       direction;        // direction of data transmission
+    uint64_t        ordinal{0};       // number of packet in input that completed data
 
-    uint32_t dlen{0};     // length of filtered data
-    uint8_t* data{cache}; // pointer to data in memory. {Readonly. Always points to proper memory buffer}
+    uint32_t dlen{0};     // length of filtered data in all parts
+    uint32_t payload{0};  // offset of READ/WRITE payload skipped by filtration, 0 if none
+    uint8_t* data;        // pointer to the first part of data. {Readonly. Points to proper memory buffer if dlen != 0}
 
 private:
-    const static int CACHE_SIZE{4000};
+    const static uint32_t MIN_CHUNK{2048};  // capacity of the first chunk
+    const static uint32_t MAX_CHUNK{65536}; // capacities of chunks grow twice up to it
+    const static uint32_t MIN_HEAD{16384};  // capacity of the first part without cache
 
-    uint8_t  cache[CACHE_SIZE];
-    uint8_t* memory{nullptr};
-    uint32_t memsize{0};
+    uint8_t* const cache;      // memory trailing this in element of queue
+    const uint32_t cache_size; // bytes of the cache
+    uint8_t*      memory{nullptr};
+    uint32_t      memsize{0};
+    PinnedBuffer* pin{nullptr};    // buffer of captured packets referenced by data
+    uint32_t      head{0};         // length of the first part
+    Chunk*        chunks{nullptr}; // following parts
+    Chunk*        last{nullptr};
 
 public:
     FilteredData() noexcept
-        : data{cache}
+        : data{nullptr}
+        , cache{nullptr}
+        , cache_size{0}
+    {
+    }
+
+    // construct in memory followed by cache of given size
+    explicit FilteredData(std::size_t trailing) noexcept
+        : data{reinterpret_cast<uint8_t*>(this + 1)}
+        , cache{data}
+        , cache_size{static_cast<uint32_t>(trailing)}
     {
     }
 
     ~FilteredData()
     {
+        if(pin) pin->release();
+        free_chunks();
         delete[] memory;
     }
 
+    // capacity of own memory of the first part
     uint32_t capacity() const
     {
         if(nullptr == memory)
         {
-            assert(data == cache);
-            return CACHE_SIZE;
+            assert(data == cache || pin);
+            return cache_size;
         }
         return memsize;
     }
 
-    // Resize capacity with data safety
-    void resize(uint32_t newsize)
+    // length of the first part and following parts of data
+    inline uint32_t     head_length() const { return head; }
+    inline const Chunk* tail() const { return chunks; }
+
+    // Reference bytes of captured packet in place instead of copy
+    void reference(const uint8_t* bytes, uint32_t len, PinnedBuffer* buffer)
     {
-        if(capacity() >= newsize) return; // not resize less
+        assert(dlen == 0 && !pin);
 
-        if(nullptr == memory)
+        buffer->acquire();
+        pin  = buffer;
+        data = const_cast<uint8_t*>(bytes); // data are read only
+        dlen = len;
+        head = len;
+    }
+
+    // Do referenced data continue right before bytes in the same buffer
+    inline bool precede(const uint8_t* bytes, const PinnedBuffer* buffer) const
+    {
+        return pin == buffer && data + dlen == bytes;
+    }
+
+    // Extend referenced data by following bytes, see precede()
+    inline void extend(uint32_t len)
+    {
+        assert(pin);
+        dlen += len;
+        head += len;
+    }
+
+    // Copy bytes to the end of data
+    void append(const uint8_t* bytes, uint32_t len)
+    {
+        detach();
+
+        if(nullptr == chunks) // fill room of the first part
         {
-            memory = new uint8_t[newsize];
-            if(dlen)
+            if(0 == capacity())
             {
-                memcpy(memory, cache, dlen);
+                resize(len > MIN_HEAD ? len : MIN_HEAD);
             }
-            memsize = newsize;
-            data    = memory;
+            uint8_t* const end{(memory ? memory : cache) + capacity()};
+            const uint32_t room{static_cast<uint32_t>(end - (data + head))};
+            const uint32_t n{len < room ? len : room};
+            memcpy(data + head, bytes, n);
+            head += n;
+            dlen += n;
+            bytes += n;
+            len -= n;
         }
-        else // have some filled memory
+
+        while(len)
         {
-            uint8_t* mem{new uint8_t[newsize]};
-            if(dlen)
+            if(nullptr == last || last->length == last->size)
             {
-                memcpy(mem, memory, dlen);
+                add_chunk(len);
             }
-            data = mem;
-            delete[] memory;
-            memory  = mem;
-            memsize = newsize;
+            const uint32_t room{last->size - last->length};
+            const uint32_t n{len < room ? len : room};
+            memcpy(last->bytes() + last->length, bytes, n);
+            last->length += n;
+            dlen += n;
+            bytes += n;
+            len -= n;
         }
     }
 
+    // Skip bytes at the beginning of the first part
+    inline void skip_first(uint32_t len)
+    {
+        assert(len <= head);
+        data += len;
+        head -= len;
+        dlen -= len;
+        if(payload) payload -= len;
+    }
+
+    // Copy referenced data to own memory and unpin buffer of captured packets
+    void detach()
+    {
+        if(!pin) return;
+
+        const uint8_t* referenced{data};
+        const uint32_t len{dlen};
+        PinnedBuffer*  buffer{pin};
+        pin  = nullptr;
+        data = memory ? memory : cache;
+        dlen = 0;
+        head = 0;
+        append(referenced, len);
+        buffer->release();
+    }
+
+    // Make all data contiguous in the first part
+    void flatten()
+    {
+        detach();
+        if(nullptr == chunks) return;
+
+        uint8_t* flat{new uint8_t[dlen]};
+        memcpy(flat, data, head);
+        uint32_t offset{head};
+        for(const Chunk* c = chunks; c; c = c->next)
+        {
+            memcpy(flat + offset, c->bytes(), c->length);
+            offset += c->length;
+        }
+        free_chunks();
+
+        delete[] memory;
+        memory  = flat;
+        memsize = dlen;
+        data    = memory;
+        head    = dlen;
+    }
+
+    // Resize capacity of the first part with data safety
+    void resize(uint32_t newsize)
+    {
+        flatten();
+        if(capacity() >= newsize) return; // not resize less
+
+        uint8_t* mem{new uint8_t[newsize]};
+        if(dlen)
+        {
+            memcpy(mem, data, dlen);
+        }
+        data = mem;
+        delete[] memory;
+        memory  = mem;
+        memsize = newsize;
+    }
+
+    // Data without payload are queued after all data of a session closed by
+    // filtration, analysis releases the session when it takes them
+    inline bool closes_session() const { return dlen == 0; }
+
+    // Set timestamp in nanoseconds and its microseconds for old plugins
+    void set_timestamp(uint64_t nsec)
+    {
+        timestamp.nsec       = nsec;
+        timestamp.tv.tv_sec  = nsec / 1000000000;
+        timestamp.tv.tv_usec = nsec % 1000000000 / 1000;
+    }
+
     // Reset data. Release free memory if allocated
     void reset()
     {
+        if(nullptr != pin)
+        {
+            pin->release();
+            pin = nullptr;
+        }
+        free_chunks();
         if(nullptr != memory)
         {
             delete[] memory;
@@ -114,8 +277,37 @@ public:
         }
         memsize = 0;
         dlen    = 0;
+        payload = 0;
+        head    = 0;
         data    = cache;
     }
+
+private:
+    void add_chunk(uint32_t len)
+    {
+        uint32_t size{last ? last->size * 2 : MIN_CHUNK};
+        if(size > MAX_CHUNK) size = MAX_CHUNK;
+        if(size < len) size = len;
+        Chunk*         chunk{reinterpret_cast<Chunk*>(new uint8_t[sizeof(Chunk) + size])};
+        chunk->next   = nullptr;
+        chunk->size   = size;
+        chunk->length = 0;
+
+        if(last) last->next = chunk;
+        else chunks = chunk;
+        last = chunk;
+    }
+
+    void free_chunks()
+    {
+        while(chunks)
+        {
+            Chunk* next{chunks->next};
+            delete[] reinterpret_cast<uint8_t*>(chunks);
+            chunks = next;
+        }
+        last = nullptr;
+    }
 };
 
 using FilteredDataQueue = Queue<FilteredData>;
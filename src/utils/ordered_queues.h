@@ -0,0 +1,210 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Queues of FilteredData merged in order of packets in input.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef ORDERED_QUEUES_H
+#define ORDERED_QUEUES_H
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "utils/doorbell.h"
+#include "utils/filtered_data.h"
+#include "utils/noncopyable.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace utils
+{
+// Set of queues filled by filtration threads which read the same input and
+// share sessions between them. Each thread tags FilteredData by ordinal of
+// the packet that completed it and publishes its progress in input. Data are
+// merged in order of ordinals when all threads passed them, so the order
+// doesn't depend on scheduling of threads and equals the order of single
+// filtration thread.
+class OrderedQueues final : noncopyable
+{
+public:
+    // max number of packets a thread may run ahead of merged data
+    static const uint64_t window{1024 * 1024};
+
+    class Input final : noncopyable
+    {
+        friend class OrderedQueues;
+
+    public:
+        Input(OrderedQueues& q, uint32_t capacity, std::size_t cache)
+            : queue{capacity, 1, cache}
+            , progress{0}
+            , owner(q)
+        {
+        }
+
+        inline FilteredDataQueue& get_queue() { return queue; }
+
+        // data of all packets before ordinal are pushed to the queue,
+        // wait if the thread runs too far ahead of other threads
+        void set_progress(uint64_t ordinal)
+        {
+            progress.store(ordinal, std::memory_order_release);
+            owner.ring(); // data of other threads may be merged now
+            while(ordinal > window &&
+                  ordinal - window > owner.merged.load(std::memory_order_acquire) &&
+                  !owner.closed.load(std::memory_order_relaxed))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        // all data are pushed to the queue
+        void finish()
+        {
+            progress.store(std::numeric_limits<uint64_t>::max(), std::memory_order_release);
+            owner.ring();
+        }
+
+    private:
+        FilteredDataQueue                  queue;
+        std::atomic<uint64_t>              progress; // ordinal of next packet
+        std::deque<FilteredDataQueue::Ptr> pending;  // taken from queue, not merged
+        uint64_t                           limit{0}; // observed progress
+        OrderedQueues&                     owner;
+    };
+
+    OrderedQueues(unsigned count, uint32_t capacity, std::size_t cache = 0)
+        : merged{0}
+        , closed{false}
+        , doorbell{nullptr}
+    {
+        for(unsigned i = 0; i < count; ++i)
+        {
+            inputs.emplace_back(new Input{*this, capacity, cache});
+        }
+    }
+
+    inline unsigned size() const { return unsigned(inputs.size()); }
+    inline Input&   input(unsigned i) { return *inputs[i]; }
+
+    // the merging thread waits for pushed data and progress of threads on
+    // the doorbell, it must be set before threads start
+    void set_doorbell(Doorbell* d)
+    {
+        doorbell = d;
+        for(auto& i : inputs)
+        {
+            i->queue.set_doorbell(d);
+        }
+    }
+
+    // pass merged data to handler, if flush is true all queued data are
+    // passed regardless of progress of threads
+    template <typename Handler>
+    void merge(Handler handler, bool flush = false)
+    {
+        // progress is read before queue is taken, so all data tagged by
+        // ordinals below it are already taken
+        for(auto& i : inputs)
+        {
+            i->limit = i->progress.load(std::memory_order_acquire);
+
+            FilteredDataQueue::List list{i->queue};
+            while(list)
+            {
+                i->pending.emplace_back(list.get_current());
+            }
+        }
+
+        for(;;)
+        {
+            Input* next{nullptr};
+            for(auto& i : inputs)
+            {
+                if(!i->pending.empty() &&
+                   (!next || i->pending.front()->ordinal < next->pending.front()->ordinal))
+                {
+                    next = i.get();
+                }
+            }
+            if(!next) break;
+
+            // data of a packet are produced by single thread, so others
+            // must pass the packet to keep order
+            const uint64_t ordinal{next->pending.front()->ordinal};
+            if(!flush && !passed(ordinal)) break;
+
+            FilteredDataQueue::Ptr data{std::move(next->pending.front())};
+            next->pending.pop_front();
+            handler(data);
+        }
+
+        uint64_t low{std::numeric_limits<uint64_t>::max()};
+        for(auto& i : inputs)
+        {
+            low = std::min(low, i->pending.empty() ? i->limit : i->pending.front()->ordinal);
+        }
+        merged.store(low, std::memory_order_release);
+    }
+
+    // unblock waiting threads if data aren't merged anymore
+    void close()
+    {
+        closed.store(true, std::memory_order_relaxed);
+        for(auto& i : inputs)
+        {
+            i->queue.close();
+        }
+    }
+
+private:
+    inline void ring()
+    {
+        if(doorbell)
+        {
+            doorbell->ring();
+        }
+    }
+
+    bool passed(uint64_t ordinal) const
+    {
+        for(auto& i : inputs)
+        {
+            if(i->pending.empty() && i->limit <= ordinal) return false;
+        }
+        return true;
+    }
+
+    std::vector<std::unique_ptr<Input>> inputs;
+    std::atomic<uint64_t>               merged; // data before it are merged
+    std::atomic<bool>                   closed;
+    Doorbell*                           doorbell;
+};
+
+} // namespace utils
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // ORDERED_QUEUES_H
+//------------------------------------------------------------------------------
@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Reference counter of memory of captured packets.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef PINNED_BUFFER_H
+#define PINNED_BUFFER_H
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+
+#include "utils/noncopyable.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace utils
+{
+// Memory of captured packets which FilteredData may reference instead of
+// copy of packets. The reader owns one reference and releases it instead of
+// deletion, the memory is freed by the last release. The reader reuses the
+// memory only when it isn't pinned by references of others.
+class PinnedBuffer : noncopyable
+{
+public:
+    PinnedBuffer()
+        : refs{1} // of owner
+    {
+    }
+
+    inline void acquire() { refs.fetch_add(1, std::memory_order_relaxed); }
+    inline void release()
+    {
+        if(refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    // is the memory referenced by someone besides the owner
+    inline bool pinned() const { return refs.load(std::memory_order_acquire) > 1; }
+protected:
+    virtual ~PinnedBuffer() = default;
+
+private:
+    std::atomic<uint32_t> refs;
+};
+
+} // namespace utils
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // PINNED_BUFFER_H
+//------------------------------------------------------------------------------
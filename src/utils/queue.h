@@ -22,11 +22,16 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 //------------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <thread>
 #include <type_traits>
 
 #include "utils/block_allocator.h"
+#include "utils/doorbell.h"
 #include "utils/noncopyable.h"
 #include "utils/spinlock.h"
 //------------------------------------------------------------------------------
@@ -34,15 +39,47 @@ namespace NST
 {
 namespace utils
 {
+// What to do with a pushed element if the queue is full
+enum class QueuePolicy
+{
+    Block,      // wait until the consumer takes out elements
+    DropNewest, // drop the pushed element
+    DropOldest  // drop the oldest queued element
+};
+
+// Each element of queue is followed by trailing bytes of memory, their
+// size is passed to constructor of T. Queued elements are passed through
+// bounded lock-free ring (D. Vyukov's MPMC queue), the number of elements
+// in the ring is limited by its capacity instead of memory of allocator
 template <typename T>
 class Queue final : noncopyable
 {
     struct Element final : noncopyable
     {
         Element* prev;
+        bool     droppable;
         T        data;
     };
 
+    struct Cell final : noncopyable // slot of the ring
+    {
+        std::atomic<std::size_t> sequence;
+        Element*                 element;
+    };
+
+    // position in the ring, positions of producers and consumer are kept
+    // in different cache lines
+    struct Position final : noncopyable
+    {
+        explicit Position(std::size_t v) noexcept
+            : value{v}
+        {
+        }
+
+        char                     padding[64];
+        std::atomic<std::size_t> value;
+    };
+
     struct ElementDeleter final
     {
         explicit ElementDeleter(Queue* q = nullptr) noexcept
@@ -95,11 +132,24 @@ public:
         Queue*   queue;
     };
 
-    Queue(uint32_t size, uint32_t limit)
-        : last{nullptr}
-        , first{nullptr}
+    // capacity of the ring is size rounded up to a power of 2
+    Queue(uint32_t size, uint32_t limit, std::size_t trailing = 0, QueuePolicy p = QueuePolicy::Block)
+        : trailing_size{trailing}
+        , policy{p}
+        , mask{ring_capacity(size) - 1}
+        , cells{new Cell[mask + 1]}
+        , doorbell{nullptr}
+        , closed{false}
+        , high{0}
+        , drops{0}
+        , tail{0}
+        , head{0}
     {
-        allocator.init_allocation(sizeof(Element), size, limit);
+        allocator.init_allocation(sizeof(Element) + trailing_size, size, limit);
+        for(std::size_t i = 0; i <= mask; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
     }
     ~Queue()
     {
@@ -108,7 +158,7 @@ public:
 
     Ptr allocate()
     {
-        static_assert(std::is_nothrow_constructible<T>::value,
+        static_assert(std::is_nothrow_constructible<T, std::size_t>::value,
                       "The construction of T must not to throw any exception");
 
         Ptr out{nullptr, ElementDeleter{this}};
@@ -118,44 +168,192 @@ public:
             Element*       e{(Element*)allocator.allocate()}; // may throw std::bad_alloc
             out.reset(&(e->data));
         }
-        ::new(out.get()) T; // placement construction T
+        ::new(out.get()) T(trailing_size); // placement construction T
         return out;
     }
 
-    void push(Ptr& ptr)
+    // push element to the queue, if it is full the element is handled by
+    // policy of queue; element which isn't droppable is pushed as blocking
+    void push(Ptr& ptr, bool droppable = true)
     {
-        Element*       e{(Element*)(((char*)ptr.release()) - offsetof(Element, data))};
-        Spinlock::Lock lock{q_spinlock};
-        if(last)
+        Element* e{element(ptr.release())};
+        e->droppable = droppable;
+
+        const QueuePolicy p{droppable ? policy : QueuePolicy::Block};
+        for(unsigned attempt = 0; !enqueue(e); ++attempt)
         {
-            last->prev = e;
-            last       = e;
+            if(p == QueuePolicy::DropOldest)
+            {
+                Element* oldest{nullptr};
+                if(!dequeue(oldest))
+                {
+                    continue; // consumer has taken out elements
+                }
+                if(oldest->droppable)
+                {
+                    drop(oldest);
+                    continue;
+                }
+                // the oldest must be passed, so it is queued again
+                // after the others and the pushed element is dropped
+                for(unsigned n = 0; !enqueue(oldest); ++n)
+                {
+                    wait(n);
+                }
+                drop(e);
+                break;
+            }
+            if(p == QueuePolicy::Block && !closed.load(std::memory_order_relaxed))
+            {
+                wait(attempt);
+                continue;
+            }
+            drop(e);
+            return;
         }
-        else // queue is empty
+        if(doorbell)
         {
-            last = first = e;
+            doorbell->ring();
         }
     }
 
+    // the consumer waits for pushed elements on the doorbell, it must be
+    // set before producers start
+    void set_doorbell(Doorbell* d) { doorbell = d; }
+
+    // the consumer doesn't take out elements anymore, don't block producers
+    void close()
+    {
+        closed.store(true, std::memory_order_relaxed);
+    }
+
+    // size of memory of element in bytes
+    std::size_t element_size() const { return allocator.chunk_size(); }
+
+    std::size_t capacity() const { return mask + 1; }
+    std::size_t high_water() const { return high.load(std::memory_order_relaxed); } // max number of queued elements
+    uint64_t    dropped() const { return drops.load(std::memory_order_relaxed); }
+
 private:
+    static std::size_t ring_capacity(std::size_t size)
+    {
+        std::size_t capacity{2};
+        while(capacity < size)
+        {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    static Element* element(T* ptr)
+    {
+        return (Element*)(((char*)ptr) - offsetof(Element, data));
+    }
+
+    static void wait(unsigned attempt)
+    {
+        if(attempt < 64)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    bool enqueue(Element* e) noexcept
+    {
+        std::size_t pos{tail.value.load(std::memory_order_relaxed)};
+        Cell*       cell;
+        for(;;)
+        {
+            cell = &cells[pos & mask];
+            const std::size_t    seq{cell->sequence.load(std::memory_order_acquire)};
+            const std::ptrdiff_t diff{std::ptrdiff_t(seq) - std::ptrdiff_t(pos)};
+            if(diff == 0)
+            {
+                if(tail.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if(diff < 0)
+            {
+                return false; // queue is full
+            }
+            else
+            {
+                pos = tail.value.load(std::memory_order_relaxed);
+            }
+        }
+        cell->element = e;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        const std::size_t depth{pos + 1 - head.value.load(std::memory_order_relaxed)};
+        std::size_t       max{high.load(std::memory_order_relaxed)};
+        while(depth > max && depth <= capacity() &&
+              !high.compare_exchange_weak(max, depth, std::memory_order_relaxed))
+        {
+        }
+        return true;
+    }
+
+    bool dequeue(Element*& e) noexcept
+    {
+        std::size_t pos{head.value.load(std::memory_order_relaxed)};
+        Cell*       cell;
+        for(;;)
+        {
+            cell = &cells[pos & mask];
+            const std::size_t    seq{cell->sequence.load(std::memory_order_acquire)};
+            const std::ptrdiff_t diff{std::ptrdiff_t(seq) - std::ptrdiff_t(pos + 1)};
+            if(diff == 0)
+            {
+                if(head.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if(diff < 0)
+            {
+                return false; // queue is empty
+            }
+            else
+            {
+                pos = head.value.load(std::memory_order_relaxed);
+            }
+        }
+        e = cell->element;
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
     Element* pop_list() noexcept // take out list of all queued elements
     {
         Element* list{nullptr};
-        Spinlock::Lock lock{q_spinlock};
-        if(last)
+        Element* last{nullptr};
+        Element* e;
+        while(dequeue(e))
         {
-            list       = first;
-            last->prev = nullptr; // set end of list
-            last = first = nullptr;
+            e->prev = nullptr;
+            if(last)
+            {
+                last->prev = e;
+            }
+            else
+            {
+                list = e;
+            }
+            last = e;
         }
         return list;
     }
 
+    void drop(Element* e) noexcept
+    {
+        drops.fetch_add(1, std::memory_order_relaxed);
+        deallocate(&e->data);
+    }
+
     void deallocate(T* ptr)
     {
         ptr->~T(); // placement construction was used
-        Element* e{(Element*)(((char*)ptr) - offsetof(Element, data))};
-        deallocate(e);
+        deallocate(element(ptr));
     }
 
     // accessible from Queue::List and Queue::Ptr
@@ -166,14 +364,19 @@ private:
     }
 
     BlockAllocator allocator;
+    std::size_t    trailing_size; // bytes following each element
+    QueuePolicy    policy;
     Spinlock       a_spinlock; // for allocate/deallocate
-    Spinlock       q_spinlock; // for queue push/pop
 
-    // queue empty:   last->nullptr<-first
-    // queue filled:  last->e<-e<-e<-e<-first
-    // queue push(i): last->i<-e<-e<-e<-e<-first
-    Element* last;
-    Element* first;
+    // ring of queued elements, positions grow monotonically
+    const std::size_t        mask; // capacity - 1
+    std::unique_ptr<Cell[]>  cells;
+    Doorbell*                doorbell; // of the consumer
+    std::atomic<bool>        closed;
+    std::atomic<std::size_t> high;  // high-water mark of queued elements
+    std::atomic<uint64_t>    drops; // number of dropped elements
+    Position                 tail;  // of next push
+    Position                 head;  // of next pop
 };
 
 } // namespace utils
@@ -22,6 +22,7 @@
 #ifndef SESSIONS_H
 #define SESSIONS_H
 //------------------------------------------------------------------------------
+#include <atomic>
 #include <ostream>
 
 #include "api/session.h"
@@ -40,11 +41,13 @@ public:
     NetworkSession()
         : application{nullptr}
         , direction{Direction::Unknown}
+        , released{false}
     {
     }
 
-    void*     application; // pointer to application protocol implementation
-    Direction direction;
+    void*             application; // pointer to application protocol implementation
+    Direction         direction;
+    std::atomic<bool> released; // set by analysis after data of closed session
 };
 
 // Application layer session
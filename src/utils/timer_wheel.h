@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Timer wheel of keys scheduled to ticks of capture time.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+#include "utils/noncopyable.h"
+//------------------------------------------------------------------------------
+namespace NST
+{
+namespace utils
+{
+// Keys are scheduled to slots of the wheel by their ticks, so scheduling
+// costs O(1) and advancing visits only slots of passed ticks. A key scheduled
+// beyond one revolution of the wheel stays in its slot until its tick comes.
+// Stale timers aren't cancelled, the owner checks them when they expire.
+template <typename Key>
+class TimerWheel final : noncopyable
+{
+    struct Timer
+    {
+        Key      key;
+        uint64_t tick;
+    };
+    using Slot = std::vector<Timer>;
+
+public:
+    explicit TimerWheel(uint32_t slots = 256)
+        : wheel(slots)
+        , current{0}
+    {
+    }
+
+    inline uint64_t now() const { return current; }
+
+    void schedule(const Key& key, uint64_t tick)
+    {
+        wheel[tick % wheel.size()].push_back(Timer{key, tick});
+    }
+
+    // pass keys scheduled up to tick to expired(key, scheduled tick)
+    template <typename Expired>
+    void advance(uint64_t tick, Expired expired)
+    {
+        if(tick <= current) return;
+
+        // all slots are visited once if more than a revolution has passed
+        const uint64_t size{wheel.size()};
+        const uint64_t from{(tick - current > size) ? tick - size + 1 : current + 1};
+        current = tick;
+
+        for(uint64_t t = from; t <= tick; ++t)
+        {
+            passed.swap(wheel[t % size]);
+            for(const Timer& timer : passed)
+            {
+                if(timer.tick <= tick)
+                {
+                    expired(timer.key, timer.tick);
+                }
+                else // next revolution
+                {
+                    schedule(timer.key, timer.tick);
+                }
+            }
+            passed.clear(); // keep capacity for the next slot
+        }
+    }
+
+private:
+    std::vector<Slot> wheel;
+    Slot              passed; // timers of the slot being advanced
+    uint64_t          current;
+};
+
+} // namespace utils
+} // namespace NST
+//------------------------------------------------------------------------------
+#endif // TIMER_WHEEL_H
+//------------------------------------------------------------------------------
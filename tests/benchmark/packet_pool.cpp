@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Benchmark of PacketPool against heap allocation of out-of-order TCP segments
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "filtration/packet.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration;
+using Clock = std::chrono::steady_clock;
+//------------------------------------------------------------------------------
+namespace
+{
+// 512 KB window of 1448 bytes segments is lost and retransmitted each round
+const uint32_t segments{362};
+const uint32_t mss{1448};
+const uint32_t rounds{2000};
+
+// Ethernet:IPv4:TCP frame of segment with sequence number seq
+std::vector<uint8_t> frame(uint32_t seq)
+{
+    std::vector<uint8_t> f(14 + 20 + 20 + mss, 0);
+    f[12] = 0x08;
+    f[13] = 0x00;
+
+    uint8_t* ip{f.data() + 14};
+    ip[0] = 0x45;
+    ip[2] = (20 + 20 + mss) >> 8;
+    ip[3] = (20 + 20 + mss) & 0xff;
+    ip[6] = 0x40; // don't fragment
+    ip[9] = 6;    // TCP
+
+    uint8_t* tcp{ip + 20};
+    tcp[0]  = 0x08;
+    tcp[2]  = 0x03;
+    tcp[4]  = seq >> 24;
+    tcp[5]  = seq >> 16;
+    tcp[6]  = seq >> 8;
+    tcp[7]  = seq;
+    tcp[12] = 0x50;
+    return f;
+}
+
+// former Packet::create(): whole frame in separate heap allocation
+uint8_t* heap_copy(const PacketInfo& info)
+{
+    uint8_t* memory{new uint8_t[sizeof(Packet) + sizeof(pcap_pkthdr) + info.header->caplen]};
+    memcpy(memory + sizeof(Packet), info.header, sizeof(pcap_pkthdr));
+    memcpy(memory + sizeof(Packet) + sizeof(pcap_pkthdr), info.packet, info.header->caplen);
+    return memory;
+}
+
+template <typename Function>
+double measure(Function function)
+{
+    const auto start = Clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void report(const char* name, double ms, uint64_t allocations, uint64_t system)
+{
+    std::cout << std::left << std::setw(24) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1) << ms << " ms"
+              << std::setw(12) << allocations << " allocations"
+              << std::setw(12) << system << " from system\n";
+}
+} // unnamed namespace
+
+int main()
+{
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<pcap_pkthdr>          headers(segments);
+    for(uint32_t i = 0; i < segments; ++i)
+    {
+        frames.emplace_back(frame(i * mss));
+        headers[i].ts.tv_sec  = 1;
+        headers[i].ts.tv_usec = 0;
+        headers[i].caplen = headers[i].len = frames[i].size();
+    }
+
+    std::vector<uint8_t*> copies(segments);
+    const double          heap{measure([&]() {
+        for(uint32_t r = 0; r < rounds; ++r)
+        {
+            for(uint32_t i = 0; i < segments; ++i)
+            {
+                PacketInfo info(&headers[i], frames[i].data(), DLT_EN10MB);
+                copies[i] = heap_copy(info);
+            }
+            for(uint32_t i = 0; i < segments; ++i)
+            {
+                delete[] copies[i];
+            }
+        }
+    })};
+    report("heap, whole frames", heap, uint64_t(rounds) * segments, uint64_t(rounds) * segments);
+
+    for(const bool whole : {true, false})
+    {
+        PacketPool pool{whole};
+        Packet*    list{nullptr};
+
+        const double pooled{measure([&]() {
+            for(uint32_t r = 0; r < rounds; ++r)
+            {
+                for(uint32_t i = 0; i < segments; ++i)
+                {
+                    PacketInfo info(&headers[i], frames[i].data(), DLT_EN10MB);
+                    info.direction = PacketInfo::Direction::Source;
+                    list           = Packet::create(info, list, pool);
+                }
+                while(list)
+                {
+                    Packet* next{list->next};
+                    Packet::destroy(list, pool);
+                    list = next;
+                }
+            }
+        })};
+        report(whole ? "pool, whole frames" : "pool, payload only", pooled, pool.allocated(), pool.system_allocated());
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Benchmark of lookups of sessions with 100k concurrent sessions
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "filtration/sessions_hash.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration;
+using NST::utils::Session;
+using Clock = std::chrono::steady_clock;
+//------------------------------------------------------------------------------
+namespace
+{
+// clients of neighbouring addresses and ports talk to one NFS server
+const uint32_t sessions{100000};
+const uint32_t lookups{10000000};
+const uint32_t batch{32}; // packets of batch of FiltrationProcessor
+const uint32_t server{0x0a000001};
+
+// former IPv4PortsKeyHash: sum of ports and addresses
+struct SumHash
+{
+    std::size_t operator()(const Session& key) const
+    {
+        return key.port[0] + key.port[1] + key.ip.v4.addr[0] + key.ip.v4.addr[1];
+    }
+};
+
+// former IPv4PortsKeyEqual: both orientations of key are compared
+struct BothEqual
+{
+    bool operator()(const Session& a, const Session& b) const
+    {
+        if(a.port[0] == b.port[0] && a.port[1] == b.port[1] &&
+           a.ip.v4.addr[0] == b.ip.v4.addr[0] && a.ip.v4.addr[1] == b.ip.v4.addr[1])
+            return true;
+        return a.port[1] == b.port[0] && a.port[0] == b.port[1] &&
+               a.ip.v4.addr[1] == b.ip.v4.addr[0] && a.ip.v4.addr[0] == b.ip.v4.addr[1];
+    }
+};
+
+struct Node
+{
+    Session key;
+};
+
+// key of packet from client i or from the server to it
+Session packet(uint32_t i, bool reply)
+{
+    const uint32_t client{htonl(0x0a010000 + i / 8)};
+    const uint16_t port{htons(uint16_t(700 + i % 8))};
+
+    Session key;
+    key.port[0]       = reply ? htons(2049) : port;
+    key.port[1]       = reply ? port : htons(2049);
+    key.ip.v4.addr[0] = reply ? htonl(server) : client;
+    key.ip.v4.addr[1] = reply ? client : htonl(server);
+    return key;
+}
+
+// the same canonical key as IPv4TCPMapper::fill_hash_key() makes
+Session canonical(Session key)
+{
+    if(key.port[0] > key.port[1] ||
+       (key.port[0] == key.port[1] && key.ip.v4.addr[0] > key.ip.v4.addr[1]))
+    {
+        std::swap(key.port[0], key.port[1]);
+        std::swap(key.ip.v4.addr[0], key.ip.v4.addr[1]);
+    }
+    return key;
+}
+
+template <typename Function>
+double measure(Function function)
+{
+    const auto start = Clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void report(const char* name, double ms, uint64_t found)
+{
+    std::cout << std::left << std::setw(32) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1) << ms << " ms"
+              << std::setw(12) << found << " found\n";
+}
+} // unnamed namespace
+
+int main()
+{
+    std::vector<Node> nodes(sessions);
+    for(uint32_t i = 0; i < sessions; ++i)
+    {
+        nodes[i].key = canonical(packet(i, false));
+    }
+
+    // calls and replies of random sessions
+    std::mt19937         random{2049};
+    std::vector<Session> keys(lookups);
+    for(auto& k : keys)
+    {
+        const uint32_t i{uint32_t(random() % sessions)};
+        k = packet(i, random() & 1);
+    }
+
+    {
+        std::unordered_map<Session, Node*, SumHash, BothEqual> map;
+        for(auto& n : nodes)
+        {
+            map.emplace(packet(&n - nodes.data(), false), &n);
+        }
+
+        uint64_t     found{0};
+        const double ms{measure([&]() {
+            for(const auto& k : keys)
+            {
+                found += map.count(k);
+            }
+        })};
+        report("unordered_map, sum of key", ms, found);
+    }
+
+    {
+        SessionsTable<Node, IPv4TCPMapper::KeyHash, IPv4TCPMapper::KeyEqual> table;
+        for(auto& n : nodes)
+        {
+            table.insert(&n);
+        }
+
+        uint64_t     found{0};
+        const double ms{measure([&]() {
+            for(const auto& k : keys)
+            {
+                found += table.find(canonical(k)) != nullptr;
+            }
+        })};
+        report("open addressing, CRC32C", ms, found);
+
+        // the same lookups in batches: hash keys and prefetch their slots,
+        // then probe slots by stored hashes
+        using KeyHash = IPv4TCPMapper::KeyHash;
+
+        std::vector<Session>     batch_keys(batch);
+        std::vector<std::size_t> hashes(batch);
+
+        found = 0;
+        const double batched_ms{measure([&]() {
+            for(uint32_t b = 0; b < lookups; b += batch)
+            {
+                const uint32_t count{std::min(batch, lookups - b)};
+                for(uint32_t i = 0; i < count; ++i)
+                {
+                    batch_keys[i] = canonical(keys[b + i]);
+                    hashes[i]     = KeyHash{}(batch_keys[i]);
+                    table.prefetch_bucket(hashes[i]);
+                }
+                for(uint32_t i = 0; i < count; ++i)
+                {
+                    found += table.find(batch_keys[i], hashes[i]) != nullptr;
+                }
+            }
+        })};
+        report("open addressing, batched", batched_ms, found);
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
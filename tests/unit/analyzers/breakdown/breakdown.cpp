@@ -40,7 +40,7 @@ class BreakdownTest : public ::testing::Test
 {
 protected:
     size_t  count;
-    timeval t;
+    int64_t t{0};
 
 public:
     void SetUp()
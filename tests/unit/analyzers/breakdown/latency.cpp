@@ -40,17 +40,14 @@ class LatencyTest : public ::testing::Test
 {
 protected:
     size_t  count;
-    timeval t1;
-    timeval t2;
+    int64_t t1;
+    int64_t t2;
 
 public:
     void SetUp()
     {
-        t1.tv_sec = 10;
-        t2.tv_sec = 2;
-
-        t1.tv_usec = 12;
-        t2.tv_usec = 4;
+        t1 = 10000000012; // nanoseconds
+        t2 = 2000000004;
 
         std::srand(std::time(0)); //use current time as seed for random generator
         count = std::rand() % 100 + 3;
@@ -73,11 +70,8 @@ TEST_F(LatencyTest, max_min)
 
     EXPECT_EQ(2U, latency.get_count());
 
-    EXPECT_EQ(t2.tv_sec, latency.get_min().tv_sec);
-    EXPECT_EQ(t2.tv_usec, latency.get_min().tv_usec);
-
-    EXPECT_EQ(t1.tv_sec, latency.get_max().tv_sec);
-    EXPECT_EQ(t1.tv_usec, latency.get_max().tv_usec);
+    EXPECT_EQ(t2, latency.get_min());
+    EXPECT_EQ(t1, latency.get_max());
 }
 
 TEST_F(LatencyTest, avg)
@@ -95,7 +89,52 @@ TEST_F(LatencyTest, avg)
     EXPECT_NEAR(6.0, latency.get_avg(), 0.0001);
 }
 
-TEST_F(LatencyTest, convert_timeval_to_sec)
+TEST_F(LatencyTest, submicrosecond_latency)
+{
+    Latencies latency;
+
+    latency.add(20000); // 20 microseconds
+    latency.add(30500);
+
+    EXPECT_EQ(20000, latency.get_min());
+    EXPECT_EQ(30500, latency.get_max());
+    EXPECT_NEAR(0.00002525, latency.get_avg(), 1e-12);
+}
+
+TEST_F(LatencyTest, zero_latency)
+{
+    Latencies latency;
+
+    latency.add(0);
+    latency.add(t2);
+
+    EXPECT_EQ(0, latency.get_min());
+    EXPECT_EQ(t2, latency.get_max());
+}
+
+TEST_F(LatencyTest, merge)
+{
+    Latencies all;
+    Latencies first;
+    Latencies second;
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        const int64_t t = (i % 2) ? t1 + i : t2 - i;
+        all.add(t);
+        (i < count / 2 ? first : second).add(t);
+    }
+    first.merge(second);
+    first.merge(Latencies{});
+
+    EXPECT_EQ(all.get_count(), first.get_count());
+    EXPECT_EQ(all.get_min(), first.get_min());
+    EXPECT_EQ(all.get_max(), first.get_max());
+    EXPECT_NEAR(all.get_avg(), first.get_avg(), 1e-9);
+    EXPECT_NEAR(all.get_st_dev(), first.get_st_dev(), 1e-9);
+}
+
+TEST_F(LatencyTest, convert_nanoseconds_to_sec)
 {
     /* This test checks to_sec() function and rounding its result to smaller
      * precision via std::ios_base::precision()
@@ -110,9 +149,7 @@ TEST_F(LatencyTest, convert_timeval_to_sec)
      * predictable conversions and rounding on various platforms.
      */
 
-    struct timeval input;
-    input.tv_sec  = 0;
-    input.tv_usec = 500;
+    const int64_t input{500000}; // 500 microseconds
 
     const auto sec = to_sec(input);
 
@@ -59,22 +59,21 @@ public:
     MOCK_METHOD0(mock_function, void(void));
 };
 
-class Proc
+class Proc : public Procedure<int>
 {
 public:
     Proc()
-        : session(&_session)
-        , rtimestamp(&_rtimestamp)
-        , ctimestamp(&_ctimestamp)
+        : _rtimestamp{}
+        , _ctimestamp{}
     {
+        session    = &_session;
+        rtimestamp = &_rtimestamp.tv;
+        ctimestamp = &_ctimestamp.tv;
     }
 
-    Session        _session;
-    timeval        _rtimestamp;
-    timeval        _ctimestamp;
-    const Session* session;
-    const timeval* rtimestamp;
-    const timeval* ctimestamp;
+    Session   _session;
+    Timestamp _rtimestamp;
+    Timestamp _ctimestamp;
 };
 }
 //------------------------------------------------------------------------------
@@ -118,9 +118,9 @@ int Parameters::verbose_level() const
     return 0;
 }
 
-const NST::filtration::pcap::CaptureReader::Params Parameters::capture_params() const
+const std::vector<NST::filtration::pcap::CaptureReader::Params> Parameters::capture_params() const
 {
-    return NST::filtration::pcap::CaptureReader::Params();
+    return {NST::filtration::pcap::CaptureReader::Params()};
 }
 
 const NST::filtration::Dumping::Params Parameters::dumping_params() const
@@ -73,6 +73,10 @@ public:
             }
         }
 
+        virtual void skip_payload(const PacketInfo&)
+        {
+        }
+
         virtual void complete(PacketInfo& info)
         {
             if(pImpl)
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for scanner of SMB2 compounded commands
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "filtration/command_chain.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration;
+using namespace NST::protocols;
+using NST::API::SMBv2::SMBv2Commands;
+//------------------------------------------------------------------------------
+namespace
+{
+// append SMB2 command of length bytes to message
+void command(std::vector<uint8_t>& message, SMBv2Commands cmd, size_t length, bool last)
+{
+    const size_t offset{message.size()};
+    message.resize(offset + length);
+
+    CIFSv2::RawMessageHeader header;
+    memset(&header, 0, sizeof(header));
+    header.head.protocol_code = CIFSv1::ProtocolCodes::SMB2;
+    memcpy(header.head.protocol, "SMB", 3);
+    header.cmd_code    = cmd;
+    header.nextCommand = last ? 0 : length;
+    memcpy(&message[offset], &header, sizeof(header));
+}
+
+// WRITE request with data at offset 112
+void write(std::vector<uint8_t>& message, size_t length, bool last)
+{
+    const size_t offset{message.size()};
+    command(message, SMBv2Commands::WRITE, length, last);
+
+    NST::API::SMBv2::WriteRequest request;
+    memset(&request, 0, sizeof(request));
+    request.structureSize = 49;
+    request.dataOffset    = sizeof(CIFSv2::RawMessageHeader) + offsetof(NST::API::SMBv2::WriteRequest, Buffer);
+    memcpy(&message[offset + sizeof(CIFSv2::RawMessageHeader)], &request, 8);
+}
+} // namespace
+
+TEST(CommandChain, cutCommands)
+{
+    std::vector<uint8_t> message;
+    command(message, SMBv2Commands::CREATE, 120, false);
+    write(message, 1024, false);
+    command(message, SMBv2Commands::CLOSE, 88, true);
+
+    CommandChain chain;
+    chain.start();
+
+    size_t data{0};
+    bool   cut{false};
+
+    // CREATE is queued as is, feed it by pieces as it comes in stream
+    EXPECT_EQ(100U, chain.scan(message.data(), 100, data, cut));
+    EXPECT_FALSE(cut);
+    EXPECT_EQ(20U, chain.scan(message.data() + 100, message.size() - 100, data, cut));
+    EXPECT_TRUE(cut);
+    EXPECT_EQ(0U, data);
+
+    // data of WRITE is skipped up to the next command
+    cut = false;
+    EXPECT_EQ(112U, chain.scan(message.data() + 120, message.size() - 120, data, cut));
+    EXPECT_TRUE(cut);
+    EXPECT_EQ(1024U - 112U, data);
+
+    // CLOSE is the last command
+    data = 0;
+    cut  = false;
+    EXPECT_EQ(88U, chain.scan(message.data() + 1144, 88, data, cut));
+    EXPECT_FALSE(cut);
+    EXPECT_EQ(0U, data);
+    EXPECT_FALSE(chain.in_progress());
+}
+
+TEST(CommandChain, skipDataOfLastCommand)
+{
+    std::vector<uint8_t> message;
+    command(message, SMBv2Commands::CREATE, 120, false);
+    write(message, 1024, true);
+
+    CommandChain chain;
+    chain.start();
+
+    size_t data{0};
+    bool   cut{false};
+    EXPECT_EQ(120U, chain.scan(message.data(), message.size(), data, cut));
+    cut = false;
+    EXPECT_EQ(112U, chain.scan(message.data() + 120, message.size() - 120, data, cut));
+    EXPECT_FALSE(cut);
+    EXPECT_LT(1024U, data); // up to the end of message
+    EXPECT_FALSE(chain.in_progress());
+}
+
+TEST(CommandChain, stopAtWrongHeader)
+{
+    std::vector<uint8_t> message;
+    command(message, SMBv2Commands::CREATE, 120, false);
+    command(message, SMBv2Commands::CLOSE, 90, false); // isn't aligned
+
+    CommandChain chain;
+    chain.start();
+
+    size_t data{0};
+    bool   cut{false};
+    EXPECT_EQ(120U, chain.scan(message.data(), message.size(), data, cut));
+    cut = false;
+    EXPECT_EQ(message.size() - 120, chain.scan(message.data() + 120, message.size() - 120, data, cut));
+    EXPECT_FALSE(cut);
+    EXPECT_FALSE(chain.in_progress());
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for scanner of NFSv4 COMPOUND
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "filtration/compound_scanner.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration;
+using Op = NST::API::ProcEnumNFS41;
+//------------------------------------------------------------------------------
+namespace
+{
+// XDR encoded message
+struct Message : std::vector<uint8_t>
+{
+    Message& word(uint32_t value)
+    {
+        for(int shift{24}; shift >= 0; shift -= 8)
+        {
+            push_back(static_cast<uint8_t>(value >> shift));
+        }
+        return *this;
+    }
+
+    Message& zeros(std::size_t n)
+    {
+        insert(end(), n, 0);
+        return *this;
+    }
+};
+
+// SEQUENCE, PUTFH, WRITE of 5 bytes, GETATTR
+Message write_call()
+{
+    Message m;
+    m.word(1).word(8).zeros(8); // AUTH_UNIX credentials
+    m.word(0).word(0);          // AUTH_NONE verifier
+    m.word(3).zeros(4);         // tag
+    m.word(1).word(4);          // minor version, count of operations
+    m.word(Op::SEQUENCE).zeros(32);
+    m.word(Op::PUTFH).word(6).zeros(8);
+    m.word(Op::WRITE).zeros(28).word(5).zeros(8);
+    m.word(Op::GETATTR).word(1).zeros(4);
+    return m;
+}
+
+// SEQUENCE, PUTFH, READ of 7 bytes
+Message read_reply()
+{
+    Message m;
+    m.word(0).word(0); // AUTH_NONE verifier
+    m.word(0);         // accepted successfully
+    m.word(0).word(0); // status, empty tag
+    m.word(3);         // count of operations
+    m.word(Op::SEQUENCE).word(0).zeros(36);
+    m.word(Op::PUTFH).word(0);
+    m.word(Op::READ).word(0).word(1).word(7).zeros(8);
+    return m;
+}
+} // namespace
+
+TEST(CompoundScanner, findWritePayload)
+{
+    const Message m{write_call()};
+    const std::size_t offset{m.size() - 8 - 12}; // data and GETATTR follow length
+
+    CompoundScanner scanner;
+    scanner.call();
+
+    // feed message byte by byte as it comes by pieces in stream
+    std::size_t payload{0};
+    std::size_t i{0};
+    while(scanner.active())
+    {
+        ASSERT_LT(i, m.size());
+        i += scanner.scan(m.data() + i, 1, payload);
+    }
+    EXPECT_EQ(offset, i);
+    EXPECT_EQ(8U, payload);
+}
+
+TEST(CompoundScanner, findReadPayload)
+{
+    const Message m{read_reply()};
+
+    CompoundScanner scanner;
+    scanner.reply();
+
+    std::size_t payload{0};
+    EXPECT_EQ(m.size() - 8, scanner.scan(m.data(), m.size(), payload));
+    EXPECT_EQ(8U, payload);
+    EXPECT_FALSE(scanner.active());
+}
+
+TEST(CompoundScanner, stopAtUnknown)
+{
+    Message m;
+    m.word(6).word(0).zeros(64); // RPCSEC_GSS credentials
+
+    CompoundScanner scanner;
+    scanner.call();
+
+    std::size_t payload{0};
+    EXPECT_EQ(m.size(), scanner.scan(m.data(), m.size(), payload));
+    EXPECT_EQ(0U, payload);
+    EXPECT_FALSE(scanner.active());
+
+    m = read_reply();
+    m[24 + 44 + 4 + 3] = 1; // PUTFH failed
+    scanner.reply();
+    EXPECT_EQ(m.size(), scanner.scan(m.data(), m.size(), payload));
+    EXPECT_EQ(0U, payload);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,261 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for parallel decompressor of trace files
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#ifdef WITH_BZIP2
+#include <bzlib.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "filtration/pcap/decompressor.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration::pcap;
+//------------------------------------------------------------------------------
+namespace
+{
+class DecompressorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char name[] = "decompressor_XXXXXX";
+        const int fd{mkstemp(name)};
+        ASSERT_NE(-1, fd);
+        close(fd);
+        file = name;
+    }
+
+    void TearDown() override
+    {
+        unlink(file.c_str());
+    }
+
+    void write(const std::string& data)
+    {
+        FILE* f{fopen(file.c_str(), "wb")};
+        ASSERT_NE(nullptr, f);
+        fwrite(data.data(), 1, data.size(), f);
+        fclose(f);
+    }
+
+    // decompressed content of file, failed is set on error of reading
+    std::string read(bool& failed)
+    {
+        Decompressor decompressor{file, Decompressor::detect(file)};
+        FILE*        stream{decompressor.open()};
+
+        std::string data;
+        char        buffer[64 * 1024];
+        std::size_t n;
+        while((n = fread(buffer, 1, sizeof(buffer), stream)) > 0)
+        {
+            data.append(buffer, n);
+        }
+        failed = ferror(stream);
+        fclose(stream);
+        return data;
+    }
+
+    std::string file;
+};
+
+// bytes of pseudo-random choice from given set, each chunk has all of them,
+// a byte isn't repeated, so bzip2 doesn't add lengths of runs to the set
+std::string generate(const std::vector<uint8_t>& set, std::size_t size)
+{
+    std::string data;
+    uint32_t    state{12345};
+    while(data.size() < size)
+    {
+        for(const uint8_t byte : set)
+        {
+            data.push_back(byte);
+        }
+        for(std::size_t i = 0; i < 4000; ++i)
+        {
+            state = state * 1103515245 + 12345;
+
+            std::size_t index{(state >> 16) % set.size()};
+            if(char(set[index]) == data.back())
+            {
+                index = (index + 1) % set.size();
+            }
+            data.push_back(set[index]);
+        }
+    }
+    data.resize(size);
+    return data;
+}
+
+#ifdef WITH_BZIP2
+std::string bzip2(const std::string& data, int block_size_100k)
+{
+    std::vector<char> buffer(data.size() + data.size() / 50 + 1024);
+    unsigned int      length(buffer.size());
+    const int         ret{BZ2_bzBuffToBuffCompress(buffer.data(), &length,
+                                           const_cast<char*>(data.data()), data.size(),
+                                           block_size_100k, 0, 0)};
+    EXPECT_EQ(BZ_OK, ret);
+    return std::string(buffer.data(), length);
+}
+
+// bit positions of bzip2 block magic number in data
+std::vector<uint64_t> find_block_magic(const std::string& data)
+{
+    std::vector<uint64_t> found;
+
+    uint64_t window{0};
+    for(std::size_t i = 0; i < data.size() * 8; ++i)
+    {
+        const uint8_t byte = data[i / 8];
+        window             = ((window << 1) | ((byte >> (7 - i % 8)) & 1)) & 0xffffffffffff;
+        if(i >= 47 && window == 0x314159265359)
+        {
+            found.push_back(i - 47);
+        }
+    }
+    return found;
+}
+
+// set of bytes whose bitmap of block header contains block magic number:
+// the map is 16-bit mask of used ranges of 16 bytes and 16-bit mask of used
+// bytes for each range, the first byte of range is the most significant bit
+std::vector<uint8_t> bytes_with_magic_in_map()
+{
+    const uint16_t masks[16]{
+        0x3141, 0x5926, 0x5359, // magic number
+        0x8000, 0x8000,         // CRC of block
+        0x0001,                 // not randomised, origPtr is less than max block
+        0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000};
+
+    std::vector<uint8_t> set;
+    for(unsigned range = 0; range < 16; ++range)
+    {
+        for(unsigned i = 0; i < 16; ++i)
+        {
+            if(masks[range] & (0x8000 >> i))
+            {
+                set.push_back(range * 16 + i);
+            }
+        }
+    }
+    return set;
+}
+#endif
+
+std::vector<uint8_t> all_bytes()
+{
+    std::vector<uint8_t> set;
+    for(unsigned i = 0; i < 256; ++i)
+    {
+        set.push_back(i);
+    }
+    return set;
+}
+
+} // unnamed namespace
+//------------------------------------------------------------------------------
+TEST_F(DecompressorTest, detect)
+{
+    write("BZh9");
+    EXPECT_EQ(Decompressor::Format::BZip2, Decompressor::detect(file));
+    write(std::string{"\x1f\x8b\x08\x00", 4});
+    EXPECT_EQ(Decompressor::Format::GZip, Decompressor::detect(file));
+    write("\x28\xb5\x2f\xfd");
+    EXPECT_EQ(Decompressor::Format::ZStd, Decompressor::detect(file));
+    write("\xd4\xc3\xb2\xa1");
+    EXPECT_EQ(Decompressor::Format::None, Decompressor::detect(file));
+    write("BZ");
+    EXPECT_EQ(Decompressor::Format::None, Decompressor::detect(file));
+}
+
+#ifdef WITH_BZIP2
+TEST_F(DecompressorTest, bzip2Blocks)
+{
+    const std::string data{generate(all_bytes(), 450000)};
+    const std::string compressed{bzip2(data, 1)};
+    ASSERT_LT(4u, find_block_magic(compressed).size()); // blocks aren't aligned to bytes
+
+    write(compressed);
+    bool failed;
+    const std::string decompressed{read(failed)};
+    EXPECT_EQ(data.size(), decompressed.size());
+    EXPECT_TRUE(data == decompressed);
+    EXPECT_FALSE(failed);
+}
+
+TEST_F(DecompressorTest, bzip2ConcatenatedStreams)
+{
+    const std::string first{generate(all_bytes(), 150000)};
+    const std::string second{generate({'a', 'b', 'c'}, 250000)};
+
+    write(bzip2(first, 1) + bzip2(second, 2));
+    bool failed;
+    const std::string decompressed{read(failed)};
+    EXPECT_EQ(first.size() + second.size(), decompressed.size());
+    EXPECT_TRUE(first + second == decompressed);
+    EXPECT_FALSE(failed);
+}
+
+TEST_F(DecompressorTest, bzip2MagicInsideBlock)
+{
+    const std::string data{generate(bytes_with_magic_in_map(), 350000)};
+    const std::string compressed{bzip2(data, 1)};
+
+    // each block has magic of its own and one more in its header
+    const auto found = find_block_magic(compressed);
+    ASSERT_LE(6u, found.size());
+    ASSERT_EQ(0u, found.size() % 2);
+    for(std::size_t i = 0; i < found.size(); i += 2)
+    {
+        EXPECT_EQ(found[i] + 48 + 32 + 1 + 24 + 16, found[i + 1]);
+    }
+
+    write(compressed);
+    bool failed;
+    const std::string decompressed{read(failed)};
+    EXPECT_EQ(data.size(), decompressed.size());
+    EXPECT_TRUE(data == decompressed);
+    EXPECT_FALSE(failed);
+}
+
+TEST_F(DecompressorTest, bzip2Truncated)
+{
+    const std::string data{generate(all_bytes(), 350000)};
+    const std::string compressed{bzip2(data, 1)};
+
+    write(compressed.substr(0, compressed.size() - 1000));
+    bool failed;
+    const std::string decompressed{read(failed)};
+    EXPECT_TRUE(failed);
+    EXPECT_GT(data.size(), decompressed.size());
+    EXPECT_TRUE(data.compare(0, decompressed.size(), decompressed) == 0);
+}
+#endif
+//------------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for reassembly of IP fragments
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "filtration/defragmentation.h"
+#include "frames.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration;
+using namespace frames;
+//------------------------------------------------------------------------------
+namespace
+{
+const uint32_t payload_size{40}; // UDP header and 32 bytes of data
+
+// Ethernet frame of IPv4 fragment of UDP datagram with payload 0, 1, 2...
+Frame fragment(uint16_t id, uint32_t offset, uint32_t length, bool more)
+{
+    Frame payload(length);
+    for(uint32_t i = 0; i < length; ++i)
+    {
+        payload[i] = offset + i;
+    }
+    if(offset == 0) // UDP header
+    {
+        const Frame datagram{udp_datagram(800, 2049, Frame(payload_size - 8))};
+        std::copy(datagram.begin(), datagram.begin() + 8, payload.begin());
+    }
+
+    const uint16_t flags{uint16_t(more ? 0x2000 : 0x0000)};
+    return eth_frame(0x0800) + ipv4_packet(17, 0x0a000001, 0x0a000002, payload, id, flags | offset / 8);
+}
+
+const Defragmentation::Datagram* add(Defragmentation& d, const Frame& frame, uint64_t seconds = 1)
+{
+    struct pcap_pkthdr header;
+    header.ts.tv_sec  = seconds;
+    header.ts.tv_usec = 0;
+    header.caplen = header.len = frame.size();
+
+    PacketInfo info(&header, frame.data(), DLT_EN10MB);
+    EXPECT_NE(nullptr, info.fragment);
+    return d.add(info);
+}
+
+std::string statistic(const Defragmentation& d)
+{
+    std::ostringstream out;
+    d.print_statistic(out);
+    return out.str();
+}
+} // unnamed namespace
+
+TEST(Defragmentation, reassembleInAnyOrder)
+{
+    Defragmentation d;
+
+    EXPECT_EQ(nullptr, add(d, fragment(1, 16, 16, true)));
+    EXPECT_EQ(nullptr, add(d, fragment(1, 32, 8, false)));
+    auto datagram = add(d, fragment(1, 0, 16, true));
+    ASSERT_NE(nullptr, datagram);
+
+    EXPECT_EQ(14U + 20U + payload_size, datagram->header.caplen);
+    EXPECT_EQ(datagram->frame + 14, datagram->ip);
+
+    struct pcap_pkthdr header = datagram->header;
+    PacketInfo         info(&header, datagram->frame, datagram->ip, 0);
+    ASSERT_NE(nullptr, info.ipv4);
+    ASSERT_NE(nullptr, info.udp);
+    EXPECT_FALSE(info.ipv4->is_fragmented());
+    EXPECT_EQ(20U + payload_size, info.ipv4->length());
+    ASSERT_EQ(payload_size - 8, info.dlen);
+    for(uint32_t i = 0; i < info.dlen; ++i)
+    {
+        EXPECT_EQ(uint8_t(8 + i), info.data[i]);
+    }
+}
+
+TEST(Defragmentation, overlappingFragments)
+{
+    Defragmentation d;
+
+    EXPECT_EQ(nullptr, add(d, fragment(2, 0, 16, true)));
+    EXPECT_EQ(nullptr, add(d, fragment(2, 0, 16, true)));  // duplicate is ignored
+    EXPECT_EQ(nullptr, add(d, fragment(2, 8, 16, true)));  // discards datagram
+    EXPECT_EQ(nullptr, add(d, fragment(2, 16, 24, false))); // new datagram without first fragment
+
+    EXPECT_NE(std::string::npos, statistic(d).find("2 overlapping fragments"));
+}
+
+TEST(Defragmentation, expireAndEvict)
+{
+    Defragmentation d{2, 30ULL * 1000 * 1000 * 1000};
+
+    EXPECT_EQ(nullptr, add(d, fragment(3, 0, 16, true), 1));
+    EXPECT_EQ(nullptr, add(d, fragment(4, 0, 16, true), 2));
+    EXPECT_EQ(nullptr, add(d, fragment(5, 0, 16, true), 3)); // evicts 3
+    EXPECT_EQ(nullptr, add(d, fragment(6, 0, 16, true), 60)); // expires 4 and 5
+
+    EXPECT_EQ(nullptr, add(d, fragment(3, 16, 24, false), 61)); // first fragment is lost
+    EXPECT_NE(std::string::npos, statistic(d).find("2 expired, 1 evicted"));
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for decapsulation of captured packets
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "filtration/packet.h"
+#include "frames.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration;
+using namespace frames;
+//------------------------------------------------------------------------------
+namespace
+{
+const uint32_t payload_size{8};
+
+// IPv4 header of datagram with UDP header from port 800 to port
+Frame ipv4_udp(uint16_t port, const Frame& payload)
+{
+    return ipv4_packet(17, 0x0a000001, 0x0a000002, udp_datagram(800, port, payload));
+}
+
+// IPv4 header of GRE packet
+Frame ipv4_gre(const Frame& payload)
+{
+    return ipv4_packet(47, 0x0a000001, 0x0a000002, payload);
+}
+
+Frame inner()
+{
+    return eth_frame(0x0800) + ipv4_udp(2049, Frame(payload_size, 0xaa));
+}
+
+void expect_inner(const Captured& c, const PacketInfo& info)
+{
+    ASSERT_NE(nullptr, info.ipv4);
+    ASSERT_NE(nullptr, info.udp);
+    EXPECT_EQ(htons(2049), info.udp->dport());
+    EXPECT_EQ(payload_size, info.dlen);
+    EXPECT_EQ(c.frame.data() + c.frame.size() - payload_size, info.data);
+}
+} // unnamed namespace
+
+TEST(Encapsulation, vlanTags)
+{
+    Captured   c{eth_frame(0x88a8) + vlan_tag(10, 0x8100) + vlan_tag(20, 0x0800) + ipv4_udp(2049, Frame(payload_size))};
+    PacketInfo packet(&c.header, c.frame.data(), DLT_EN10MB);
+    expect_inner(c, packet);
+    EXPECT_EQ(PacketInfo::VLAN | PacketInfo::QINQ, packet.encapsulation);
+    EXPECT_EQ(2U, packet.depth);
+}
+
+TEST(Encapsulation, linuxCookedCapture)
+{
+    Frame sll(16);
+    sll[14] = 0x08; // IPv4
+    Captured   c{sll + ipv4_udp(2049, Frame(payload_size))};
+    PacketInfo packet(&c.header, c.frame.data(), DLT_LINUX_SLL);
+    expect_inner(c, packet);
+    EXPECT_EQ(nullptr, packet.eth);
+}
+
+TEST(Encapsulation, erspanTypeII)
+{
+    const Frame header{0x10, 0x00, 0x88, 0xbe, 0, 0, 0, 1}; // sequence number is present
+    const Frame erspan{0x10, 0x0a, 0x00, 0x01, 0, 0, 0, 0};
+
+    Captured   c{eth_frame(0x0800) + ipv4_gre(header + erspan + inner())};
+    PacketInfo packet(&c.header, c.frame.data(), DLT_EN10MB);
+    expect_inner(c, packet);
+    EXPECT_EQ(PacketInfo::GRE | PacketInfo::ERSPAN, packet.encapsulation);
+    EXPECT_EQ(c.frame.data() + 14 + 20 + 8 + 8, reinterpret_cast<const uint8_t*>(packet.eth));
+}
+
+TEST(Encapsulation, erspanTypeIII)
+{
+    const Frame header{0x00, 0x00, 0x22, 0xeb};
+    const Frame erspan{0x20, 0x0a, 0x00, 0x01, 0, 0, 0, 0, 0, 0, 0, 0x01}; // with subheader
+    const Frame subheader(8);
+
+    Captured   c{eth_frame(0x0800) + ipv4_gre(header + erspan + subheader + inner())};
+    PacketInfo packet(&c.header, c.frame.data(), DLT_EN10MB);
+    expect_inner(c, packet);
+    EXPECT_EQ(PacketInfo::GRE | PacketInfo::ERSPAN, packet.encapsulation);
+}
+
+TEST(Encapsulation, vxlanInVlan)
+{
+    const Frame header{0x08, 0, 0, 0, 0, 0, 0x64, 0};
+
+    Captured   c{eth_frame(0x8100) + vlan_tag(30, 0x0800) + ipv4_udp(4789, header + inner())};
+    PacketInfo packet(&c.header, c.frame.data(), DLT_EN10MB);
+    expect_inner(c, packet);
+    EXPECT_EQ(PacketInfo::VLAN | PacketInfo::VXLAN, packet.encapsulation);
+
+    // outer headers are replaced by inner ones
+    EXPECT_EQ(c.frame.data() + 14 + 4 + 28 + 8 + 14, reinterpret_cast<const uint8_t*>(packet.ipv4));
+}
+
+TEST(Encapsulation, boundedNesting)
+{
+    Frame frame{inner()};
+    for(uint32_t i = 0; i <= PacketInfo::max_depth; ++i)
+    {
+        const Frame header{0x00, 0x00, 0x65, 0x58}; // Transparent Ethernet Bridging
+        frame = eth_frame(0x0800) + ipv4_gre(header + frame);
+    }
+
+    Captured   c{frame};
+    PacketInfo packet(&c.header, c.frame.data(), DLT_EN10MB);
+    EXPECT_EQ(nullptr, packet.udp);
+    EXPECT_EQ(PacketInfo::GRE | PacketInfo::NESTED, packet.encapsulation);
+
+    Encapsulations statistic;
+    statistic.account(packet);
+
+    std::ostringstream out;
+    statistic.print_statistic(out);
+    EXPECT_EQ("Decapsulated packets: GRE 1, too deeply nested 1\n", out.str());
+}
+//------------------------------------------------------------------------------
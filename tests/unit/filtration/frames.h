@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Builders of captured frames for unit tests of filtration
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#ifndef FRAMES_H
+#define FRAMES_H
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+
+#include <pcap/pcap.h>
+//------------------------------------------------------------------------------
+namespace frames
+{
+// headers are built in network byte order and joined by operator+,
+// checksums are zero
+using Frame = std::vector<uint8_t>;
+
+inline Frame operator+(Frame head, const Frame& tail)
+{
+    head.insert(head.end(), tail.begin(), tail.end());
+    return head;
+}
+
+inline Frame eth_frame(uint16_t type)
+{
+    Frame frame(14);
+    frame[12] = type >> 8;
+    frame[13] = type & 0xff;
+    return frame;
+}
+
+inline Frame vlan_tag(uint16_t id, uint16_t type)
+{
+    return Frame{uint8_t(id >> 8), uint8_t(id & 0xff), uint8_t(type >> 8), uint8_t(type & 0xff)};
+}
+
+// fragment is field of flags and offset in 8-byte units
+inline Frame ipv4_packet(uint8_t protocol, uint32_t src, uint32_t dst, const Frame& payload,
+                         uint16_t id = 0, uint16_t fragment = 0)
+{
+    const uint32_t length{20 + uint32_t(payload.size())};
+
+    Frame ip(20);
+    ip[0] = 0x45;
+    ip[2] = length >> 8;
+    ip[3] = length & 0xff;
+    ip[4] = id >> 8;
+    ip[5] = id & 0xff;
+    ip[6] = fragment >> 8;
+    ip[7] = fragment & 0xff;
+    ip[8] = 64;
+    ip[9] = protocol;
+    for(unsigned i = 0; i < 4; ++i)
+    {
+        ip[12 + i] = src >> (24 - 8 * i);
+        ip[16 + i] = dst >> (24 - 8 * i);
+    }
+    return ip + payload;
+}
+
+inline Frame udp_datagram(uint16_t sport, uint16_t dport, const Frame& payload)
+{
+    const uint32_t length{8 + uint32_t(payload.size())};
+
+    const Frame header{uint8_t(sport >> 8), uint8_t(sport & 0xff), uint8_t(dport >> 8), uint8_t(dport & 0xff),
+                       uint8_t(length >> 8), uint8_t(length & 0xff), 0, 0};
+    return header + payload;
+}
+
+inline Frame tcp_segment(uint16_t sport, uint16_t dport, uint32_t seq, uint32_t ack, const Frame& payload)
+{
+    Frame header(20);
+    header[0] = sport >> 8;
+    header[1] = sport & 0xff;
+    header[2] = dport >> 8;
+    header[3] = dport & 0xff;
+    for(unsigned i = 0; i < 4; ++i)
+    {
+        header[4 + i] = seq >> (24 - 8 * i);
+        header[8 + i] = ack >> (24 - 8 * i);
+    }
+    header[12] = 0x50; // data offset
+    return header + payload;
+}
+
+// frame with header of its capture
+struct Captured
+{
+    Captured(const Frame& f, long seconds = 1)
+        : frame(f)
+    {
+        header.ts.tv_sec  = seconds;
+        header.ts.tv_usec = 0;
+        header.caplen = header.len = frame.size();
+    }
+
+    Frame              frame;
+    struct pcap_pkthdr header;
+};
+
+} // namespace frames
+//------------------------------------------------------------------------------
+#endif // FRAMES_H
+//------------------------------------------------------------------------------
@@ -0,0 +1,294 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for reader of memory-mapped pcap and pcapng files
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "filtration/pcap/mapped_file_reader.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration::pcap;
+//------------------------------------------------------------------------------
+namespace
+{
+// little-endian or big-endian image of trace file
+class Image
+{
+public:
+    explicit Image(bool big_endian = false)
+        : big{big_endian}
+    {
+    }
+
+    Image& u8(uint8_t v)
+    {
+        bytes.push_back(v);
+        return *this;
+    }
+
+    Image& u16(uint16_t v) { return put(v, 2); }
+    Image& u32(uint32_t v) { return put(v, 4); }
+    Image& u64(uint64_t v) { return put(v, 8); }
+
+    Image& data(const std::vector<uint8_t>& v)
+    {
+        bytes.insert(bytes.end(), v.begin(), v.end());
+        return *this;
+    }
+
+    // pcapng block with trailing length, body is padded to 32 bits
+    Image& block(uint32_t type, const Image& body)
+    {
+        const uint32_t padded = (body.bytes.size() + 3) & ~3;
+        u32(type).u32(12 + padded).data(body.bytes);
+        bytes.resize(bytes.size() + padded - body.bytes.size());
+        return u32(12 + padded);
+    }
+
+    bool                 big;
+    std::vector<uint8_t> bytes;
+
+private:
+    Image& put(uint64_t v, unsigned size)
+    {
+        for(unsigned i = 0; i < size; ++i)
+        {
+            bytes.push_back(v >> ((big ? size - 1 - i : i) * 8));
+        }
+        return *this;
+    }
+};
+
+struct Packet
+{
+    int64_t              sec;
+    int64_t              usec;
+    uint32_t             caplen;
+    uint32_t             len;
+    std::vector<uint8_t> data;
+};
+
+const std::vector<uint8_t> payload{0xde, 0xad, 0xbe, 0xef};
+
+Image pcap_header(uint32_t magic, bool big_endian)
+{
+    Image header{big_endian};
+    header.u32(magic).u16(2).u16(4).u32(0).u32(0).u32(65535).u32(1 /*Ethernet*/);
+    return header;
+}
+
+Image pcapng_section(bool big_endian = false)
+{
+    Image body{big_endian};
+    body.u32(0x1a2b3c4d).u16(1).u16(0).u64(uint64_t(-1));
+
+    Image section{big_endian};
+    return section.block(0x0a0d0d0a, body);
+}
+
+// Interface Description Block with if_tsresol and if_tsoffset options
+Image& interface(Image& image, int tsresol, int64_t tsoffset)
+{
+    Image body{image.big};
+    body.u16(1 /*Ethernet*/).u16(0).u32(65535);
+    if(tsresol >= 0)
+    {
+        body.u16(9).u16(1).u8(tsresol).u8(0).u16(0);
+    }
+    if(tsoffset)
+    {
+        body.u16(14).u16(8).u64(tsoffset);
+    }
+    body.u16(0).u16(0);
+    return image.block(0x00000001, body);
+}
+
+Image& enhanced_packet(Image& image, uint64_t timestamp, uint32_t len = 60)
+{
+    Image body{image.big};
+    body.u32(0).u32(timestamp >> 32).u32(timestamp).u32(payload.size()).u32(len).data(payload);
+    return image.block(0x00000006, body);
+}
+
+class MappedFileReaderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char name[] = "mapped_file_reader_XXXXXX";
+        const int fd{mkstemp(name)};
+        ASSERT_NE(-1, fd);
+        close(fd);
+        file = name;
+    }
+
+    void TearDown() override
+    {
+        unlink(file.c_str());
+    }
+
+    std::vector<Packet> read(const Image& image)
+    {
+        FILE* f{fopen(file.c_str(), "wb")};
+        EXPECT_NE(nullptr, f);
+        fwrite(image.bytes.data(), 1, image.bytes.size(), f);
+        fclose(f);
+
+        EXPECT_TRUE(MappedFileReader::is_supported(file));
+
+        MappedFileReader reader{file};
+        unit = reader.tstamp_unit();
+        EXPECT_EQ(1 /*Ethernet*/, reader.datalink());
+
+        std::vector<Packet> packets;
+        EXPECT_TRUE(reader.loop(&packets, &callback));
+        return packets;
+    }
+
+    static void callback(u_char* user, const struct pcap_pkthdr* header, const u_char* packet)
+    {
+        auto& packets = *reinterpret_cast<std::vector<Packet>*>(user);
+        packets.push_back(Packet{header->ts.tv_sec, header->ts.tv_usec, header->caplen, header->len,
+                                 std::vector<uint8_t>(packet, packet + header->caplen)});
+    }
+
+    std::string file;
+    int64_t     unit; // nanoseconds in ts.tv_usec of packets
+};
+
+} // unnamed namespace
+//------------------------------------------------------------------------------
+TEST_F(MappedFileReaderTest, pcapMicroseconds)
+{
+    Image image{pcap_header(0xa1b2c3d4, false)};
+    image.u32(10).u32(500000).u32(payload.size()).u32(60).data(payload);
+    image.u32(11).u32(999999).u32(payload.size()).u32(4).data(payload);
+
+    const auto packets = read(image);
+    ASSERT_EQ(2u, packets.size());
+    EXPECT_EQ(10, packets[0].sec);
+    EXPECT_EQ(500000000 / unit, packets[0].usec);
+    EXPECT_EQ(payload.size(), packets[0].caplen);
+    EXPECT_EQ(60u, packets[0].len);
+    EXPECT_EQ(payload, packets[0].data);
+    EXPECT_EQ(11, packets[1].sec);
+    EXPECT_EQ(999999000 / unit, packets[1].usec);
+}
+
+TEST_F(MappedFileReaderTest, pcapNanosecondsSwapped)
+{
+    Image image{pcap_header(0xa1b23c4d, true)};
+    image.u32(1500000000).u32(123456789).u32(payload.size()).u32(60).data(payload);
+
+    const auto packets = read(image);
+    ASSERT_EQ(1u, packets.size());
+    EXPECT_EQ(1500000000, packets[0].sec);
+    EXPECT_EQ(123456789 / unit, packets[0].usec);
+    EXPECT_EQ(60u, packets[0].len);
+    EXPECT_EQ(payload, packets[0].data);
+}
+
+TEST_F(MappedFileReaderTest, pcapTruncatedRecord)
+{
+    Image image{pcap_header(0xa1b2c3d4, false)};
+    image.u32(1).u32(0).u32(payload.size()).u32(60).data(payload);
+    image.u32(2).u32(0).u32(100).u32(100).data(payload); // caplen exceeds file
+
+    const auto packets = read(image);
+    ASSERT_EQ(1u, packets.size());
+    EXPECT_EQ(1, packets[0].sec);
+}
+
+TEST_F(MappedFileReaderTest, pcapngNanosecondsAndOffset)
+{
+    Image image{pcapng_section()};
+    interface(image, 9, 100);
+    enhanced_packet(image, 1500000000123456789ull);
+
+    // Simple Packet Block of the first interface has no timestamp
+    Image simple;
+    simple.u32(payload.size()).data(payload);
+    image.block(0x00000003, simple);
+
+    const auto packets = read(image);
+    ASSERT_EQ(2u, packets.size());
+    EXPECT_EQ(1500000100, packets[0].sec);
+    EXPECT_EQ(123456789 / unit, packets[0].usec);
+    EXPECT_EQ(60u, packets[0].len);
+    EXPECT_EQ(payload, packets[0].data);
+    EXPECT_EQ(100, packets[1].sec); // only offset of interface
+    EXPECT_EQ(payload, packets[1].data);
+}
+
+TEST_F(MappedFileReaderTest, pcapngResolutions)
+{
+    Image image{pcapng_section(true)};
+    interface(image, -1, 0);         // microseconds by default
+    interface(image, 0x80 | 10, -5); // 1/1024 of second
+
+    Image packet{true};
+    packet.u32(1).u32(0).u32(5 * 1024 + 512).u32(payload.size()).u32(60).data(payload);
+    enhanced_packet(image, 7000001);
+    image.block(0x00000006, packet);
+
+    const auto packets = read(image);
+    ASSERT_EQ(2u, packets.size());
+    EXPECT_EQ(7, packets[0].sec);
+    EXPECT_EQ(1000 / unit, packets[0].usec);
+    EXPECT_EQ(0, packets[1].sec);
+    EXPECT_EQ(500000000 / unit, packets[1].usec);
+}
+
+TEST_F(MappedFileReaderTest, pcapngTruncatedBlock)
+{
+    Image image{pcapng_section()};
+    interface(image, 9, 0);
+    enhanced_packet(image, 1000000000);
+    enhanced_packet(image, 2000000000);
+    image.bytes.resize(image.bytes.size() - 8); // cut the last block
+
+    const auto packets = read(image);
+    ASSERT_EQ(1u, packets.size());
+    EXPECT_EQ(1, packets[0].sec);
+}
+
+TEST_F(MappedFileReaderTest, pcapngCorruptedBlock)
+{
+    Image image{pcapng_section()};
+    interface(image, 9, 0);
+    enhanced_packet(image, 1000000000);
+
+    Image corrupted; // captured length exceeds the block
+    corrupted.u32(0).u32(0).u32(0).u32(100).u32(100).data(payload);
+    image.block(0x00000006, corrupted);
+    enhanced_packet(image, 3000000000);
+
+    const auto packets = read(image);
+    ASSERT_EQ(2u, packets.size());
+    EXPECT_EQ(1, packets[0].sec);
+    EXPECT_EQ(3, packets[1].sec);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for bounded set of xids of calls awaiting replies
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+
+#include "filtration/pending_calls.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration;
+//------------------------------------------------------------------------------
+TEST(PendingCalls, matchReplies)
+{
+    PendingCalls calls{8};
+    calls.insert(1);
+    calls.insert(2);
+
+    EXPECT_TRUE(calls.erase(2));
+    EXPECT_FALSE(calls.erase(2)); // duplicate reply
+    EXPECT_FALSE(calls.erase(3)); // reply to unseen call
+    EXPECT_TRUE(calls.erase(1));
+    EXPECT_EQ(0u, calls.size());
+}
+
+TEST(PendingCalls, unansweredCallsAreEvicted)
+{
+    PendingCalls calls{8};
+    for(uint32_t xid = 1; xid <= 1000; ++xid)
+    {
+        calls.insert(xid); // replies are never seen
+        EXPECT_GE(8u, calls.size());
+    }
+
+    // only the newest calls are awaited
+    EXPECT_FALSE(calls.erase(992));
+    for(uint32_t xid = 993; xid <= 1000; ++xid)
+    {
+        EXPECT_TRUE(calls.erase(xid));
+    }
+    EXPECT_EQ(0u, calls.size());
+}
+
+TEST(PendingCalls, answeredCallsDontEvictNewer)
+{
+    PendingCalls calls{4};
+    calls.insert(1);
+    calls.insert(2);
+    EXPECT_TRUE(calls.erase(1));
+    calls.insert(1); // xid is reused by a new call
+    calls.insert(3);
+    calls.insert(4); // ring position of the first 1 is overwritten
+    calls.insert(5); // evicts 2
+
+    EXPECT_FALSE(calls.erase(2));
+    EXPECT_TRUE(calls.erase(1));
+    EXPECT_TRUE(calls.erase(3));
+    EXPECT_TRUE(calls.erase(4));
+    EXPECT_TRUE(calls.erase(5));
+}
+//------------------------------------------------------------------------------
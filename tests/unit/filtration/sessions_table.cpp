@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for canonical keys and hash table of sessions
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "filtration/sessions_hash.h"
+#include "utils/crc32c.h"
+#include "frames.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration;
+using namespace frames;
+using NST::utils::CRC32C;
+//------------------------------------------------------------------------------
+namespace
+{
+// Ethernet:IPv4:TCP frame without payload
+struct TCPFrame : Captured
+{
+    TCPFrame(uint32_t src, uint16_t sport, uint32_t dst, uint16_t dport)
+        : Captured{eth_frame(0x0800) + ipv4_packet(6, src, dst, tcp_segment(sport, dport, 0, 0, Frame{}))}
+    {
+    }
+
+    NST::utils::Session key(PacketInfo::Direction& direction) const
+    {
+        PacketInfo          info(&header, frame.data(), DLT_EN10MB);
+        NST::utils::Session k;
+        IPv4TCPMapper::fill_hash_key(info, k);
+        direction = info.direction;
+        return k;
+    }
+};
+
+struct Node
+{
+    NST::utils::Session key;
+};
+
+// puts all keys with the same first port to the same home slot
+struct PortHash
+{
+    std::size_t operator()(const NST::utils::Session& key) const { return key.port[0]; }
+};
+
+using Table = SessionsTable<Node, PortHash, IPv4TCPMapper::KeyEqual>;
+
+Node* node(std::vector<std::unique_ptr<Node>>& nodes, uint16_t port0, uint16_t port1)
+{
+    nodes.emplace_back(new Node{});
+    Node* n{nodes.back().get()};
+    n->key.port[0] = port0;
+    n->key.port[1] = port1;
+    return n;
+}
+} // unnamed namespace
+
+TEST(SessionsTable, crc32cByTableAndInstruction)
+{
+    const uint32_t zero{0};
+    EXPECT_EQ(0x48674bc7u, ~CRC32C::software(~0u, &zero, 1)); // CRC32C of 4 zero bytes
+
+    const uint32_t words[]{0x0100000a, 0x6988060a, 0x08010390};
+    if(CRC32C::hardware_supported())
+    {
+        EXPECT_EQ(CRC32C::software(~0u, words, 3), CRC32C::hardware(~0u, words, 3));
+    }
+    EXPECT_EQ(CRC32C::software(~0u, words, 3), CRC32C::extend(~0u, words, 3));
+}
+
+TEST(SessionsTable, canonicalKeyOfBothDirections)
+{
+    const TCPFrame call{0x0a000001, 912, 0x0a000002, 2049};
+    const TCPFrame reply{0x0a000002, 2049, 0x0a000001, 912};
+
+    PacketInfo::Direction call_dir, reply_dir;
+    const auto            a = call.key(call_dir);
+    const auto            b = reply.key(reply_dir);
+
+    EXPECT_NE(call_dir, reply_dir);
+    EXPECT_TRUE(IPv4TCPMapper::KeyEqual{}(a, b));
+    EXPECT_EQ(IPv4TCPMapper::KeyHash{}(a), IPv4TCPMapper::KeyHash{}(b));
+
+    // neighbouring clients don't collide
+    const TCPFrame other{0x0a000002, 913, 0x0a000001, 2049};
+    PacketInfo::Direction other_dir;
+    const auto            c = other.key(other_dir);
+    EXPECT_FALSE(IPv4TCPMapper::KeyEqual{}(a, c));
+    EXPECT_NE(IPv4TCPMapper::KeyHash{}(a), IPv4TCPMapper::KeyHash{}(c));
+}
+
+TEST(SessionsTable, eraseShiftsCollidedNodesBack)
+{
+    std::vector<std::unique_ptr<Node>> nodes;
+    Table                              table{8};
+
+    Node* a{node(nodes, 6, 1)}; // home slot 6
+    Node* b{node(nodes, 6, 2)}; // probed to 7
+    Node* c{node(nodes, 7, 3)}; // probed to 0
+    Node* d{node(nodes, 1, 4)}; // home slot 1
+    for(Node* n : {a, b, c, d})
+    {
+        table.insert(n);
+    }
+
+    table.erase(a);
+    EXPECT_EQ(nullptr, table.find(a->key));
+    EXPECT_EQ(b, table.find(b->key));
+    EXPECT_EQ(c, table.find(c->key));
+    EXPECT_EQ(d, table.find(d->key));
+
+    table.erase(b);
+    EXPECT_EQ(c, table.find(c->key));
+    EXPECT_EQ(2u, table.size());
+}
+
+TEST(SessionsTable, growKeepsNodes)
+{
+    std::vector<std::unique_ptr<Node>> nodes;
+    Table                              table{4};
+
+    for(uint16_t i = 0; i < 100; ++i)
+    {
+        table.insert(node(nodes, i % 5, i));
+    }
+    EXPECT_EQ(100u, table.size());
+    EXPECT_GE(table.capacity() * 3, table.size() * 4);
+
+    for(auto& n : nodes)
+    {
+        EXPECT_EQ(n.get(), table.find(n->key));
+    }
+}
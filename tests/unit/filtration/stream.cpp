@@ -65,12 +65,17 @@ public:
         {
         }
 
+        virtual void skip_payload(const PacketInfo&)
+        {
+        }
+
         virtual void complete(PacketInfo& info)
         {
             if(pImpl)
             {
                 pImpl->complete(info);
             }
+            packet.clear(); // completed data are passed to writer
         }
 
         operator bool()
@@ -355,4 +360,39 @@ TEST(Filtration, pushRPCbyTCPStreamPartByPart)
     f.push(info2);
 }
 
+
+TEST(Filtration, pushRPCbyTCPStreamOfFragments)
+{
+    // Prepare data: record of two fragments and the next record
+    const uint8_t call[] = {0xec, 0x8a, 0x42, 0xcb,
+                            0x00, 0x00, 0x00, 0x00,  // msg type - call
+                            0x00, 0x00, 0x00, 0x02}; // RPC version
+
+    std::vector<uint8_t> packet;
+    for(const uint8_t mark : {0x00, 0x80}) // the first fragment isn't last
+    {
+        packet.insert(packet.end(), {mark, 0x00, 0x00, 0x80});
+        packet.insert(packet.end(), std::begin(call), std::end(call));
+        packet.resize(packet.size() + 0x80 - sizeof(call));
+        if(mark == 0x00) // the last fragment isn't RPC message
+        {
+            packet.insert(packet.end(), {0x80, 0x00, 0x00, 0x10});
+            packet.resize(packet.size() + 0x10);
+        }
+    }
+
+    struct pcap_pkthdr header;
+    header.caplen = header.len = packet.size();
+    PacketInfo info(&header, packet.data(), 0);
+    Writer     mock;
+    // Set conditions
+    EXPECT_CALL(mock.collection, complete(_))
+        .Times(2);
+
+    Filtrators<Writer> f;
+    f.set_writer(nullptr, &mock, 0);
+    // Check
+    f.push(info);
+}
+
 //------------------------------------------------------------------------------
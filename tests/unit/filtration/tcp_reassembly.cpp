@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for reassembly of TCP stream
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "filtration/filtration_processor.h"
+#include "frames.h"
+//------------------------------------------------------------------------------
+using namespace NST::filtration;
+using namespace frames;
+//------------------------------------------------------------------------------
+namespace
+{
+const uint32_t isn{1000}; // initial sequence number
+
+std::vector<std::string> events;
+
+// reader of TCP stream which records pushed data and losses
+struct Recorder
+{
+    template <typename Writer>
+    void set_writer(NST::utils::NetworkSession*, Writer*, uint32_t)
+    {
+    }
+    void set_peer(Recorder&) {}
+    void reset() {}
+
+    void push(PacketInfo& info)
+    {
+        events.push_back("push " + std::to_string(info.data[0]) + ":" + std::to_string(info.dlen));
+    }
+    void lost(const uint32_t n)
+    {
+        events.push_back("lost " + std::to_string(n));
+    }
+};
+
+// Ethernet:IPv4:TCP segment, its payload bytes are offsets from isn
+Frame segment(uint32_t seq, uint32_t len, uint32_t ack)
+{
+    Frame payload(len);
+    for(uint32_t i = 0; i < len; ++i)
+    {
+        payload[i] = seq - isn + i;
+    }
+    return eth_frame(0x0800) + ipv4_packet(6, 0, 0, tcp_segment(0, 0, seq, ack, payload));
+}
+
+struct Segment : Captured
+{
+    Segment(uint32_t seq, uint32_t len, uint32_t ack = 0)
+        : Captured{segment(seq, len, ack)}
+    {
+    }
+};
+
+class Conversation
+{
+public:
+    Conversation()
+        : pool{false}
+        , session{static_cast<int*>(nullptr), 0, pool}
+    {
+        events.clear();
+    }
+
+    void send(const Segment& s, PacketInfo::Direction direction = PacketInfo::Direction::Source)
+    {
+        PacketInfo info(&s.header, s.frame.data(), DLT_EN10MB);
+        ASSERT_NE(nullptr, info.tcp);
+        info.direction = direction;
+        session.collect(info);
+    }
+
+    void ack(uint32_t seq)
+    {
+        send(Segment{0, 0, seq}, PacketInfo::Direction::Destination);
+    }
+
+private:
+    PacketPool           pool;
+    TCPSession<Recorder> session;
+};
+} // unnamed namespace
+
+TEST(TCPReassembly, reorderedSegments)
+{
+    Conversation s;
+    s.send({isn, 10});
+    s.send({isn + 30, 10});
+    s.send({isn + 50, 10});
+    s.send({isn + 20, 10});
+    s.send({isn + 20, 10}); // retransmission of fragment
+    s.send({isn + 10, 10}); // fills the hole
+
+    EXPECT_EQ((std::vector<std::string>{"push 0:10", "push 10:10", "push 20:10", "push 30:10"}), events);
+
+    events.clear();
+    s.ack(isn + 60); // receiver has seen lost segment
+    EXPECT_EQ((std::vector<std::string>{"lost 10", "push 50:10"}), events);
+}
+
+TEST(TCPReassembly, overlappingSegments)
+{
+    Conversation s;
+    s.send({isn, 10});
+    s.send({isn + 15, 10});
+    s.send({isn + 12, 20});
+    s.send({isn + 10, 10}); // overlaps both fragments
+
+    EXPECT_EQ((std::vector<std::string>{"push 0:10", "push 10:10", "push 20:12"}), events);
+}
+//------------------------------------------------------------------------------
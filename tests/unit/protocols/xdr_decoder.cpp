@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Tests for decoding of XDR data in chunks.
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <cstdlib>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+
+#include "protocols/xdr/xdr_decoder.h"
+//------------------------------------------------------------------------------
+using NST::protocols::xdr::XDRDecoder;
+//------------------------------------------------------------------------------
+namespace
+{
+// XDR stream: uint32 counter, opaque<> payload, uint32 counter
+std::vector<uint8_t> encode(uint32_t payload)
+{
+    std::vector<uint8_t> stream;
+    auto                 put = [&stream](uint32_t v) {
+        v = htonl(v);
+        stream.insert(stream.end(), (uint8_t*)&v, (uint8_t*)&v + sizeof(v));
+    };
+    put(0xC0FFEE);
+    put(payload);
+    for(uint32_t i = 0; i < payload; ++i)
+    {
+        stream.push_back(uint8_t(i));
+    }
+    stream.resize((stream.size() + 3) & ~size_t(3)); // padding
+    put(0xDECADE);
+    return stream;
+}
+} // unnamed namespace
+
+TEST(XDRDecoder, decodeChunks)
+{
+    FilteredDataQueue queue{4, 1, 4000};
+
+    for(const uint32_t payload : {10u, 3997u, 3999u, 20000u, 50001u})
+    {
+        const std::vector<uint8_t> stream{encode(payload)};
+
+        FilteredDataQueue::Ptr ptr{queue.allocate()};
+        for(size_t i = 0; i < stream.size(); i += 1448) // segments of TCP
+        {
+            const size_t n{std::min<size_t>(1448, stream.size() - i)};
+            ptr->append(stream.data() + i, uint32_t(n));
+        }
+        ASSERT_EQ(payload > 3900, nullptr != ptr->tail());
+
+        XDRDecoder decoder{std::move(ptr)};
+        XDR*       xdrs{decoder.xdr()};
+
+        uint32_t value{0};
+        ASSERT_TRUE(xdr_u_int(xdrs, &value));
+        EXPECT_EQ(0xC0FFEEu, value);
+
+        char* bytes{nullptr};
+        u_int length{0};
+        ASSERT_TRUE(xdr_bytes(xdrs, &bytes, &length, ~0u));
+        ASSERT_EQ(payload, length);
+        for(uint32_t i = 0; i < payload; ++i)
+        {
+            ASSERT_EQ(uint8_t(i), uint8_t(bytes[i]));
+        }
+        free(bytes);
+
+        ASSERT_TRUE(xdr_u_int(xdrs, &value));
+        EXPECT_EQ(0xDECADEu, value);
+        EXPECT_EQ(stream.size(), xdr_getpos(xdrs));
+        EXPECT_FALSE(xdr_u_int(xdrs, &value)); // end of data
+
+        EXPECT_TRUE(xdr_setpos(xdrs, 0));
+        ASSERT_TRUE(xdr_u_int(xdrs, &value));
+        EXPECT_EQ(0xC0FFEEu, value);
+    }
+}
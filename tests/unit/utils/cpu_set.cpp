@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for CPUSet and CPUPlacement
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <utils/cpu_set.h>
+//------------------------------------------------------------------------------
+using namespace NST::utils;
+//------------------------------------------------------------------------------
+static std::string str(const CPUSet& set)
+{
+    std::ostringstream out;
+    out << set;
+    return out.str();
+}
+
+TEST(CPUSet, parseAndPrint)
+{
+    EXPECT_TRUE(CPUSet{""}.empty());
+    EXPECT_EQ("0", str(CPUSet{"0"}));
+    EXPECT_EQ("0-3,8,10-11", str(CPUSet{"8,0-3,10,11,2"}));
+    EXPECT_EQ(6U, CPUSet{"0-3,10,11"}.list().size());
+
+    EXPECT_THROW(CPUSet{"1-"}, std::invalid_argument);
+    EXPECT_THROW(CPUSet{"3-1"}, std::invalid_argument);
+    EXPECT_THROW(CPUSet{"0;1"}, std::invalid_argument);
+    EXPECT_THROW(CPUSet{"a"}, std::invalid_argument);
+}
+
+#ifdef __linux__
+TEST(CPUPlacement, inheritedAndRestored)
+{
+    const CPUSet all{CPUSet::of_current_thread()};
+    ASSERT_FALSE(all.empty());
+    EXPECT_EQ(str(all), str(CPUSet{}.effective()));
+
+    const CPUSet one{std::to_string(all.list().back())};
+    {
+        CPUPlacement placement{one};
+        EXPECT_EQ(str(one), str(CPUSet::of_current_thread()));
+
+        std::string inherited;
+        std::thread thread{[&inherited]() { inherited = str(CPUSet::of_current_thread()); }};
+        thread.join();
+        EXPECT_EQ(str(one), inherited);
+    }
+    EXPECT_EQ(str(all), str(CPUSet::of_current_thread()));
+}
+#endif
+//------------------------------------------------------------------------------
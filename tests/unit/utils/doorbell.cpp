@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for Doorbell
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <utils/doorbell.h>
+#include <utils/filtered_data.h>
+//------------------------------------------------------------------------------
+using namespace NST::utils;
+using namespace std::chrono;
+//------------------------------------------------------------------------------
+TEST(Doorbell, ringBeforeWait)
+{
+    Doorbell doorbell;
+    EXPECT_FALSE(doorbell.wait(milliseconds{1}));
+
+    doorbell.ring();
+    doorbell.ring();
+    EXPECT_TRUE(doorbell.wait(milliseconds{1000}));
+    EXPECT_FALSE(doorbell.wait(milliseconds{1})); // doorbell is reset
+}
+
+TEST(Doorbell, wakeSleepingConsumer)
+{
+    Doorbell doorbell;
+
+    const auto start = steady_clock::now();
+    std::thread producer{[&doorbell]() {
+        std::this_thread::sleep_for(milliseconds{10});
+        doorbell.ring();
+    }};
+    EXPECT_TRUE(doorbell.wait(seconds{10}));
+    producer.join();
+    EXPECT_GT(seconds{5}, steady_clock::now() - start);
+}
+
+TEST(Doorbell, pushedElementsAreSeen)
+{
+    const uint64_t    count{10000};
+    FilteredDataQueue queue{64, 1};
+    Doorbell          doorbell{microseconds{20}};
+    queue.set_doorbell(&doorbell);
+
+    std::thread producer{[&queue, count]() {
+        for(uint64_t i = 0; i < count; ++i)
+        {
+            FilteredDataQueue::Ptr ptr{queue.allocate()};
+            ptr->ordinal = i;
+            queue.push(ptr);
+        }
+    }};
+
+    // every pushed element is taken after a ring without timeouts
+    uint64_t taken{0};
+    while(taken < count)
+    {
+        ASSERT_TRUE(doorbell.wait(seconds{10}));
+        for(FilteredDataQueue::List list{queue}; list;)
+        {
+            EXPECT_EQ(taken++, list.get_current()->ordinal);
+        }
+    }
+    producer.join();
+}
+//------------------------------------------------------------------------------
@@ -1,3 +1,6 @@
+#include <cstring>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <utils/filtered_data.h>
@@ -6,3 +9,94 @@ TEST(FilteredData, construct)
 {
     EXPECT_NO_THROW(NST::utils::FilteredData());
 }
+
+namespace
+{
+// buffer of packets owned by test
+class Buffer : public NST::utils::PinnedBuffer
+{
+public:
+    ~Buffer() override = default;
+};
+} // unnamed namespace
+
+TEST(FilteredData, referenceAndDetach)
+{
+    const uint8_t packet[]{1, 2, 3, 4, 5, 6, 7, 8};
+    auto          buffer = new Buffer;
+
+    {
+        NST::utils::FilteredData data;
+        data.reference(packet, 4, buffer);
+        EXPECT_EQ(packet, data.data);
+        EXPECT_TRUE(buffer->pinned());
+
+        // the next bytes of the same packet extend reference
+        EXPECT_TRUE(data.precede(packet + 4, buffer));
+        EXPECT_FALSE(data.precede(packet + 5, buffer));
+
+        data.detach();
+        EXPECT_FALSE(buffer->pinned());
+        EXPECT_NE(packet, data.data);
+        EXPECT_EQ(4u, data.dlen);
+        EXPECT_EQ(0, memcmp(packet, data.data, 4));
+
+        data.reset();
+        data.reference(packet, 8, buffer);
+        EXPECT_TRUE(buffer->pinned());
+    } // destruction unpins buffer
+
+    EXPECT_FALSE(buffer->pinned());
+    buffer->release();
+}
+
+TEST(FilteredData, detachToMemory)
+{
+    std::vector<uint8_t> packet(10000, 0x55);
+    auto                 buffer = new Buffer;
+
+    NST::utils::FilteredData data;
+    data.reference(packet.data(), uint32_t(packet.size()), buffer);
+    data.resize(data.dlen + 100); // copies referenced data
+    EXPECT_FALSE(buffer->pinned());
+    EXPECT_LE(10100u, data.capacity());
+    EXPECT_EQ(0, memcmp(packet.data(), data.data, packet.size()));
+    buffer->release();
+}
+
+TEST(FilteredData, appendToChunks)
+{
+    std::vector<uint8_t> bytes(50000);
+    for(size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = uint8_t(i * 7);
+    }
+
+    NST::utils::FilteredDataQueue queue{1, 1, 4000};
+    auto                          ptr = queue.allocate();
+    NST::utils::FilteredData&     data{*ptr};
+    EXPECT_EQ(4000u, data.capacity()); // cache trailing element of queue
+
+    for(size_t i = 0; i < bytes.size(); i += 1000) // packets of message
+    {
+        const uint8_t* begin{data.data};
+        data.append(bytes.data() + i, 1000);
+        EXPECT_EQ(begin, data.data); // the first part isn't reallocated
+    }
+    EXPECT_EQ(50000u, data.dlen);
+    ASSERT_NE(nullptr, data.tail());
+    EXPECT_EQ(data.capacity(), data.head_length());
+
+    uint32_t length{data.head_length()};
+    for(auto c = data.tail(); c; c = c->next)
+    {
+        EXPECT_EQ(0, memcmp(bytes.data() + length, c->bytes(), c->length));
+        length += c->length;
+    }
+    EXPECT_EQ(data.dlen, length);
+
+    data.flatten();
+    EXPECT_EQ(nullptr, data.tail());
+    EXPECT_EQ(50000u, data.head_length());
+    EXPECT_EQ(0, memcmp(bytes.data(), data.data, bytes.size()));
+}
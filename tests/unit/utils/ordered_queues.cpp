@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for OrderedQueues
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/ordered_queues.h>
+//------------------------------------------------------------------------------
+using namespace NST::utils;
+//------------------------------------------------------------------------------
+namespace
+{
+void push(OrderedQueues::Input& input, uint64_t ordinal)
+{
+    FilteredDataQueue::Ptr ptr{input.get_queue().allocate()};
+    ptr->ordinal = ordinal;
+    input.get_queue().push(ptr);
+}
+} // unnamed namespace
+
+TEST(OrderedQueues, mergeInOrderOfPackets)
+{
+    OrderedQueues queues{2, 16};
+
+    std::vector<uint64_t> merged;
+    auto handler = [&merged](FilteredDataQueue::Ptr& data) {
+        merged.push_back(data->ordinal);
+    };
+
+    push(queues.input(0), 1);
+    push(queues.input(0), 4);
+    queues.input(0).set_progress(5);
+    push(queues.input(1), 2);
+    queues.input(1).set_progress(3);
+
+    // second input hasn't passed packet 4 yet
+    queues.merge(handler);
+    EXPECT_EQ((std::vector<uint64_t>{1, 2}), merged);
+
+    push(queues.input(1), 3);
+    queues.input(1).finish();
+    queues.merge(handler);
+    EXPECT_EQ((std::vector<uint64_t>{1, 2, 3, 4}), merged);
+}
+
+TEST(OrderedQueues, flushPendingData)
+{
+    OrderedQueues queues{2, 16};
+
+    std::vector<uint64_t> merged;
+    auto handler = [&merged](FilteredDataQueue::Ptr& data) {
+        merged.push_back(data->ordinal);
+    };
+
+    push(queues.input(1), 7);
+    push(queues.input(1), 8);
+
+    // first input hasn't passed any packet
+    queues.merge(handler);
+    EXPECT_TRUE(merged.empty());
+
+    queues.merge(handler, true);
+    EXPECT_EQ((std::vector<uint64_t>{7, 8}), merged);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for Queue
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/filtered_data.h>
+//------------------------------------------------------------------------------
+using namespace NST::utils;
+//------------------------------------------------------------------------------
+namespace
+{
+void push(FilteredDataQueue& queue, uint64_t ordinal, bool droppable = true)
+{
+    FilteredDataQueue::Ptr ptr{queue.allocate()};
+    ptr->ordinal = ordinal;
+    queue.push(ptr, droppable);
+}
+
+std::vector<uint64_t> take(FilteredDataQueue& queue)
+{
+    std::vector<uint64_t> out;
+    FilteredDataQueue::List list{queue};
+    while(list)
+    {
+        out.push_back(list.get_current()->ordinal);
+    }
+    return out;
+}
+} // unnamed namespace
+
+TEST(Queue, dropNewest)
+{
+    FilteredDataQueue queue{2, 1, 0, QueuePolicy::DropNewest};
+    ASSERT_EQ(2U, queue.capacity());
+
+    push(queue, 1);
+    push(queue, 2);
+    push(queue, 3);
+    EXPECT_EQ((std::vector<uint64_t>{1, 2}), take(queue));
+    EXPECT_EQ(2U, queue.high_water());
+    EXPECT_EQ(1U, queue.dropped());
+}
+
+TEST(Queue, dropOldest)
+{
+    FilteredDataQueue queue{2, 1, 0, QueuePolicy::DropOldest};
+
+    push(queue, 1);
+    push(queue, 2);
+    push(queue, 3);
+    EXPECT_EQ((std::vector<uint64_t>{2, 3}), take(queue));
+    EXPECT_EQ(1U, queue.dropped());
+
+    // element which isn't droppable is passed anyway
+    push(queue, 4, false);
+    push(queue, 5);
+    push(queue, 6);
+    EXPECT_EQ((std::vector<uint64_t>{5, 4}), take(queue));
+    EXPECT_EQ(2U, queue.dropped());
+}
+
+TEST(Queue, blockUntilTaken)
+{
+    const uint64_t    count{1000};
+    FilteredDataQueue queue{4, 1};
+
+    std::thread producer{[&queue, count]() {
+        for(uint64_t i = 0; i < count; ++i)
+        {
+            push(queue, i);
+        }
+    }};
+
+    std::vector<uint64_t> taken;
+    while(taken.size() < count)
+    {
+        for(uint64_t i : take(queue))
+        {
+            EXPECT_EQ(taken.size(), i);
+            taken.push_back(i);
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(0U, queue.dropped());
+    EXPECT_GE(queue.capacity(), queue.high_water());
+
+    // closed queue doesn't block anymore
+    push(queue, 1);
+    push(queue, 2);
+    push(queue, 3);
+    push(queue, 4);
+    queue.close();
+    push(queue, 5);
+    EXPECT_EQ(1U, queue.dropped());
+}
+//------------------------------------------------------------------------------
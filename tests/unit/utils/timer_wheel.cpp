@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+// Author: Nfstrace developers
+// Description: Unit tests for timer wheel
+// Copyright (c) 2026 EPAM Systems
+//------------------------------------------------------------------------------
+/*
+    This file is part of Nfstrace.
+
+    Nfstrace is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 2 of the License.
+
+    Nfstrace is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Nfstrace.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//------------------------------------------------------------------------------
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <utils/timer_wheel.h>
+//------------------------------------------------------------------------------
+using namespace NST::utils;
+//------------------------------------------------------------------------------
+namespace
+{
+using Expired = std::vector<std::pair<int, uint64_t>>;
+
+Expired advance(TimerWheel<int>& wheel, uint64_t tick)
+{
+    Expired expired;
+    wheel.advance(tick, [&expired](int key, uint64_t scheduled) {
+        expired.emplace_back(key, scheduled);
+    });
+    return expired;
+}
+} // unnamed namespace
+
+TEST(TimerWheel, expireInOrderOfTicks)
+{
+    TimerWheel<int> wheel{8};
+
+    wheel.schedule(1, 3);
+    wheel.schedule(2, 5);
+    wheel.schedule(3, 3);
+
+    EXPECT_TRUE(advance(wheel, 2).empty());
+    EXPECT_EQ((Expired{{1, 3}, {3, 3}}), advance(wheel, 4));
+    EXPECT_EQ(4u, wheel.now());
+    EXPECT_TRUE(advance(wheel, 4).empty()); // time doesn't go back
+    EXPECT_EQ((Expired{{2, 5}}), advance(wheel, 5));
+}
+
+TEST(TimerWheel, keepTimersOfNextRevolutions)
+{
+    TimerWheel<int> wheel{4};
+
+    wheel.schedule(1, 6);  // slot 2 in the second revolution
+    wheel.schedule(2, 10); // slot 2 in the third revolution
+
+    EXPECT_TRUE(advance(wheel, 3).empty());
+    EXPECT_EQ((Expired{{1, 6}}), advance(wheel, 7));
+    EXPECT_TRUE(advance(wheel, 9).empty());
+    EXPECT_EQ((Expired{{2, 10}}), advance(wheel, 10));
+}
+
+TEST(TimerWheel, jumpOverManyRevolutions)
+{
+    TimerWheel<int> wheel{4};
+
+    wheel.schedule(1, 2);
+    wheel.schedule(2, 1000);
+
+    // each slot is visited once, late timers stay scheduled
+    EXPECT_EQ((Expired{{1, 2}}), advance(wheel, 100));
+    EXPECT_EQ((Expired{{2, 1000}}), advance(wheel, 1000));
+}